@@ -1,19 +1,21 @@
 /**
  * @file bigint.hpp
  * @brief 无限精度整数（BigInt）核心定义
- *  * 采用逆序存储 digits（如 123 存储为 [3,2,1]），最小化进位/借位时的元素移动开销；
- * 支持 size_t 与合法数字字符串初始化，内置高效比较与 IO 操作。
+ *  * 值在 int64_t 范围内时以内联整数存储（不分配堆内存），溢出时自动提升为大整数形式；
+ *  * 大整数形式以 2^32 进制 limb 逆序存储绝对值（低位在前）；
+ *  * 乘法按长度分级：普通乘法 / Karatsuba / Toom-3；除法使用 Knuth Algorithm D；
+ *  * to_string 按 10^(9*2^i) 分治转换。
+ * 支持 size_t/有符号整数与合法数字字符串初始化，内置高效比较与 IO 操作。
  * @author azhz1107cat
  * @date 2025-10-25
- * @note 修复核心问题：
- *  1. div_mod_unsigned 中用二分查找替换逐次累加，避免无限循环
- *  2. Karatsuba 乘法添加基准阈值，减少递归深度
- *  3. shift_left 优化内存操作，避免 vector 开头插入的低效行为
  */
 
 #pragma once
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
+#include <concepts>
 #include <cstdint>
 #include <ostream>
 #include <string>
@@ -26,216 +28,491 @@
 namespace dep {
 
 class BigInt {
-    std::vector<uint8_t> digits_; // 逆序存储（低位在前），每个元素 0-9
-    bool is_negative_;            // false=正，true=负；0恒为非负
+    using Limb = uint32_t;
+    using DoubleLimb = uint64_t;
+    using Limbs = std::vector<Limb>; // 绝对值，2^32 进制逆序存储（低位在前），无前导零，0 为空
+
+    static constexpr int LIMB_BITS = 32;
+
+    // 乘法分级阈值（单位：limb，按基准测试选取）
+    static constexpr size_t KARATSUBA_THRESHOLD = 40;
+    static constexpr size_t TOOM3_THRESHOLD = 100;
+    // to_string 分治阈值（单位：limb）
+    static constexpr size_t TO_STRING_THRESHOLD = 60;
+
+    // 规范化约定：能放入 int64_t 的值总是使用内联形式（即小整数的 SBO，不分配堆内存），
+    // 因此内联形式与大整数形式的值永远不相等
+    bool is_small_ = true;
+    int64_t small_ = 0;           // 内联形式的值
+    Limbs limbs_;                 // 大整数形式的绝对值（内联形式时为空）
+    bool is_negative_ = false;    // 大整数形式的符号
+
+    // ========================= 绝对值（Limbs）运算 =========================
 
     /**
-     * @brief 移除前导零（逆序中为末尾零），确保数字表示唯一
+     * @brief 移除前导零，确保数字表示唯一
      */
-    void trim_leading_zeros() {
-        while (digits_.size() > 1 && digits_.back() == 0) {
-            digits_.pop_back();
-        }
-        if (digits_.size() == 1 && digits_[0] == 0) {
-            is_negative_ = false;
+    static void trim(Limbs& a) {
+        while (!a.empty() && a.back() == 0) {
+            a.pop_back();
         }
     }
 
     /**
-     * @brief 绝对值比较（辅助减法/乘法）：返回 *this 的绝对值是否小于 other 的绝对值
+     * @brief 绝对值比较：返回 -1/0/1
      */
-    [[nodiscard]] bool abs_less(const BigInt& other) const {
-        if (digits_.size() != other.digits_.size()) {
-            return digits_.size() < other.digits_.size();
-        }
-        // 从最高位（digits_末尾）逐位比
-        for (auto it1 = digits_.rbegin(), it2 = other.digits_.rbegin(); it1 != digits_.rend(); ++it1, ++it2) {
-            if (*it1 != *it2) {
-                return *it1 < *it2;
+    static int abs_compare(const Limbs& a, const Limbs& b) {
+        if (a.size() != b.size()) {
+            return a.size() < b.size() ? -1 : 1;
+        }
+        for (size_t i = a.size(); i-- > 0;) {
+            if (a[i] != b[i]) {
+                return a[i] < b[i] ? -1 : 1;
             }
         }
-        return false; // 绝对值相等
+        return 0;
     }
 
     /**
-     * @brief 核心辅助：计算 (dividend / divisor) 的商和余数（无符号，仅处理正整数）
-     * @param dividend 被除数（非负）
-     * @param divisor 除数（正，非零）
-     * @return  pair<商, 余数>（均非负）
-     * @note 修复：用二分查找替换逐次累加，避免无限循环
+     * @brief acc += b * 2^(32*shift)，原地累加
      */
-    static std::pair<BigInt, BigInt> div_mod_unsigned(const BigInt& dividend, const BigInt& divisor) {
-        BigInt quotient, remainder;
-        quotient.digits_.clear();
-        remainder.digits_.clear();
-        remainder.is_negative_ = false;
-        quotient.is_negative_ = false;
-
-        // 从被除数最高位（digits_末尾）开始逐位构建余数
-        for (auto it = dividend.digits_.rbegin(); it != dividend.digits_.rend(); ++it) {
-            // 余数 = 余数 * 10 + 当前位（模拟手工除法）
-            remainder = remainder * BigInt(10) + BigInt(static_cast<size_t>(*it));
-
-            // 修复核心：二分查找最大的q_digit（0-9），避免逐次累加的无限循环
-            uint8_t q_digit = 0;
-            uint8_t left = 0, right = 9; // 单个数字位，范围固定0-9
-            while (left <= right) {
-                uint8_t mid = (left + right) / 2;
-                BigInt temp = divisor * BigInt(static_cast<size_t>(mid));
-                if (temp <= remainder) {
-                    q_digit = mid;
-                    left = mid + 1;
-                } else {
-                    right = mid - 1;
-                }
-            }
-
-            // 商的当前位存入（注意商是正序构建，后续需逆序）
-            quotient.digits_.push_back(q_digit);
-            // 更新余数：remainder = remainder - (q_digit * divisor)
-            if (q_digit > 0) {
-                remainder -= (divisor * BigInt(static_cast<size_t>(q_digit)));
-            }
+    static void add_shifted(Limbs& acc, const Limbs& b, size_t shift) {
+        if (b.empty()) return;
+        if (acc.size() < b.size() + shift) {
+            acc.resize(b.size() + shift, 0);
         }
+        DoubleLimb carry = 0;
+        size_t i = 0;
+        for (; i < b.size(); ++i) {
+            carry += static_cast<DoubleLimb>(acc[i + shift]) + b[i];
+            acc[i + shift] = static_cast<Limb>(carry);
+            carry >>= LIMB_BITS;
+        }
+        for (i += shift; carry > 0; ++i) {
+            if (i == acc.size()) acc.push_back(0);
+            carry += acc[i];
+            acc[i] = static_cast<Limb>(carry);
+            carry >>= LIMB_BITS;
+        }
+    }
+
+    static Limbs unsigned_add(const Limbs& a, const Limbs& b) {
+        Limbs res = a.size() >= b.size() ? a : b;
+        add_shifted(res, a.size() >= b.size() ? b : a, 0);
+        return res;
+    }
 
-        // 商是正序存储（高位在前），需逆转为统一的低位在前格式
-        std::reverse(quotient.digits_.begin(), quotient.digits_.end());
-        quotient.trim_leading_zeros();
-        remainder.trim_leading_zeros();
+    /**
+     * @brief a -= b，要求 |a| >= |b|
+     */
+    static void subtract_in_place(Limbs& a, const Limbs& b) {
+        assert(abs_compare(a, b) >= 0 && "unsigned_subtract requires |a| >= |b|");
+        int64_t borrow = 0;
+        size_t i = 0;
+        for (; i < b.size(); ++i) {
+            int64_t diff = static_cast<int64_t>(a[i]) - b[i] - borrow;
+            borrow = diff < 0;
+            a[i] = static_cast<Limb>(diff);
+        }
+        for (; borrow && i < a.size(); ++i) {
+            borrow = a[i] == 0;
+            --a[i];
+        }
+        trim(a);
+    }
 
-        return {quotient, remainder};
+    static Limbs unsigned_subtract(const Limbs& a, const Limbs& b) {
+        Limbs res = a;
+        subtract_in_place(res, b);
+        return res;
     }
 
     /**
-     * @brief Karatsuba乘法核心（无符号，仅处理正整数）
-     * 时间复杂度 O(n^log3) ≈ O(n^1.58)，远快于普通O(n²)逐位乘
-     * @note 修复：添加基准阈值，减少递归深度
+     * @brief 普通 O(n*m) 逐 limb 乘法
      */
-    static BigInt karatsuba_mul(const BigInt& a, const BigInt& b) {
-        // 修复核心：基准条件优化，长度≤8时用普通乘法，减少递归深度
-        const size_t BASE_THRESHOLD = 8;
-        if (a.digits_.size() <= BASE_THRESHOLD || b.digits_.size() <= BASE_THRESHOLD) {
-            BigInt res;
-            res.digits_.resize(a.digits_.size() + b.digits_.size(), 0);
-            // 逐位相乘，累加至对应位置
-            for (size_t i = 0; i < a.digits_.size(); ++i) {
-                uint32_t carry = 0; // 用32位存进位，避免溢出
-                for (size_t j = 0; j < b.digits_.size(); ++j) {
-                    uint32_t sum = res.digits_[i + j] + a.digits_[i] * b.digits_[j] + carry;
-                    res.digits_[i + j] = static_cast<uint8_t>(sum % 10);
-                    carry = sum / 10;
-                }
-                // 处理剩余进位（可能超过1位）
-                size_t carry_pos = i + b.digits_.size();
-                while (carry > 0) {
-                    if (carry_pos >= res.digits_.size()) {
-                        res.digits_.push_back(0);
-                    }
-                    uint32_t sum = res.digits_[carry_pos] + carry;
-                    res.digits_[carry_pos] = static_cast<uint8_t>(sum % 10);
-                    carry = sum / 10;
-                    carry_pos++;
-                }
+    static Limbs schoolbook_mul(const Limb* a, size_t na, const Limb* b, size_t nb) {
+        Limbs res(na + nb, 0);
+        for (size_t i = 0; i < na; ++i) {
+            if (a[i] == 0) continue;
+            DoubleLimb carry = 0;
+            for (size_t j = 0; j < nb; ++j) {
+                carry += static_cast<DoubleLimb>(a[i]) * b[j] + res[i + j];
+                res[i + j] = static_cast<Limb>(carry);
+                carry >>= LIMB_BITS;
             }
-            res.trim_leading_zeros();
-            return res;
+            res[i + nb] = static_cast<Limb>(carry);
         }
+        trim(res);
+        return res;
+    }
 
-        // m 取较小长度的一半（向上取整）
-        size_t min_len = std::min(a.digits_.size(), b.digits_.size());
-        size_t m = (min_len + 1) / 2; // 向上取整，比如 min_len=5 → m=3，min_len=4→m=2
+    static Limbs slice(const Limbs& a, size_t from, size_t len) {
+        if (from >= a.size()) return {};
+        Limbs r(a.begin() + static_cast<std::ptrdiff_t>(from),
+                a.begin() + static_cast<std::ptrdiff_t>(std::min(a.size(), from + len)));
+        trim(r);
+        return r;
+    }
 
-        BigInt a_low, a_high, b_low, b_high;
+    /**
+     * @brief Karatsuba乘法（两数长度相近时使用）
+     * 时间复杂度 O(n^log3) ≈ O(n^1.58)
+     */
+    static Limbs karatsuba_mul(const Limbs& a, const Limbs& b) {
+        const size_t m = std::max(a.size(), b.size()) / 2;
+        const Limbs a_low = slice(a, 0, m), a_high = slice(a, m, a.size());
+        const Limbs b_low = slice(b, 0, m), b_high = slice(b, m, b.size());
+
+        // z2*B^(2m) + (z1 - z0 - z2)*B^m + z0
+        Limbs z0 = unsigned_mul(a_low, b_low);
+        Limbs z2 = unsigned_mul(a_high, b_high);
+        Limbs z1 = unsigned_mul(unsigned_add(a_low, a_high), unsigned_add(b_low, b_high));
+        subtract_in_place(z1, z0);
+        subtract_in_place(z1, z2);
+
+        Limbs res = std::move(z0);
+        res.reserve(a.size() + b.size());
+        add_shifted(res, z1, m);
+        add_shifted(res, z2, 2 * m);
+        trim(res);
+        return res;
+    }
 
-        // 拆分 a：a_low = a % 10^m，a_high = a / 10^m（逆序存储，前m位是低位）
-        a_low.digits_ = std::vector<uint8_t>(a.digits_.begin(), a.digits_.begin() + std::min(m, a.digits_.size()));
-        if (a.digits_.size() > m) {
-            a_high.digits_ = std::vector<uint8_t>(a.digits_.begin() + m, a.digits_.end());
-        } else {
-            a_high.digits_ = {0}; // 不足高位补0
+    // Toom-3 插值需要的带符号绝对值
+    struct Signed {
+        bool neg = false;
+        Limbs mag;
+    };
+
+    static Signed signed_add(const Signed& a, const Signed& b) {
+        if (a.neg == b.neg) return {a.neg, unsigned_add(a.mag, b.mag)};
+        if (abs_compare(a.mag, b.mag) >= 0) {
+            Signed r{a.neg, unsigned_subtract(a.mag, b.mag)};
+            if (r.mag.empty()) r.neg = false;
+            return r;
         }
+        return {b.neg, unsigned_subtract(b.mag, a.mag)};
+    }
 
-        // 拆分 b（同 a）
-        b_low.digits_ = std::vector<uint8_t>(b.digits_.begin(), b.digits_.begin() + std::min(m, b.digits_.size()));
-        if (b.digits_.size() > m) {
-            b_high.digits_ = std::vector<uint8_t>(b.digits_.begin() + m, b.digits_.end());
-        } else {
-            b_high.digits_ = {0};
+    static Signed signed_sub(const Signed& a, const Signed& b) {
+        return signed_add(a, {!b.neg && !b.mag.empty(), b.mag});
+    }
+
+    static Signed signed_mul(const Signed& a, const Signed& b) {
+        Signed r{a.neg != b.neg, unsigned_mul(a.mag, b.mag)};
+        if (r.mag.empty()) r.neg = false;
+        return r;
+    }
+
+    static Limbs shift_bits_left(const Limbs& a, int bits) {
+        if (a.empty() || bits == 0) return a;
+        Limbs r(a.size() + 1, 0);
+        for (size_t i = 0; i < a.size(); ++i) {
+            r[i] |= a[i] << bits;
+            r[i + 1] = a[i] >> (LIMB_BITS - bits);
         }
+        trim(r);
+        return r;
+    }
 
-        // Karatsuba公式：z0*10^(2m) + (z1 - z0 - z2)*10^m + z2
-        BigInt z0 = karatsuba_mul(a_low, b_low);
-        BigInt z1 = karatsuba_mul(a_low + a_high, b_low + b_high);
-        BigInt z2 = karatsuba_mul(a_high, b_high);
+    static Limbs shift_bits_right(const Limbs& a, int bits) {
+        if (a.empty() || bits == 0) return a;
+        Limbs r(a.size(), 0);
+        for (size_t i = 0; i < a.size(); ++i) {
+            r[i] = a[i] >> bits;
+            if (i + 1 < a.size()) r[i] |= a[i + 1] << (LIMB_BITS - bits);
+        }
+        trim(r);
+        return r;
+    }
 
-        // 按标准顺序计算（加法交换律下结果一致，但更易读）
-        BigInt res = z2.shift_left(2 * m) + (z1 - z0 - z2).shift_left(m) + z0;
-        res.trim_leading_zeros();
+    /**
+     * @brief Toom-Cook 3路乘法（Bodrato插值序列，取点 0, 1, -1, -2, ∞）
+     * 时间复杂度 O(n^log_3(5)) ≈ O(n^1.46)
+     */
+    static Limbs toom3_mul(const Limbs& a, const Limbs& b) {
+        const size_t k = (std::max(a.size(), b.size()) + 2) / 3;
+        const Signed a0{false, slice(a, 0, k)}, a1{false, slice(a, k, k)}, a2{false, slice(a, 2 * k, k)};
+        const Signed b0{false, slice(b, 0, k)}, b1{false, slice(b, k, k)}, b2{false, slice(b, 2 * k, k)};
+
+        // 求值
+        auto evaluate = [](const Signed& x0, const Signed& x1, const Signed& x2) {
+            const Signed p = signed_add(x0, x2);
+            const Signed at1 = signed_add(p, x1);
+            const Signed at_m1 = signed_sub(p, x1);
+            // x(-2) = (x(-1) + x2) * 2 - x0
+            Signed at_m2 = signed_add(at_m1, x2);
+            at_m2.mag = shift_bits_left(at_m2.mag, 1);
+            at_m2 = signed_sub(at_m2, x0);
+            return std::array<Signed, 3>{at1, at_m1, at_m2};
+        };
+        const auto [pa1, pam1, pam2] = evaluate(a0, a1, a2);
+        const auto [pb1, pbm1, pbm2] = evaluate(b0, b1, b2);
+
+        // 逐点相乘
+        const Signed r0 = signed_mul(a0, b0);
+        const Signed r_1 = signed_mul(pa1, pb1);
+        const Signed r_m1 = signed_mul(pam1, pbm1);
+        const Signed r_m2 = signed_mul(pam2, pbm2);
+        const Signed r_inf = signed_mul(a2, b2);
+
+        // 插值（所有除法均为整除）
+        auto exact_div_small = [](Signed x, Limb d) {
+            [[maybe_unused]] const Limb rem = divmod_small(x.mag, d);
+            assert(rem == 0);
+            return x;
+        };
+        Signed c3 = exact_div_small(signed_sub(r_m2, r_1), 3);
+        Signed c1 = signed_sub(r_1, r_m1);
+        c1.mag = shift_bits_right(c1.mag, 1);
+        Signed c2 = signed_sub(r_m1, r0);
+        c3 = signed_sub(c2, c3);
+        c3.mag = shift_bits_right(c3.mag, 1);
+        c3 = signed_add(c3, {r_inf.neg, shift_bits_left(r_inf.mag, 1)});
+        c2 = signed_sub(signed_add(c2, c1), r_inf);
+        c1 = signed_sub(c1, c3);
+
+        // 重组：r0 + c1*B^k + c2*B^2k + c3*B^3k + r_inf*B^4k（各系数均非负）
+        assert(!c1.neg && !c2.neg && !c3.neg);
+        Limbs res = r0.mag;
+        res.reserve(a.size() + b.size() + 1);
+        add_shifted(res, c1.mag, k);
+        add_shifted(res, c2.mag, 2 * k);
+        add_shifted(res, c3.mag, 3 * k);
+        add_shifted(res, r_inf.mag, 4 * k);
+        trim(res);
         return res;
     }
 
     /**
-     * @brief 左移（乘以 10^k，逆序存储中为开头补k个0）
-     * @note 修复：优化内存操作，避免 vector 开头 insert 的低效行为
+     * @brief 无符号乘法：按长度在 普通/Karatsuba/Toom-3 之间分级选择
      */
-    [[nodiscard]] BigInt shift_left(size_t k) const {
-        if (k == 0 || (digits_.size() == 1 && digits_[0] == 0)) {
-            return *this;
+    static Limbs unsigned_mul(const Limbs& a, const Limbs& b) {
+        if (a.empty() || b.empty()) return {};
+        const Limbs& big = a.size() >= b.size() ? a : b;
+        const Limbs& small = a.size() >= b.size() ? b : a;
+
+        if (small.size() < KARATSUBA_THRESHOLD) {
+            return schoolbook_mul(big.data(), big.size(), small.data(), small.size());
         }
-        BigInt res = *this;
-        // 修复核心：先resize预分配，再后移元素，最后填充0，避免开头insert
-        size_t old_size = res.digits_.size();
-        res.digits_.resize(old_size + k, 0); // 扩展内存
-        // 原有元素后移k位
-        for (size_t i = old_size + k - 1; i >= k; --i) {
-            res.digits_[i] = res.digits_[i - k];
-        }
-        // 前k位置0
-        std::fill(res.digits_.begin(), res.digits_.begin() + k, 0);
-        res.trim_leading_zeros(); // 补0后清理前导零
-        return res;
+        // 长度悬殊时按短数长度分块相乘，保证分治算法处理的都是长度相近的两数
+        if (small.size() * 2 <= big.size()) {
+            Limbs res;
+            res.reserve(big.size() + small.size());
+            for (size_t from = 0; from < big.size(); from += small.size()) {
+                add_shifted(res, unsigned_mul(slice(big, from, small.size()), small), from);
+            }
+            trim(res);
+            return res;
+        }
+        if (small.size() < TOOM3_THRESHOLD) {
+            return karatsuba_mul(big, small);
+        }
+        return toom3_mul(big, small);
     }
 
     /**
-     * @brief 无符号减法：计算 |a| - |b|，要求 |a| >= |b|
+     * @brief 原地除以单个 limb，a 变为商，返回余数
      */
-    static BigInt unsigned_subtract(const BigInt& a, const BigInt& b) {
-        assert(!a.abs_less(b) && "unsigned_subtract requires |a| >= |b|");
+    static Limb divmod_small(Limbs& a, Limb d) {
+        DoubleLimb rem = 0;
+        for (size_t i = a.size(); i-- > 0;) {
+            const DoubleLimb cur = (rem << LIMB_BITS) | a[i];
+            a[i] = static_cast<Limb>(cur / d);
+            rem = cur % d;
+        }
+        trim(a);
+        return static_cast<Limb>(rem);
+    }
 
-        BigInt result;
-        result.digits_.clear();
-        result.is_negative_ = false;
+    /**
+     * @brief 计算 (dividend / divisor) 的商和余数（无符号，Knuth Algorithm D）
+     * @param dividend 被除数
+     * @param divisor 除数（非零）
+     * @return  pair<商, 余数>
+     */
+    static std::pair<Limbs, Limbs> div_mod_unsigned(const Limbs& dividend, const Limbs& divisor) {
+        assert(!divisor.empty());
+        if (abs_compare(dividend, divisor) < 0) {
+            return {{}, dividend};
+        }
+        if (divisor.size() == 1) {
+            Limbs quotient = dividend;
+            const Limb rem = divmod_small(quotient, divisor[0]);
+            return {quotient, rem ? Limbs{rem} : Limbs{}};
+        }
 
-        uint32_t borrow = 0;
-        for (size_t i = 0; i < a.digits_.size(); ++i) {
-            uint32_t a_digit = a.digits_[i];
-            uint32_t b_digit = (i < b.digits_.size()) ? b.digits_[i] : 0;
+        const size_t n = divisor.size();
+        const size_t m = dividend.size();
+        constexpr DoubleLimb BASE = DoubleLimb(1) << LIMB_BITS;
+
+        // 规格化：左移使除数最高位为1，估商误差不超过2
+        const int s = std::countl_zero(divisor.back());
+        Limbs vn = shift_bits_left(divisor, s);
+        Limbs un = shift_bits_left(dividend, s);
+        un.resize(m + 1, 0);
+        vn.resize(n, 0);
+
+        Limbs quotient(m - n + 1, 0);
+        for (size_t j = m - n + 1; j-- > 0;) {
+            // 用被除数最高两位估商
+            const DoubleLimb num = (static_cast<DoubleLimb>(un[j + n]) << LIMB_BITS) | un[j + n - 1];
+            DoubleLimb qhat = num / vn[n - 1];
+            DoubleLimb rhat = num % vn[n - 1];
+            while (qhat >= BASE || qhat * vn[n - 2] > ((rhat << LIMB_BITS) | un[j + n - 2])) {
+                --qhat;
+                rhat += vn[n - 1];
+                if (rhat >= BASE) break;
+            }
 
-            int32_t diff = static_cast<int32_t>(a_digit) - static_cast<int32_t>(b_digit) - borrow;
+            // un[j..j+n] -= qhat * vn
+            int64_t borrow = 0;
+            for (size_t i = 0; i < n; ++i) {
+                const DoubleLimb p = qhat * vn[i];
+                const int64_t t = static_cast<int64_t>(un[i + j]) - borrow - static_cast<int64_t>(p & 0xFFFFFFFFu);
+                un[i + j] = static_cast<Limb>(t);
+                borrow = static_cast<int64_t>(p >> LIMB_BITS) - (t >> LIMB_BITS);
+            }
+            const int64_t t = static_cast<int64_t>(un[j + n]) - borrow;
+            un[j + n] = static_cast<Limb>(t);
+
+            // 估商偏大一，加回
+            if (t < 0) {
+                --qhat;
+                DoubleLimb carry = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    carry += static_cast<DoubleLimb>(un[i + j]) + vn[i];
+                    un[i + j] = static_cast<Limb>(carry);
+                    carry >>= LIMB_BITS;
+                }
+                un[j + n] += static_cast<Limb>(carry);
+            }
+            quotient[j] = static_cast<Limb>(qhat);
+        }
+
+        trim(quotient);
+        un.resize(n);
+        trim(un);
+        return {quotient, shift_bits_right(un, s)};
+    }
+
+    static Limbs limbs_from_u64(uint64_t val) {
+        Limbs r;
+        while (val > 0) {
+            r.push_back(static_cast<Limb>(val));
+            val >>= LIMB_BITS;
+        }
+        return r;
+    }
 
-            if (diff < 0) {
-                diff += 10;
-                borrow = 1;
-            } else {
-                borrow = 0;
+    /**
+     * @brief 绝对值能否放入 uint64_t，可以则写入 out
+     */
+    static bool limbs_to_u64(const Limbs& a, uint64_t& out) {
+        if (a.size() > 2) return false;
+        out = 0;
+        for (size_t i = a.size(); i-- > 0;) {
+            out = (out << LIMB_BITS) | a[i];
+        }
+        return true;
+    }
+
+    static uint64_t small_abs(int64_t v) {
+        return v < 0 ? 0 - static_cast<uint64_t>(v) : static_cast<uint64_t>(v);
+    }
+
+    /**
+     * @brief 由符号与绝对值构造，并规范化（能放入 int64_t 则转为内联形式）
+     */
+    static BigInt from_parts(bool negative, Limbs mag) {
+        BigInt res;
+        uint64_t u;
+        if (limbs_to_u64(mag, u)) {
+            if (!negative && u <= static_cast<uint64_t>(INT64_MAX)) {
+                res.small_ = static_cast<int64_t>(u);
+                return res;
             }
+            if (negative && u <= static_cast<uint64_t>(INT64_MAX) + 1) {
+                res.small_ = static_cast<int64_t>(0 - u);
+                return res;
+            }
+        }
+        res.is_small_ = false;
+        res.is_negative_ = negative;
+        res.limbs_ = std::move(mag);
+        return res;
+    }
+
+    [[nodiscard]] Limbs magnitude() const {
+        return is_small_ ? limbs_from_u64(small_abs(small_)) : limbs_;
+    }
+
+    [[nodiscard]] bool negative() const {
+        return is_small_ ? small_ < 0 : is_negative_;
+    }
+
+    static BigInt signed_add(bool a_neg, const Limbs& a, bool b_neg, const Limbs& b) {
+        // 同号 → 绝对值相加，符号不变
+        if (a_neg == b_neg) {
+            return from_parts(a_neg, unsigned_add(a, b));
+        }
+        // 异号 → 绝对值相减，符号取绝对值大的
+        if (abs_compare(a, b) < 0) {
+            return from_parts(b_neg, unsigned_subtract(b, a));
+        }
+        return from_parts(a_neg, unsigned_subtract(a, b));
+    }
 
-            result.digits_.push_back(static_cast<uint8_t>(diff));
+    // ========================= 十进制转换 =========================
+    static constexpr Limb DEC_CHUNK = 1000000000; // 10^9，单个 limb 可容纳的最大10的幂
+    static constexpr int DEC_CHUNK_DIGITS = 9;
+
+    /**
+     * @brief 10^(9*2^i) 的缓存，供分治 to_string 使用
+     */
+    static const Limbs& dec_power(size_t i) {
+        static std::vector<Limbs> powers{Limbs{DEC_CHUNK}};
+        while (powers.size() <= i) {
+            powers.push_back(unsigned_mul(powers.back(), powers.back()));
         }
+        return powers[i];
+    }
 
-        // 移除前导零
-        while (result.digits_.size() > 1 && result.digits_.back() == 0) {
-            result.digits_.pop_back();
+    /**
+     * @brief 将绝对值转为十进制追加到 out；pad 非零时左侧补零到 pad 位
+     * 长数按 10^(9*2^i) 分治拆成高低两半，短数逐次除以 10^9
+     */
+    static void append_decimal(const Limbs& a, std::string& out, size_t pad) {
+        if (a.size() < TO_STRING_THRESHOLD) {
+            std::string chunks;
+            Limbs q = a;
+            while (!q.empty()) {
+                Limb r = divmod_small(q, DEC_CHUNK);
+                for (int d = 0; d < DEC_CHUNK_DIGITS; ++d) {
+                    chunks.push_back(static_cast<char>('0' + r % 10));
+                    r /= 10;
+                }
+            }
+            while (!chunks.empty() && chunks.back() == '0') chunks.pop_back();
+            if (pad > chunks.size()) out.append(pad - chunks.size(), '0');
+            out.append(chunks.rbegin(), chunks.rend());
+            return;
         }
 
-        return result;
+        // 选取不超过 a 一半长度的最大 10^(9*2^i)
+        size_t i = 0;
+        while (dec_power(i + 1).size() * 2 <= a.size() + 1) ++i;
+        const size_t low_digits = static_cast<size_t>(DEC_CHUNK_DIGITS) << i;
+        auto [high, low] = div_mod_unsigned(a, dec_power(i));
+        append_decimal(high, out, pad > low_digits ? pad - low_digits : 0);
+        append_decimal(low, out, low_digits);
     }
 
+public:
     /**
-    * @brief 辅助函数：无符号快速幂（底数和指数均为非负整数）
+    * @brief 无符号快速幂（底数和指数均为非负整数）
     * 二分幂核心逻辑：a^b = (a^(b/2))^2 （b为偶数） / (a^(b/2))^2 * a （b为奇数）
     */
-public:
     static BigInt fast_pow_unsigned(const BigInt& base, const BigInt& exp) {
         BigInt result(1); // 初始结果为 1（乘法单位元）
         BigInt current_base = base;
@@ -245,37 +522,73 @@ public:
         while (current_exp > BigInt(0)) {
             // 若当前指数为奇数，结果 *= 当前底数
             if (current_exp % two == BigInt(1)) {
-                result = result * current_base; // 复用 Karatsuba 乘法，高效
+                result = result * current_base;
             }
-            // 底数平方，指数减半（整除）
-            current_base = current_base * current_base;
             current_exp = current_exp / two; // 整数除法，向下取整
+            if (current_exp > BigInt(0)) {
+                // 底数平方，指数减半
+                current_base = current_base * current_base;
+            }
         }
 
         return result;
     }
 
     // ========================= 构造与析构 =========================
-    BigInt() : is_negative_(false), digits_(1, 0) {}
-    BigInt(size_t val) : is_negative_(false) {
-        if (val == 0) { digits_.push_back(0); return; }
-        while (val > 0) { digits_.push_back(static_cast<uint8_t>(val % 10)); val /= 10; }
+    BigInt() = default;
+    BigInt(size_t val) {
+        if (val <= static_cast<size_t>(INT64_MAX)) {
+            small_ = static_cast<int64_t>(val);
+        } else {
+            is_small_ = false;
+            limbs_ = limbs_from_u64(val);
+        }
     }
-    BigInt(const std::string& s) : is_negative_(false) {
-        if (s.empty()) { digits_.push_back(0); return; }
+    template <std::signed_integral T>
+    BigInt(T val) : small_(static_cast<int64_t>(val)) {}
+    BigInt(const std::string& s) {
+        if (s.empty()) return;
         size_t start_idx = 0;
-        if (s[0] == '-') { is_negative_ = true; start_idx = 1; }
-        for (auto it = s.rbegin(); it != s.rend() - start_idx; ++it) {
-            if (*it < '0' || *it > '9') { digits_ = {0}; is_negative_ = false; return; }
-            digits_.push_back(static_cast<uint8_t>(*it - '0'));
+        bool negative = false;
+        if (s[0] == '-') { negative = true; start_idx = 1; }
+        for (size_t i = start_idx; i < s.size(); ++i) {
+            if (s[i] < '0' || s[i] > '9') return; // 非法字符串视为0
+        }
+        // 每次读入9位十进制：mag = mag * 10^9 + chunk
+        Limbs mag;
+        size_t i = start_idx;
+        size_t first_len = (s.size() - start_idx) % DEC_CHUNK_DIGITS;
+        if (first_len == 0) first_len = DEC_CHUNK_DIGITS;
+        while (i < s.size()) {
+            Limb chunk = 0;
+            Limb scale = 1;
+            for (const size_t end = i + first_len; i < end; ++i) {
+                chunk = chunk * 10 + static_cast<Limb>(s[i] - '0');
+                scale *= 10;
+            }
+            first_len = DEC_CHUNK_DIGITS;
+            DoubleLimb carry = chunk;
+            for (auto& limb : mag) {
+                carry += static_cast<DoubleLimb>(limb) * scale;
+                limb = static_cast<Limb>(carry);
+                carry >>= LIMB_BITS;
+            }
+            if (carry) mag.push_back(static_cast<Limb>(carry));
         }
-        trim_leading_zeros();
+        const bool is_neg = negative && !mag.empty();
+        *this = from_parts(is_neg, std::move(mag));
     }
-    BigInt(BigInt&& other) noexcept : digits_(std::move(other.digits_)), is_negative_(other.is_negative_) {
-        other.digits_.clear(); other.is_negative_ = false;
+    BigInt(BigInt&& other) noexcept
+        : is_small_(other.is_small_), small_(other.small_),
+          limbs_(std::move(other.limbs_)), is_negative_(other.is_negative_) {
+        other.is_small_ = true; other.small_ = 0; other.is_negative_ = false;
     }
     BigInt& operator=(BigInt&& other) noexcept {
-        if (this != &other) { digits_ = std::move(other.digits_); is_negative_ = other.is_negative_; other.digits_.clear(); other.is_negative_ = false; }
+        if (this != &other) {
+            is_small_ = other.is_small_; small_ = other.small_;
+            limbs_ = std::move(other.limbs_); is_negative_ = other.is_negative_;
+            other.is_small_ = true; other.small_ = 0; other.limbs_.clear(); other.is_negative_ = false;
+        }
         return *this;
     }
 
@@ -284,107 +597,94 @@ public:
     ~BigInt() = default;
 
     [[nodiscard]] bool is_negative() const {
-        return is_negative_;
+        return negative();
+    }
+
+    /**
+     * @brief 是否为内联的 int64_t 形式，是则可用 small_value() 直接取值
+     */
+    [[nodiscard]] bool is_small() const {
+        return is_small_;
+    }
+
+    [[nodiscard]] int64_t small_value() const {
+        assert(is_small_);
+        return small_;
     }
 
     // ========================= 绝对值 =========================
     [[nodiscard]] BigInt abs() const {
-        BigInt res = *this;
-        res.is_negative_ = false;
-        return res;
+        if (is_small_ && small_ != INT64_MIN) {
+            return BigInt(small_ < 0 ? -small_ : small_);
+        }
+        return from_parts(false, magnitude());
     }
 
     // ========================= 比较运算符 =========================
     bool operator==(const BigInt& other) const {
-        if (is_negative_ != other.is_negative_ || digits_.size() != other.digits_.size()) return false;
-        return digits_ == other.digits_;
+        if (is_small_ != other.is_small_) return false;
+        if (is_small_) return small_ == other.small_;
+        return is_negative_ == other.is_negative_ && limbs_ == other.limbs_;
     }
     bool operator!=(const BigInt& other) const { return !(*this == other); }
     bool operator<(const BigInt& other) const {
-        if (is_negative_ != other.is_negative_) return is_negative_;
-        if (digits_.size() != other.digits_.size()) return is_negative_ ? (digits_.size() > other.digits_.size()) : (digits_.size() < other.digits_.size());
-        for (auto it1 = digits_.rbegin(), it2 = other.digits_.rbegin(); it1 != digits_.rend(); ++it1, ++it2) {
-            if (*it1 != *it2) return is_negative_ ? (*it1 > *it2) : (*it1 < *it2);
-        }
-        return false;
+        if (is_small_ && other.is_small_) return small_ < other.small_;
+        const bool a_neg = negative(), b_neg = other.negative();
+        if (a_neg != b_neg) return a_neg;
+        // 同号：大整数形式的绝对值必然大于内联形式
+        int cmp;
+        if (is_small_) cmp = -1;
+        else if (other.is_small_) cmp = 1;
+        else cmp = abs_compare(limbs_, other.limbs_);
+        return a_neg ? cmp > 0 : cmp < 0;
     }
     bool operator>(const BigInt& other) const { return other < *this; }
-    bool operator<=(const BigInt& other) const { return *this < other || *this == other; }
-    bool operator>=(const BigInt& other) const { return *this > other || *this == other; }
+    bool operator<=(const BigInt& other) const { return !(other < *this); }
+    bool operator>=(const BigInt& other) const { return !(*this < other); }
 
     // ========================= 核心运算：加法 =========================
     BigInt operator+(const BigInt& other) const {
-        BigInt res;
-        res.digits_.clear(); // 清空默认的[0]
-
-        // 情况1：同号（都正或都负）→ 绝对值相加，符号不变
-        if (is_negative_ == other.is_negative_) {
-            res.is_negative_ = is_negative_;
-            uint32_t carry = 0; // 进位（用32位避免溢出）
-            size_t max_len = std::max(digits_.size(), other.digits_.size());
-
-            for (size_t i = 0; i < max_len || carry > 0; ++i) {
-                // 取当前位（不足补0）
-                uint32_t a = (i < digits_.size()) ? digits_[i] : 0;
-                uint32_t b = (i < other.digits_.size()) ? other.digits_[i] : 0;
-                uint32_t sum = a + b + carry;
-
-                res.digits_.push_back(static_cast<uint8_t>(sum % 10));
-                carry = sum / 10;
-            }
+        int64_t res;
+        if (is_small_ && other.is_small_ && !__builtin_add_overflow(small_, other.small_, &res)) {
+            return BigInt(res);
         }
-        // 情况2：异号（一正一负）→ 绝对值相减，符号取绝对值大的
-        else {
-            if (abs_less(other)) {
-                // this绝对值 < other绝对值
-                res = unsigned_subtract(other, *this);
-                res.is_negative_ = other.is_negative_;
-            } else {
-                // this绝对值 >= other绝对值
-                res = unsigned_subtract(*this, other);
-                res.is_negative_ = is_negative_;
-            }
-        }
-
-        res.trim_leading_zeros();
-        return res;
+        return signed_add(negative(), magnitude(), other.negative(), other.magnitude());
     }
 
     BigInt& operator+=(const BigInt& other) {
+        if (is_small_ && other.is_small_ && !__builtin_add_overflow(small_, other.small_, &small_)) {
+            return *this;
+        }
         *this = *this + other;
         return *this;
     }
 
     // ========================= 核心运算：减法 =========================
     BigInt operator-(const BigInt& other) const {
-        // 特殊情况：减自己 → 0（保留，提升效率）
-        if (*this == other) {
-            return {0};
+        int64_t res;
+        if (is_small_ && other.is_small_ && !__builtin_sub_overflow(small_, other.small_, &res)) {
+            return BigInt(res);
         }
-        // 数学本质：a - b = a + (-b) （核心修复，复用加法的正确逻辑）
-        BigInt other_neg = other;       // 复制被减数
-        other_neg.is_negative_ = !other_neg.is_negative_; // 取反被减数的符号（得到相反数）
-        return *this + other_neg;       // 调用正确的加法运算符，完成所有计算
+        // a - b = a + (-b)
+        return signed_add(negative(), magnitude(), !other.negative(), other.magnitude());
     }
 
-
     BigInt& operator-=(const BigInt& other) {
+        if (is_small_ && other.is_small_ && !__builtin_sub_overflow(small_, other.small_, &small_)) {
+            return *this;
+        }
         *this = *this - other;
         return *this;
     }
 
     // ========================= 核心运算：乘法 =========================
     BigInt operator*(const BigInt& other) const {
-        if ((digits_.size() == 1 && digits_[0] == 0) || (other.digits_.size() == 1 && other.digits_[0] == 0)) {
-            return {0};
+        int64_t res;
+        if (is_small_ && other.is_small_ && !__builtin_mul_overflow(small_, other.small_, &res)) {
+            return BigInt(res);
         }
-
-        // 先计算无符号乘法
-        BigInt res = karatsuba_mul(this->abs(), other.abs());
-        // 再设置符号（异或运算：同号得正，异号得负）
-        res.is_negative_ = is_negative_ ^ other.is_negative_;
-        res.trim_leading_zeros();
-        return res;
+        // 同号得正，异号得负
+        return from_parts(negative() ^ other.negative(), unsigned_mul(magnitude(), other.magnitude()));
     }
 
     BigInt& operator*=(const BigInt& other) {
@@ -393,30 +693,29 @@ public:
     }
 
     // ========================= 核心运算：取模 =========================
+    /**
+     * @note 余数绝对值为 |a| mod |b|，被除数为负且余数非零时结果为 余数 - |b|
+     */
     BigInt operator%(const BigInt& other) const {
-        // 断言：除数不能为0
-        if(other.digits_.size() == 1 && other.digits_[0] == 0)
+        if (other == BigInt(0))
             throw NativeFuncError("CalculateError", "BigInt mod: divisor cannot be zero");
 
-        // 特殊情况：被除数为0→结果为0
-        if (digits_.size() == 1 && digits_[0] == 0) {
-            return BigInt(0);
+        if (is_small_ && other.is_small_ && small_ != INT64_MIN && other.small_ != INT64_MIN) {
+            const int64_t b_abs = other.small_ < 0 ? -other.small_ : other.small_;
+            const int64_t remainder = (small_ < 0 ? -small_ : small_) % b_abs;
+            if (small_ < 0 && remainder != 0) {
+                return BigInt(remainder - b_abs);
+            }
+            return BigInt(remainder);
         }
 
-        // 计算被除数、除数的绝对值
-        BigInt a_abs = this->abs();
-        BigInt b_abs = other.abs();
-
-        // 无符号取模（得到非负余数）
-        BigInt remainder = div_mod_unsigned(a_abs, b_abs).second;
-
-        // 调整余数符号（与被除数一致）
-        if (this->is_negative_ && remainder != BigInt(0)) {
-            remainder = remainder - b_abs; // 非零负余数：remainder = - (b_abs - remainder)
+        const Limbs b_abs = other.magnitude();
+        Limbs remainder = div_mod_unsigned(magnitude(), b_abs).second;
+        // 调整余数符号（非零负余数：remainder = - (b_abs - remainder)）
+        if (negative() && !remainder.empty()) {
+            return from_parts(true, unsigned_subtract(b_abs, remainder));
         }
-
-        remainder.trim_leading_zeros();
-        return remainder;
+        return from_parts(false, std::move(remainder));
     }
 
     BigInt& operator%=(const BigInt& other) {
@@ -426,24 +725,16 @@ public:
 
     // ========================= 核心运算：除法 =========================
     BigInt operator/(const BigInt& other) const {
-        // 断言：除数不能为0
-        if(other.digits_.size() == 1 && other.digits_[0] == 0)
+        if (other == BigInt(0))
             throw NativeFuncError("CalculateError", "divisor cannot be zero");
 
-        // 特殊情况：被除数为0→结果为0
-        if (digits_.size() == 1 && digits_[0] == 0) {
-            return {0};
+        // 向零截断，与C++整数除法一致（INT64_MIN / -1 溢出除外）
+        if (is_small_ && other.is_small_ && !(small_ == INT64_MIN && other.small_ == -1)) {
+            return BigInt(small_ / other.small_);
         }
 
-        // 符号：同号为正，异号为负（异或运算）
-        const bool res_neg = is_negative_ ^ other.is_negative_;
-
-        // 无符号除法取商
-        BigInt quotient = div_mod_unsigned(this->abs(), other.abs()).first;
-        quotient.is_negative_ = res_neg;
-        quotient.trim_leading_zeros();
-
-        return quotient;
+        // 符号：同号为正，异号为负
+        return from_parts(negative() ^ other.negative(), div_mod_unsigned(magnitude(), other.magnitude()).first);
     }
 
     BigInt& operator/=(const BigInt& other) {
@@ -454,7 +745,7 @@ public:
     // ========================= 核心运算：幂运算 =========================
     BigInt pow(const BigInt& other) const {
         // 指数必须为非负整数
-        if(other.is_negative_)
+        if(other.is_negative())
             throw NativeFuncError("CalculateError", "use negative int into Bigint.pow is unsupported");
 
         const BigInt& exp = other;
@@ -471,60 +762,63 @@ public:
             return zero;
         }
 
-        // 提取底数的绝对值（后续统一计算正数幂，最后处理符号）
-        BigInt base_abs = this->abs();
-        // 快速幂计算（处理正整数幂）
-        BigInt result_abs = fast_pow_unsigned(base_abs, exp);
-        // 确定结果符号（仅当底数为负且指数为奇数时，结果为负）
-        bool is_result_neg = this->is_negative_ && (exp % BigInt(2) == one);
-        result_abs.is_negative_ = is_result_neg;
-
-        result_abs.trim_leading_zeros();
+        // 快速幂计算绝对值的幂，再处理符号（仅当底数为负且指数为奇数时，结果为负）
+        BigInt result_abs = fast_pow_unsigned(this->abs(), exp);
+        if (negative() && exp % BigInt(2) == one) {
+            return zero - result_abs;
+        }
         return result_abs;
     }
 
+    // ========================= 哈希 =========================
+    /**
+     * @brief 机器字长哈希：可放入 uint64_t 的非负值（包括由 size_t 构造的哈希值）原样返回
+     */
+    [[nodiscard]] size_t hash_word() const {
+        if (is_small_) {
+            return static_cast<size_t>(small_);
+        }
+        uint64_t u;
+        if (!is_negative_ && limbs_to_u64(limbs_, u)) {
+            return static_cast<size_t>(u);
+        }
+        // FNV-1a 混合各 limb
+        size_t hash = 14695981039346656037ULL ^ static_cast<size_t>(is_negative_);
+        for (const Limb limb : limbs_) {
+            hash ^= limb;
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
     // ========================= 字符串/数值转换 =========================
     [[nodiscard]] std::string to_string() const {
-        std::string result;
-
-        // 边界处理：若 digits_ 为空（未初始化/零值），直接返回 "0"
-        if (digits_.empty()) {
-            return "0";
+        if (is_small_) {
+            return std::to_string(small_);
         }
 
-        // 处理负数符号
+        std::string result;
+        result.reserve(limbs_.size() * 10 + 1);
         if (is_negative_) {
             result += '-';
         }
-
-        // 逆序遍历
-        for (auto it = digits_.rbegin(); it != digits_.rend(); ++it) {
-            // *it 是 0-9 的数字，+'0' 转换为对应的 ASCII 字符（如 3 → '3'）
-            result += static_cast<char>('0' + *it);
-        }
-
+        append_decimal(limbs_, result, 0);
         return result;
     }
 
     [[nodiscard]] unsigned long long to_unsigned_long_long() const {
         // 检查是否为负数
-        if (is_negative_) {
+        if (negative()) {
             throw NativeFuncError("CalculateError","BigInt is negative, cannot convert to unsigned long long");
         }
-
-        // 检查是否超出范围
-        const BigInt ull_max_big(ULLONG_MAX);
-        if (*this > ull_max_big) {
-            throw NativeFuncError("CalculateError","BigInt value exceeds ULLONG_MAX");
+        if (is_small_) {
+            return static_cast<unsigned long long>(small_);
         }
 
-        unsigned long long result = 0;
-        // 修复核心：逆序遍历 digits_（从高位到低位）
-        for (auto it = digits_.rbegin(); it != digits_.rend(); ++it) {
-            unsigned char digit = *it;
-            result = result * 10 + digit;
+        uint64_t result;
+        if (!limbs_to_u64(limbs_, result)) {
+            throw NativeFuncError("CalculateError","BigInt value exceeds ULLONG_MAX");
         }
-
         return result;
     }
 
@@ -535,4 +829,4 @@ public:
     }
 };
 
-} // namespace dep
\ No newline at end of file
+} // namespace dep
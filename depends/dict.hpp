@@ -1,226 +1,228 @@
+/**
+ * @file dict.hpp
+ * @brief 保序紧凑字典（Dict）核心定义
+ *  * 参照 CPython 紧凑字典：索引数组（开放寻址）+ 按插入顺序排列的稠密条目数组；
+ *  * 每个条目缓存机器字长的哈希值，扩容只需重建索引数组；
+ *  * 哈希相同时用 KeyEq 比较真实键，避免哈希碰撞的不同键互相覆盖。
+ *
+ * @author azhz1107cat
+ * @date 2025-10-25
+ */
+
 #pragma once
-#include "bigint.hpp"
+#include <cstdint>
 #include <vector>
-#include <memory>
 #include <sstream>
+#include <string>
 #include <utility>
-#include <functional>
 
 namespace dep {
 
-template <typename VT>
+/**
+ * @tparam VT 条目值类型
+ * @tparam KeyEq 键比较函数对象：KeyEq{}(已存条目值, 待查键) 返回是否为同一个键，
+ *               待查键可以是 VT 本身或任意可比较的异构类型
+ */
+template <typename VT, typename KeyEq>
 class Dict {
 public:
-    // 桶节点：键为 BigInt，存储键值对与链表指针
-    struct Bucket {
-        BigInt key;          // 键类型改为 BigInt（支持哈希后的值）
-        VT value;            // 值类型保持泛型
-        std::shared_ptr<Bucket> next;
-
-        // 构造函数：直接接收 BigInt 键，无需计算字符串哈希
-        Bucket(const BigInt& k, VT val)
-            : key(k), value(std::move(val)), next(nullptr) {}
-
-        Bucket(BigInt&& k, VT&& val)
-            : key(std::move(k)), value(std::move(val)), next(nullptr) {}
+    struct Entry {
+        size_t hash;     // 缓存的哈希值
+        VT value;
     };
 
-    using Node = Bucket;
-    std::vector<std::shared_ptr<Node>> buckets_;  // 桶数组（链表头指针）
-    size_t elem_count_ = 0;                       // 元素总数
-    const float load_factor_ = 0.7f;              // 负载因子（const 不可修改）
+    using Node = Entry;
 
-    /**
-     * @brief 从 BigInt 键生成桶索引（基于 BigInt 的字符串哈希）
-     * 保证相同 BigInt 键始终映射到相同索引
-     */
-    [[nodiscard]] size_t getBucketIndex(const BigInt& key) const {
-        std::string key_str = key.to_string();
-        size_t hash = std::hash<std::string>()(key_str);
-        return hash & (buckets_.size() - 1);  // 位运算取模，要求桶大小为 2 的幂
+private:
+    static constexpr uint32_t IX_EMPTY = UINT32_MAX;
+    static constexpr size_t MIN_INDEX_SIZE = 8;
+    static constexpr size_t PERTURB_SHIFT = 5;
+
+    std::vector<uint32_t> indices_;   // 索引数组：槽位 → 条目下标（2 的幂长度）
+    std::vector<Entry> entries_;      // 稠密条目数组，按插入顺序排列
+    size_t elem_count_ = 0;           // 元素总数
+    size_t version_ = 0;              // 结构版本：新增条目或重建索引时递增，供探测中途检测修改
+
+    // 索引数组最多使用 2/3，超过则扩容
+    [[nodiscard]] static size_t usable(const size_t index_size) {
+        return index_size * 2 / 3;
     }
 
     /**
-     * @brief 扩容：桶大小翻倍，重新哈希所有元素
-     * 修复原逻辑中索引计算依赖节点 hash 的耦合问题
+     * @brief 按 CPython 的扰动序列探测
+     * @return 命中返回条目下标，否则返回 IX_EMPTY；slot 为命中槽位或第一个空槽位
      */
-    void resize() {
-        const size_t old_size = buckets_.size();
-        const size_t new_size = old_size * 2;
-        std::vector<std::shared_ptr<Node>> new_buckets(new_size, nullptr);
-
-        for (size_t i = 0; i < old_size; ++i) {
-            std::shared_ptr<Node> current = buckets_[i];
-            while (current != nullptr) {
-                std::shared_ptr<Node> next_node = current->next;
-                // 基于当前节点的 BigInt 键重新计算新索引
-                size_t new_idx = getBucketIndex(current->key);
-                // 头插法插入新桶
-                current->next = new_buckets[new_idx];
-                new_buckets[new_idx] = current;
-                current = next_node;
+    template <typename K>
+    uint32_t lookup(const size_t hash, const K& key, size_t& slot) const {
+    restart:
+        const size_t mask = indices_.size() - 1;
+        size_t i = hash & mask;
+        size_t perturb = hash;
+        while (true) {
+            const uint32_t ix = indices_[i];
+            if (ix == IX_EMPTY) {
+                slot = i;
+                return IX_EMPTY;
+            }
+            if (entries_[ix].hash == hash) {
+                // 拷贝一份再比较：KeyEq 可能执行用户代码并修改本字典，
+                // 此时 mask、探测位置与条目下标都已失效，与 CPython 的 lookdict 一样从头探测
+                const VT stored = entries_[ix].value;
+                const size_t version = version_;
+                const bool equal = KeyEq{}(stored, key);
+                if (version != version_) goto restart;
+                if (equal) {
+                    slot = i;
+                    return ix;
+                }
             }
+            perturb >>= PERTURB_SHIFT;
+            i = (i * 5 + perturb + 1) & mask;
         }
-
-        buckets_.swap(new_buckets);
-    }
-
-    // ========================= 构造与析构 =========================
-    explicit Dict() {
-        constexpr size_t init_size = 16;  // 初始桶大小为 2 的幂
-        buckets_.resize(init_size, nullptr);
     }
 
-    // 用 BigInt 键值对 vector 初始化
-    explicit Dict(const std::vector<std::pair<BigInt, VT>>& vec) {
-        // 计算初始桶大小，保证负载因子不超限
-        size_t init_size = 16;
-        while (init_size < (vec.size() / load_factor_)) {
-            init_size *= 2;
+    // 找到哈希对应的第一个空槽位（仅用于重建索引，此时已知键不重复）
+    [[nodiscard]] size_t find_empty_slot(const size_t hash) const {
+        const size_t mask = indices_.size() - 1;
+        size_t i = hash & mask;
+        size_t perturb = hash;
+        while (indices_[i] != IX_EMPTY) {
+            perturb >>= PERTURB_SHIFT;
+            i = (i * 5 + perturb + 1) & mask;
         }
-        buckets_.resize(init_size, nullptr);
+        return i;
+    }
 
-        for (const auto& [key, val] : vec) {
-            insert(key, val);
+    void rebuild_indices(const size_t index_size) {
+        ++version_;
+        indices_.assign(index_size, IX_EMPTY);
+        for (size_t ix = 0; ix < entries_.size(); ++ix) {
+            indices_[find_empty_slot(entries_[ix].hash)] = static_cast<uint32_t>(ix);
         }
     }
 
-    ~Dict() = default;  // shared_ptr 自动管理内存
-
-    // ========================= 拷贝与移动语义 =========================
-    // 深拷贝构造：逐节点拷贝键值对
-    Dict(const Dict& other)
-        : load_factor_(other.load_factor_) {  // const 成员只能初始化，不能赋值
-        auto all_kv = other.to_vector();
-        size_t init_size = 16;
-        while (init_size < (all_kv.size() / load_factor_)) {
-            init_size *= 2;
+    static size_t index_size_for(const size_t n) {
+        size_t size = MIN_INDEX_SIZE;
+        while (usable(size) < n) {
+            size *= 2;
         }
-        buckets_.resize(init_size, nullptr);
+        return size;
+    }
 
-        for (const auto& [key, val] : all_kv) {
-            insert(key, val);
+public:
+    // ========================= 构造与析构 =========================
+    explicit Dict() = default;
+
+    // 用 哈希-值 对 vector 初始化（重复键后者覆盖前者）
+    explicit Dict(const std::vector<std::pair<size_t, VT>>& vec) {
+        entries_.reserve(vec.size());
+        indices_.assign(index_size_for(vec.size()), IX_EMPTY);
+        for (const auto& [hash, val] : vec) {
+            insert(hash, val);
         }
-        elem_count_ = other.elem_count_;
     }
 
-    // 移动构造：转移资源所有权
-    Dict(Dict&& other) noexcept
-        : buckets_(std::move(other.buckets_)),
-          elem_count_(other.elem_count_),
-          load_factor_(other.load_factor_) {  // const 成员直接拷贝初始化
-        other.elem_count_ = 0;
-        other.buckets_.clear();
-    }
+    ~Dict() = default;
+
+    Dict(const Dict& other) = default;
 
-    // 深拷贝赋值
     Dict& operator=(const Dict& other) {
         if (this == &other) return *this;
 
-        // 清空当前资源
-        buckets_.clear();
-        elem_count_ = 0;
-
-        // 重新初始化桶并插入数据
-        auto all_kv = other.to_vector();
-        size_t init_size = 16;
-        while (init_size < (all_kv.size() / load_factor_)) {
-            init_size *= 2;
-        }
-        buckets_.resize(init_size, nullptr);
-
-        for (const auto& [key, val] : all_kv) {
-            insert(key, val);
-        }
-        elem_count_ = all_kv.size();
+        indices_ = other.indices_;
+        entries_ = other.entries_;
+        elem_count_ = other.elem_count_;
+        ++version_;
 
         return *this;
     }
 
-    // 移动赋值：修复原逻辑中修改 const 成员的 Bug
+    Dict(Dict&& other) noexcept
+        : indices_(std::move(other.indices_)),
+          entries_(std::move(other.entries_)),
+          elem_count_(other.elem_count_) {
+        other.indices_.clear();
+        other.entries_.clear();
+        other.elem_count_ = 0;
+    }
+
     Dict& operator=(Dict&& other) noexcept {
         if (this == &other) return *this;
 
-        // 清空当前资源
-        buckets_.clear();
-        elem_count_ = 0;
-
-        // 转移 other 的资源（不修改 load_factor_）
-        buckets_ = std::move(other.buckets_);
+        indices_ = std::move(other.indices_);
+        entries_ = std::move(other.entries_);
         elem_count_ = other.elem_count_;
+        ++version_;
 
         // 置空原对象
+        other.indices_.clear();
+        other.entries_.clear();
         other.elem_count_ = 0;
-        other.buckets_.clear();
 
         return *this;
     }
 
     // ========================= 核心操作：插入与查找 =========================
     /**
-     * @brief 插入/更新键值对（基于 BigInt 键）
-     * @param key BigInt 类型键（支持已哈希值）
-     * @param val 要存储的值
+     * @brief 插入/更新键值对
+     * @param hash 键的哈希值
+     * @param val 要存储的值（其中携带的键由 KeyEq 比较）
      * @return 旧值（若存在），否则返回 VT()
      */
-    VT insert(const BigInt& key, VT val) {
-        if (buckets_.empty()) {
-            buckets_.resize(16, nullptr);
+    VT insert(const size_t hash, VT val) {
+        if (indices_.empty()) {
+            indices_.assign(MIN_INDEX_SIZE, IX_EMPTY);
         }
 
-        size_t bucket_idx = getBucketIndex(key);
-        VT old_val = VT();
-
-        // 检查键是否已存在：存在则更新值
-        std::shared_ptr<Node> current = buckets_[bucket_idx];
-        while (current != nullptr) {
-            if (current->key == key) {
-                old_val = std::move(current->value);
-                current->value = std::move(val);
-                return old_val;
-            }
-            current = current->next;
+        size_t slot;
+        const uint32_t ix = lookup(hash, val, slot);
+        if (ix != IX_EMPTY) {
+            VT old_val = std::move(entries_[ix].value);
+            entries_[ix].value = std::move(val);
+            return old_val;
         }
 
-        // 检查负载因子，触发扩容
-        if (static_cast<float>(elem_count_) / buckets_.size() >= load_factor_) {
-            resize();
-            // 扩容后重新计算索引
-            bucket_idx = getBucketIndex(key);
+        if (entries_.size() >= usable(indices_.size())) {
+            rebuild_indices(indices_.size() * 2);
+            slot = find_empty_slot(hash);
         }
 
-        // 插入新节点（头插法）
-        auto new_node = std::make_shared<Node>(key, std::move(val));
-        new_node->next = buckets_[bucket_idx];
-        buckets_[bucket_idx] = new_node;
-        elem_count_++;
+        indices_[slot] = static_cast<uint32_t>(entries_.size());
+        entries_.push_back(Entry{hash, std::move(val)});
+        ++elem_count_;
+        ++version_;
 
-        return old_val;
+        return VT();
     }
 
     /**
-     * @brief 查找 BigInt 键对应的节点
-     * @return 找到返回节点指针，否则返回 nullptr
+     * @brief 查找键对应的条目
+     * @return 找到返回条目指针，否则返回 nullptr（指针在下一次插入前有效）
      */
-    [[nodiscard]] std::shared_ptr<Node> find(const BigInt& key) const {
-        if (buckets_.empty()) {
-            return nullptr;
-        }
-
-        size_t bucket_idx = getBucketIndex(key);
-        std::shared_ptr<Node> current = buckets_[bucket_idx];
-
-        while (current != nullptr) {
-            if (current->key == key) {
-                return current;
-            }
-            current = current->next;
-        }
+    template <typename K>
+    [[nodiscard]] Node* find(const size_t hash, const K& key) {
+        if (indices_.empty()) return nullptr;
+        size_t slot;
+        const uint32_t ix = lookup(hash, key, slot);
+        return ix == IX_EMPTY ? nullptr : &entries_[ix];
+    }
 
-        return nullptr;
+    template <typename K>
+    [[nodiscard]] const Node* find(const size_t hash, const K& key) const {
+        if (indices_.empty()) return nullptr;
+        size_t slot;
+        const uint32_t ix = lookup(hash, key, slot);
+        return ix == IX_EMPTY ? nullptr : &entries_[ix];
     }
 
     // ========================= 辅助方法 =========================
+    /**
+     * @brief 按插入顺序排列的条目
+     */
+    [[nodiscard]] const std::vector<Entry>& entries() const {
+        return entries_;
+    }
+
     /**
      * @brief 转换为字符串（支持 VT 类型的 to_string 方法或指针）
      */
@@ -229,21 +231,17 @@ public:
         ss << "{ ";
 
         size_t printed = 0;
-        for (const auto& bucket_head : buckets_) {
-            auto current = bucket_head;
-            while (current != nullptr) {
-                ss << current->key.to_string() << ": ";
-                if constexpr (std::is_pointer_v<VT>) {
-                    ss << static_cast<void*>(current->value);
-                } else {
-                    ss << current->value.to_string();
-                }
+        for (const auto& entry : entries_) {
+            ss << entry.hash << ": ";
+            if constexpr (std::is_pointer_v<VT>) {
+                ss << static_cast<void*>(entry.value);
+            } else {
+                ss << entry.value.to_string();
+            }
 
-                printed++;
-                if (printed < elem_count_) {
-                    ss << ", ";
-                }
-                current = current->next;
+            printed++;
+            if (printed < elem_count_) {
+                ss << ", ";
             }
         }
 
@@ -252,16 +250,13 @@ public:
     }
 
     /**
-     * @brief 转换为 BigInt 键值对 vector
+     * @brief 转换为 哈希-值 对 vector（按插入顺序）
      */
-    [[nodiscard]] std::vector<std::pair<BigInt, VT>> to_vector() const {
-        std::vector<std::pair<BigInt, VT>> vec;
-        for (const auto& bucket_head : buckets_) {
-            auto current = bucket_head;
-            while (current != nullptr) {
-                vec.emplace_back(current->key, current->value);
-                current = current->next;
-            }
+    [[nodiscard]] std::vector<std::pair<size_t, VT>> to_vector() const {
+        std::vector<std::pair<size_t, VT>> vec;
+        vec.reserve(entries_.size());
+        for (const auto& entry : entries_) {
+            vec.emplace_back(entry.hash, entry.value);
         }
         return vec;
     }
@@ -281,4 +276,4 @@ public:
     }
 };
 
-} // namespace dep
\ No newline at end of file
+} // namespace dep
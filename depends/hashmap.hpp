@@ -1,23 +1,37 @@
 /**
  * @file hashmap.hpp
  * @brief 辅助容器（HashMap）核心定义与实现
- * 
+ *  * 开放寻址的扁平哈希表（SwissTable 风格）：每个槽位对应 1 字节控制字节，
+ *    存放空/已删除标记或哈希值高 7 位（h2），查找时以 16 槽位为一组并行比对控制字节；
+ *  * 支持 SSE2 时用 SIMD 比对整组，否则退化为逐字节比对；
+ *  * 槽位缓存完整哈希值，扩容时无需重新计算；
+ *  * 查找/删除接受 std::string_view，无需构造临时 std::string；
+ *  * 各操作都有接受预先算好哈希值的重载（见 symbol.hpp），避免重复哈希字符串。
+ *
  * @author azhz1107cat
  * @date 2025-10-25
  */
 
 #pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <vector>
 #include <string>
-#include <memory>
+#include <string_view>
 #include <sstream>
 #include <utility>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace dep {
 
 // 字符串哈希函数（FNV-1a算法）
-inline size_t hash_string(const std::string& key) {
+inline size_t hash_string(const std::string_view key) {
     constexpr size_t FNV_OFFSET = 14695981039346656037ULL;
     constexpr size_t FNV_PRIME = 1099511628211ULL;
     size_t hash = FNV_OFFSET;
@@ -28,192 +42,281 @@ inline size_t hash_string(const std::string& key) {
     return hash;
 }
 
+// 一组控制字节（16 个），用于批量比对
+class CtrlGroup {
+public:
+    static constexpr size_t WIDTH = 16;
+
+    explicit CtrlGroup(const int8_t* pos) {
+#if defined(__SSE2__)
+        ctrl_ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+#else
+        std::memcpy(ctrl_, pos, WIDTH);
+#endif
+    }
+
+    // 返回控制字节等于 b 的槽位位掩码（第 i 位对应组内第 i 个槽位）
+    [[nodiscard]] uint32_t match(const int8_t b) const {
+#if defined(__SSE2__)
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(b), ctrl_)));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < WIDTH; ++i) {
+            if (ctrl_[i] == b) mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    // 返回空或已删除（即非满）槽位的位掩码：控制字节最高位为1
+    [[nodiscard]] uint32_t match_empty_or_deleted() const {
+#if defined(__SSE2__)
+        return static_cast<uint32_t>(_mm_movemask_epi8(ctrl_));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < WIDTH; ++i) {
+            if (ctrl_[i] < 0) mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+private:
+#if defined(__SSE2__)
+    __m128i ctrl_;
+#else
+    int8_t ctrl_[WIDTH];
+#endif
+};
+
 // 模板类：键为std::string，值为任意类型T的HashMap
 template <typename VT>
 class HashMap {
 public:
-    // 嵌套桶节点结构体（存储键值对、哈希值、链表指针）
-    struct StringBucket {
+    // 槽位：存储键值对及其缓存的哈希值
+    struct Slot {
         std::string key;
-        VT value;
-        size_t hash;
-        std::shared_ptr<StringBucket> next;
-
-        // 修复：先拷贝key，计算hash后再move，避免初始化顺序问题
-        StringBucket(const std::string& k, VT val)
-            : key(k),  // 先拷贝，不提前move
-              value(std::move(val)),
-              hash(hash_string(k)), // 直接用入参k计算hash，避免依赖成员变量初始化顺序
-              next(nullptr) {}
-
-        // 保留移动构造（优化性能）
-        StringBucket(std::string&& k, VT&& val)
-            : key(std::move(k)),
-              value(std::move(val)),
-              hash(hash_string(this->key)), // 此时key已move完成
-              next(nullptr) {}
+        VT value{};
+        size_t hash = 0;
     };
 
-    using Node = StringBucket;  // 简化节点类型名
-    std::vector<std::shared_ptr<Node>> buckets_;  // 桶数组（每个元素是链表头指针）
-    size_t elem_count_ = 0;                       // 元素总数
-    const float load_factor_ = 0.7f;              // 负载因子（触发扩容的阈值）
+    using Node = Slot;  // 简化节点类型名
+
+private:
+    // 控制字节：最高位为1表示非满槽位，否则低 7 位为 h2
+    static constexpr int8_t CTRL_EMPTY = -128;   // 0b10000000
+    static constexpr int8_t CTRL_DELETED = -2;   // 0b11111110
+    static constexpr size_t GROUP_WIDTH = CtrlGroup::WIDTH;
+    // 大多数对象只有一两个属性，初始容量取小表；不足一组的控制字节以空标记补齐
+    static constexpr size_t INIT_CAPACITY = 4;
+
+    std::vector<int8_t> ctrl_;    // 控制字节数组，长度为 max(容量, GROUP_WIDTH)
+    std::vector<Slot> slots_;     // 槽位数组，长度等于容量（2 的幂；不小于一组时为 GROUP_WIDTH 的倍数）
+    size_t elem_count_ = 0;       // 元素总数
+    size_t growth_left_ = 0;      // 扩容前还能占用的空槽位数（负载因子 7/8，已删除槽位也计入占用）
+
+    static int8_t h2(const size_t hash) {
+        return static_cast<int8_t>(hash >> (sizeof(size_t) * 8 - 7));
+    }
+
+    [[nodiscard]] size_t group_count() const {
+        return slots_.size() < GROUP_WIDTH ? 1 : slots_.size() / GROUP_WIDTH;
+    }
 
-    // 计算键对应的桶索引（利用位运算，要求桶大小为2的幂）
-    [[nodiscard]] size_t getBucketIndex(const size_t hash) const {
-        return hash & (this->buckets_.size() - 1);
+    static size_t max_load(const size_t capacity) {
+        return capacity - capacity / 8;
+    }
+
+    // 按三角数序列探测各组（组数为 2 的幂，保证遍历所有组）
+    template <typename Fn>
+    void probe(const size_t hash, Fn&& fn) const {
+        const size_t mask = group_count() - 1;
+        size_t group = hash & mask;
+        for (size_t step = 1; step <= group_count(); ++step) {
+            if (fn(group * GROUP_WIDTH)) return;
+            group = (group + step) & mask;
+        }
     }
 
-    // 扩容：桶数组大小翻倍，重新哈希所有元素
-    void resize() {
-        const size_t old_size = buckets_.size();
-        const size_t new_size = old_size * 2;
-        std::vector<std::shared_ptr<Node>> new_buckets(new_size, nullptr);
-
-        for (size_t i = 0; i < old_size; ++i) {
-            std::shared_ptr<Node> current = buckets_[i];
-            while (current != nullptr) {
-                const std::shared_ptr<Node> next = current->next;
-                // 修复：使用节点自身缓存的hash计算新索引
-                const size_t new_idx = current->hash & (new_size - 1);
-                current->next = new_buckets[new_idx];
-                new_buckets[new_idx] = current;
-                current = next;
+    [[nodiscard]] size_t find_index(const std::string_view key, const size_t hash) const {
+        size_t found = SIZE_MAX;
+        if (slots_.empty()) return found;
+        const int8_t tag = h2(hash);
+        probe(hash, [&](const size_t base) {
+            const CtrlGroup group(&ctrl_[base]);
+            for (uint32_t m = group.match(tag); m != 0; m &= m - 1) {
+                const size_t idx = base + std::countr_zero(m);
+                if (slots_[idx].hash == hash && slots_[idx].key == key) {
+                    found = idx;
+                    return true;
+                }
             }
+            // 组内有空槽位则键不可能出现在后续组中
+            return group.match(CTRL_EMPTY) != 0;
+        });
+        return found;
+    }
+
+    // 找到第一个可写入的（空或已删除）槽位
+    [[nodiscard]] size_t find_insert_slot(const size_t hash) const {
+        size_t found = SIZE_MAX;
+        probe(hash, [&](const size_t base) {
+            uint32_t m = CtrlGroup(&ctrl_[base]).match_empty_or_deleted();
+            // 小表补齐的控制字节不对应实际槽位
+            if (slots_.size() < GROUP_WIDTH) m &= (1u << slots_.size()) - 1;
+            if (m == 0) return false;
+            found = base + std::countr_zero(m);
+            return true;
+        });
+        return found;
+    }
+
+    void set_ctrl(const size_t idx, const int8_t c) {
+        ctrl_[idx] = c;
+    }
+
+    // 按新容量重建表（已删除槽位在此被清除）
+    void rehash(const size_t new_capacity) {
+        std::vector<int8_t> old_ctrl = std::move(ctrl_);
+        std::vector<Slot> old_slots = std::move(slots_);
+
+        ctrl_.assign(std::max(new_capacity, GROUP_WIDTH), CTRL_EMPTY);
+        slots_ = std::vector<Slot>(new_capacity);
+        growth_left_ = max_load(new_capacity) - elem_count_;
+
+        for (size_t i = 0; i < old_slots.size(); ++i) {
+            if (old_ctrl[i] < 0) continue;
+            // 使用槽位缓存的hash，无需重新计算
+            const size_t idx = find_insert_slot(old_slots[i].hash);
+            set_ctrl(idx, h2(old_slots[i].hash));
+            slots_[idx] = std::move(old_slots[i]);
         }
+    }
 
-        buckets_.swap(new_buckets);
+    // 保证至少还能插入一个元素
+    void reserve_one() {
+        if (slots_.empty()) {
+            rehash(INIT_CAPACITY);
+            return;
+        }
+        if (growth_left_ > 0) return;
+        // 已删除槽位过多时原地重建即可，否则容量翻倍
+        if (elem_count_ * 2 < max_load(slots_.size())) {
+            rehash(slots_.size());
+        } else {
+            rehash(slots_.size() * 2);
+        }
     }
 
-    // 默认构造函数（初始桶大小为16，2的幂）
-    explicit HashMap() {
-        constexpr size_t init_size = 16;
-        buckets_.resize(init_size, nullptr);
+    static size_t capacity_for(const size_t n) {
+        size_t cap = INIT_CAPACITY;
+        while (max_load(cap) < n) {
+            cap *= 2;
+        }
+        return cap;
     }
 
-    // 用键值对vector初始化
-    explicit HashMap(const std::vector<std::pair<std::string, VT>>& vec) {
-        // 计算初始桶大小（确保负载因子不超过阈值）
-        size_t init_size = 16;
-        while (init_size < (vec.size() / load_factor_)) {
-            init_size *= 2;
+    template <typename Fn>
+    void for_each_slot(Fn&& fn) const {
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            if (ctrl_[i] >= 0) fn(slots_[i]);
         }
-        buckets_.resize(init_size, nullptr);
+    }
+
+public:
+    // 默认构造函数（延迟到首次插入时分配）
+    explicit HashMap() = default;
 
-        // 插入所有初始键值对
+    // 用键值对vector初始化
+    explicit HashMap(const std::vector<std::pair<std::string, VT>>& vec) {
+        rehash(capacity_for(vec.size()));
         for (const auto& [key, val] : vec) {
             insert(key, val);
         }
     }
 
-    // 析构函数（默认即可，shared_ptr自动释放内存）
     ~HashMap() = default;
 
     // 插入/更新键值对（存在则更新，不存在则插入）
     VT insert(const std::string& key, VT val) {
-        if (buckets_.empty()) {
-            buckets_.resize(16, nullptr);
-        }
-
-        // 修复：先计算hash和bucket_idx（基于当前桶大小）
-        const size_t hash = hash_string(key);
-        size_t bucket_idx = getBucketIndex(hash);
-
-        // 检查是否已存在（扩容前先查，避免扩容后索引变化）
-        std::shared_ptr<Node> current = buckets_[bucket_idx];
-        while (current != nullptr) {
-            if (current->hash == hash && current->key == key) {
-                current->value = std::move(val);
-                return VT(); // 更新值，不递增计数
-            }
-            current = current->next;
-        }
+        return insert(key, std::move(val), hash_string(key));
+    }
 
-        // 检查负载因子，需要扩容则重新计算索引
-        if (static_cast<float>(elem_count_) / buckets_.size() >= load_factor_) {
-            this->resize();
-            // 扩容后重新计算索引（基于新桶大小）
-            bucket_idx = getBucketIndex(hash);
+    // hash 必须等于 hash_string(key)
+    VT insert(const std::string& key, VT val, const size_t hash) {
+        const size_t existing = find_index(key, hash);
+        if (existing != SIZE_MAX) {
+            slots_[existing].value = std::move(val);
+            return VT(); // 更新值，不递增计数
         }
 
-        // 插入新节点（头插法）
-        auto new_node = std::make_shared<Node>(key, std::move(val));
-        new_node->next = buckets_[bucket_idx];
-        buckets_[bucket_idx] = new_node;
-        elem_count_++; // 仅插入新节点时递增
+        reserve_one();
+        const size_t idx = find_insert_slot(hash);
+        // 复用已删除槽位不消耗 growth_left_
+        if (ctrl_[idx] == CTRL_EMPTY) --growth_left_;
+        set_ctrl(idx, h2(hash));
+        slots_[idx].key = key;
+        slots_[idx].value = std::move(val);
+        slots_[idx].hash = hash;
+        ++elem_count_;
 
         return VT();
     }
 
-    [[nodiscard]] std::shared_ptr<Node> find(const std::string& key) const {
-        return find_in_current(key);
+    /**
+     * @brief 查找键，返回槽位指针（不存在返回 nullptr）
+     * @note 返回的指针在下一次插入前有效（插入可能触发扩容并移动槽位）
+     */
+    [[nodiscard]] Node* find(const std::string_view key) {
+        const size_t idx = find_index(key, hash_string(key));
+        return idx == SIZE_MAX ? nullptr : &slots_[idx];
     }
 
-    // 仅在当前HashMap查找键（不递归父结构体）
-    [[nodiscard]] std::shared_ptr<Node> find_in_current(const std::string& key) const {
-        if (buckets_.empty()) {
-            return nullptr;
-        }
+    [[nodiscard]] const Node* find(const std::string_view key) const {
+        const size_t idx = find_index(key, hash_string(key));
+        return idx == SIZE_MAX ? nullptr : &slots_[idx];
+    }
 
-        const size_t hash = hash_string(key);
-        const size_t bucket_idx = getBucketIndex(hash);
-        if (bucket_idx >= buckets_.size()) {
-            return nullptr;
-        }
+    [[nodiscard]] Node* find(const std::string_view key, const size_t hash) {
+        const size_t idx = find_index(key, hash);
+        return idx == SIZE_MAX ? nullptr : &slots_[idx];
+    }
 
-        // 遍历桶对应的链表查找
-        std::shared_ptr<Node> current = buckets_[bucket_idx];
-        while (current != nullptr) {
-            if (current->hash == hash && current->key == key) {
-                return current;
-            }
-            current = current->next;
-        }
+    [[nodiscard]] const Node* find(const std::string_view key, const size_t hash) const {
+        const size_t idx = find_index(key, hash);
+        return idx == SIZE_MAX ? nullptr : &slots_[idx];
+    }
 
-        return nullptr;
+    // 仅在当前HashMap查找键（不递归父结构体）
+    [[nodiscard]] const Node* find_in_current(const std::string_view key) const {
+        return find(key);
     }
 
-    bool del(const std::string& attr_name) {
-        // 空桶数组直接返回删除失败
-        if (buckets_.empty()) {
-            return false;
-        }
+    bool del(const std::string_view attr_name) {
+        return del(attr_name, hash_string(attr_name));
+    }
 
-        // 计算键的哈希值和桶索引
-        const size_t hash = hash_string(attr_name);
-        const size_t bucket_idx = getBucketIndex(hash);
-        if (bucket_idx >= buckets_.size()) {
+    bool del(const std::string_view attr_name, const size_t hash) {
+        const size_t idx = find_index(attr_name, hash);
+        if (idx == SIZE_MAX) {
             return false;
         }
 
-        // 遍历链表查找目标节点（需要前驱节点指针）
-        std::shared_ptr<Node> prev = nullptr;
-        std::shared_ptr<Node> current = buckets_[bucket_idx];
-
-        while (current != nullptr) {
-            // 哈希值+键双重校验（避免哈希碰撞）
-            if (current->hash == hash && current->key == attr_name) {
-                // 要删除的是头节点
-                if (prev == nullptr) {
-                    buckets_[bucket_idx] = current->next;
-                }
-                // 要删除的是中间/尾节点
-                else {
-                    prev->next = current->next;
-                }
-
-                // 释放当前节点（shared_ptr自动管理，断开链接后计数减1）
-                current.reset();
-                elem_count_--; // 减少元素计数
-                return true;   // 删除成功
-            }
-
-            prev = current;
-            current = current->next;
+        // 所在组仍有空槽位时，没有探测链经过这一组，可直接标记为空
+        const size_t base = idx - idx % GROUP_WIDTH;
+        if (CtrlGroup(&ctrl_[base]).match(CTRL_EMPTY) != 0) {
+            set_ctrl(idx, CTRL_EMPTY);
+            ++growth_left_;
+        } else {
+            set_ctrl(idx, CTRL_DELETED);
         }
+        slots_[idx] = Slot{};
+        --elem_count_;
+        return true;
+    }
 
-        // 遍历完未找到对应键，删除失败
-        return false;
+    [[nodiscard]] size_t size() const {
+        return elem_count_;
     }
 
     // 转换为字符串（需T支持to_string()成员函数）
@@ -222,24 +325,18 @@ public:
         ss << "{ ";
 
         size_t current_idx = 0;
-        size_t total_count = this->elem_count_; // 直接用已统计的数量，无需遍历
-
-        for (const auto& bucket_head : buckets_) {
-            auto current = bucket_head;
-            while (current != nullptr) {
-                ss << current->key << ": ";
-                if constexpr (std::is_pointer_v<VT>) {
-                    ss << static_cast<void*>(current->value);
-                } else {
-                    ss << current->value.to_string();
-                }
-                if (current_idx < total_count - 1) {
-                    ss << ", ";
-                }
-                current = current->next;
-                current_idx++;
+        for_each_slot([&](const Slot& slot) {
+            ss << slot.key << ": ";
+            if constexpr (std::is_pointer_v<VT>) {
+                ss << static_cast<void*>(slot.value);
+            } else {
+                ss << slot.value.to_string();
             }
-        }
+            if (current_idx < elem_count_ - 1) {
+                ss << ", ";
+            }
+            current_idx++;
+        });
 
         ss << " }";
         return ss.str();
@@ -248,83 +345,44 @@ public:
     // 转换为键值对vector
     [[nodiscard]] std::vector<std::pair<std::string, VT>> to_vector() const {
         std::vector<std::pair<std::string, VT>> vec;
-        for (const auto& bucket_head : buckets_) {
-            auto current = bucket_head;
-            while (current != nullptr) {
-                vec.emplace_back(current->key, current->value);
-                current = current->next;
-            }
-        }
+        vec.reserve(elem_count_);
+        for_each_slot([&](const Slot& slot) {
+            vec.emplace_back(slot.key, slot.value);
+        });
         return vec;
     }
 
-    // 深拷贝构造函数
-    HashMap(const HashMap& other)
-        : load_factor_(other.load_factor_) {
-        // 获取源HashMap的所有键值对
-        auto all_kv = other.to_vector();
-        // 计算初始桶大小
-        size_t init_size = 16;
-        while (init_size < (all_kv.size() / load_factor_)) {
-            init_size *= 2;
-        }
-        buckets_.resize(init_size, nullptr);
-
-        // 插入所有键值对（深拷贝）
-        for (auto& [key, val] : all_kv) {
-            this->insert(key, val);
-        }
-        this->elem_count_ = other.elem_count_;
-    }
+    HashMap(const HashMap& other) = default;
 
     HashMap(HashMap&& other) noexcept
-    : buckets_(std::move(other.buckets_)),
-      elem_count_(other.elem_count_),
-      load_factor_(other.load_factor_) {
-        other.elem_count_ = 0; // 置空原对象计数
-        other.buckets_.clear(); // 置空原对象桶数组
+        : ctrl_(std::move(other.ctrl_)),
+          slots_(std::move(other.slots_)),
+          elem_count_(other.elem_count_),
+          growth_left_(other.growth_left_) {
+        other.ctrl_.clear();
+        other.slots_.clear();
+        other.elem_count_ = 0;
+        other.growth_left_ = 0;
     }
 
-    HashMap& operator=(const HashMap& other) {
-        if (this == &other) return *this;
-
-        buckets_.clear();
-        elem_count_ = 0; // 重置计数
-
-        auto all_kv = other.to_vector();
-        size_t init_size = 16;
-        while (init_size < (all_kv.size() / load_factor_)) {
-            init_size *= 2;
-        }
-        buckets_.resize(init_size, nullptr);
-
-        // 修复：手动计数，避免insert自动递增的误差
-        for (auto& [key, val] : all_kv) {
-            this->insert(key, val);
-        }
-        this->elem_count_ = all_kv.size(); // 直接赋值正确的数量
+    HashMap& operator=(const HashMap& other) = default;
 
-        return *this;
-    }
-
-    // 修复移动赋值运算符
     HashMap& operator=(HashMap&& other) noexcept {
         if (this == &other) return *this; // 自赋值检查
 
-        // 释放当前资源
-        buckets_.clear();
-        elem_count_ = 0;
-
-        // 转移其他对象的资源（删除 load_factor_ = other.load_factor_）
-        buckets_ = std::move(other.buckets_);
+        ctrl_ = std::move(other.ctrl_);
+        slots_ = std::move(other.slots_);
         elem_count_ = other.elem_count_;
+        growth_left_ = other.growth_left_;
 
         // 置空原对象
+        other.ctrl_.clear();
+        other.slots_.clear();
         other.elem_count_ = 0;
-        other.buckets_.clear();
+        other.growth_left_ = 0;
 
         return *this;
     }
 };
 
-} // namespace dep
\ No newline at end of file
+} // namespace dep
@@ -0,0 +1,137 @@
+/**
+ * @file pool.hpp
+ * @brief 按大小分级的对象池（slab 分配器）
+ *  * 小对象按 16 字节分级，每级从 64KB 的 slab 中切块，释放的块挂回本级空闲链表，
+ *    再次分配同级对象时直接复用，不经过 malloc/free；
+ *  * 空闲链表与 slab 按线程独立（thread_local），分配与释放都无需加锁；
+ *    slab 在进程结束前不归还系统，块可以在任意线程释放到该线程的链表中；
+ *  * 超过 MAX_POOLED_SIZE 的对象直接使用全局 operator new；
+ *  * 定义 KIZ_POOL_USE_MALLOC 时全部退回全局 operator new/delete，便于 ASan/Valgrind 检查，
+ *    此时统计中只有 fallback 计数。
+ *
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <new>
+
+namespace dep {
+
+class ObjectPool {
+public:
+    static constexpr size_t GRANULE = 16;
+    static constexpr size_t MAX_POOLED_SIZE = 256;
+    static constexpr size_t CLASS_COUNT = MAX_POOLED_SIZE / GRANULE;
+    static constexpr size_t SLAB_BYTES = 64 * 1024;
+
+    struct ClassStats {
+        size_t block_size = 0;
+        size_t allocs = 0;     // 累计分配次数
+        size_t frees = 0;      // 累计释放次数
+        size_t slabs = 0;      // 已申请的 slab 数
+    };
+
+    struct Stats {
+        std::array<ClassStats, CLASS_COUNT> classes{};
+        size_t fallback_allocs = 0; // 走全局 operator new 的分配次数(大对象或退回 malloc 时)
+        size_t fallback_frees = 0;
+
+        [[nodiscard]] size_t live() const {
+            size_t n = fallback_allocs - fallback_frees;
+            for (const auto& c : classes) n += c.allocs - c.frees;
+            return n;
+        }
+        [[nodiscard]] size_t reserved_bytes() const {
+            size_t n = 0;
+            for (const auto& c : classes) n += c.slabs * SLAB_BYTES;
+            return n;
+        }
+    };
+
+    static void* allocate(const size_t size) {
+        auto& cache = local_cache();
+#ifndef KIZ_POOL_USE_MALLOC
+        if (size != 0 and size <= MAX_POOLED_SIZE) {
+            const size_t cls = class_of(size);
+            auto& stats = cache.stats.classes[cls];
+            ++stats.allocs;
+            if (auto node = cache.free_lists[cls]) {
+                cache.free_lists[cls] = node->next;
+                return node;
+            }
+            return refill(cache, cls);
+        }
+#endif
+        ++cache.stats.fallback_allocs;
+        return ::operator new(size);
+    }
+
+    static void deallocate(void* p, const size_t size) noexcept {
+        if (!p) return;
+        auto& cache = local_cache();
+#ifndef KIZ_POOL_USE_MALLOC
+        if (size != 0 and size <= MAX_POOLED_SIZE) {
+            const size_t cls = class_of(size);
+            ++cache.stats.classes[cls].frees;
+            const auto node = static_cast<FreeNode*>(p);
+            node->next = cache.free_lists[cls];
+            cache.free_lists[cls] = node;
+            return;
+        }
+#endif
+        ++cache.stats.fallback_frees;
+        ::operator delete(p);
+    }
+
+    ///| 当前线程的分配统计
+    static const Stats& stats() {
+        return local_cache().stats;
+    }
+
+private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    struct Cache {
+        std::array<FreeNode*, CLASS_COUNT> free_lists{};
+        Stats stats;
+
+        Cache() {
+            for (size_t i = 0; i < CLASS_COUNT; ++i) {
+                stats.classes[i].block_size = (i + 1) * GRANULE;
+            }
+        }
+    };
+
+    static Cache& local_cache() {
+        thread_local Cache cache;
+        return cache;
+    }
+
+    static constexpr size_t class_of(const size_t size) {
+        return (size - 1) / GRANULE;
+    }
+
+    // 申请一个新 slab, 切成本级大小的块: 返回第一块, 其余挂入空闲链表
+    static void* refill(Cache& cache, const size_t cls) {
+        const size_t block = (cls + 1) * GRANULE;
+        const auto slab = static_cast<std::byte*>(::operator new(SLAB_BYTES));
+        ++cache.stats.classes[cls].slabs;
+
+        const size_t count = SLAB_BYTES / block;
+        FreeNode* head = cache.free_lists[cls];
+        for (size_t i = count - 1; i > 0; --i) {
+            const auto node = reinterpret_cast<FreeNode*>(slab + i * block);
+            node->next = head;
+            head = node;
+        }
+        cache.free_lists[cls] = head;
+        return slab;
+    }
+};
+
+} // namespace dep
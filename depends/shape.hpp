@@ -0,0 +1,96 @@
+/**
+ * @file shape.hpp
+ * @brief 隐藏类（Shape）核心定义
+ *  * Shape 描述对象自有属性的布局：属性名（驻留符号）→ 槽位下标，按添加顺序排列；
+ *  * 以相同顺序添加相同属性的对象共享同一个 Shape，属性值只需存放在紧凑的槽位数组中；
+ *  * 添加属性沿转换树走到子 Shape（转换结果会被缓存），删除属性则从根按剩余顺序重建；
+ *  * Shape 全局共享且永不释放，指针可直接作为内联缓存的键。
+ *
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "hashmap.hpp"
+#include "symbol.hpp"
+
+namespace dep {
+
+class Shape {
+    std::vector<Symbol> keys_;           // 按槽位顺序排列的属性名
+    HashMap<uint32_t> index_;            // 属性名 → 槽位下标（属性较少时直接线性比较 id）
+    HashMap<Shape*> transitions_;        // 添加属性名 → 子 Shape
+    std::vector<std::unique_ptr<Shape>> children_;
+
+    Shape() = default;
+
+public:
+    static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+    static constexpr size_t LINEAR_SCAN_MAX = 8;
+
+    Shape(const Shape&) = delete;
+    Shape& operator=(const Shape&) = delete;
+
+    // 空布局，所有转换树的根
+    static Shape* root() {
+        static Shape root_shape;
+        return &root_shape;
+    }
+
+    [[nodiscard]] uint32_t slot_of(const Symbol key) const {
+        if (keys_.size() <= LINEAR_SCAN_MAX) {
+            for (size_t i = 0; i < keys_.size(); ++i) {
+                if (keys_[i] == key) return static_cast<uint32_t>(i);
+            }
+            return NOT_FOUND;
+        }
+        const auto it = index_.find(key.str(), key.hash());
+        return it ? it->value : NOT_FOUND;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return keys_.size();
+    }
+
+    [[nodiscard]] const std::vector<Symbol>& keys() const {
+        return keys_;
+    }
+
+    /**
+     * @brief 添加一个属性后的 Shape（新属性占用末尾槽位）
+     */
+    Shape* with_added(const Symbol key) {
+        if (const auto it = transitions_.find(key.str(), key.hash())) {
+            return it->value;
+        }
+        auto child = std::unique_ptr<Shape>(new Shape());
+        child->keys_ = keys_;
+        child->keys_.push_back(key);
+        child->index_ = index_;
+        child->index_.insert(key.str(), static_cast<uint32_t>(keys_.size()), key.hash());
+
+        Shape* result = child.get();
+        children_.push_back(std::move(child));
+        transitions_.insert(key.str(), result, key.hash());
+        return result;
+    }
+
+    /**
+     * @brief 删除一个属性后的 Shape（其余属性保持原有相对顺序）
+     */
+    [[nodiscard]] Shape* without(const Symbol key) const {
+        Shape* result = root();
+        for (const auto& k : keys_) {
+            if (k != key) result = result->with_added(k);
+        }
+        return result;
+    }
+};
+
+} // namespace dep
@@ -0,0 +1,89 @@
+/**
+ * @file symbol.hpp
+ * @brief 驻留符号（Symbol）核心定义
+ *  * 属性名/方法名在编译期或注册时驻留到全局符号表，得到一个 32 位整数 id；
+ *  * 同名字符串总是得到同一个 id，比较符号只需比较整数；
+ *  * 驻留时预先计算好字符串哈希，查表时直接使用，执行期无需再哈希字符串；
+ *  * 符号表全局共享且永不释放，符号可以随意拷贝。
+ *
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "hashmap.hpp"
+
+namespace dep {
+
+class Symbol {
+    uint32_t id_ = 0;
+
+    struct Entry {
+        std::string name;
+        size_t hash;
+    };
+
+    class Table {
+        HashMap<uint32_t> ids_;
+        std::deque<Entry> entries_; // deque 保证 name 的地址稳定
+
+    public:
+        uint32_t intern(const std::string_view name) {
+            const size_t hash = hash_string(name);
+            if (const auto it = ids_.find(name, hash)) {
+                return it->value;
+            }
+            const auto id = static_cast<uint32_t>(entries_.size());
+            entries_.push_back(Entry{std::string(name), hash});
+            ids_.insert(entries_.back().name, id, hash);
+            return id;
+        }
+
+        [[nodiscard]] const Entry& entry(const uint32_t id) const {
+            return entries_[id];
+        }
+    };
+
+    static Table& table() {
+        static Table symbol_table;
+        return symbol_table;
+    }
+
+    explicit Symbol(const uint32_t id) : id_(id) {}
+
+public:
+    Symbol() = default;
+
+    [[nodiscard]] static Symbol intern(const std::string_view name) {
+        return Symbol(table().intern(name));
+    }
+
+    [[nodiscard]] uint32_t id() const {
+        return id_;
+    }
+
+    [[nodiscard]] const std::string& str() const {
+        return table().entry(id_).name;
+    }
+
+    // 与 hash_string(str()) 相同, 可直接用于字符串键的 HashMap
+    [[nodiscard]] size_t hash() const {
+        return table().entry(id_).hash;
+    }
+
+    bool operator==(const Symbol& other) const {
+        return id_ == other.id_;
+    }
+};
+
+inline Symbol intern(const std::string_view name) {
+    return Symbol::intern(name);
+}
+
+} // namespace dep
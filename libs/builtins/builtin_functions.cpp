@@ -5,39 +5,37 @@
 #include <thread>
 
 #include "../../src/models/models.hpp"
+#include "include/builtin_methods.hpp"
 #include "../depends/u8str.hpp"
 
 namespace builtin {
 
-model::Object* print(model::Object* self, const model::List* args) {
+model::Object* print(model::Object* self, model::Args args) {
     dep::UTF8String text;
-    for (auto arg : args->val) {
+    for (auto arg : args) {
         text += dep::UTF8String(kiz::Vm::obj_to_str(arg)) + " ";
     }
     std::cout << text << std::endl;
     return model::load_nil();
 }
 
-model::Object* input(model::Object* self, const model::List* args) {
-    if (! args->val.empty()) {
-        const auto prompt_obj = get_one_arg(args);
-        std::cout << model::cast_to_str(prompt_obj)->val;
+model::Object* input(model::Object* self, model::Args args) {
+    if (! args.empty()) {
+        std::cout << static_cast<model::String*>(args[0])->val;
     }
     std::string result;
     std::getline(std::cin, result);
     return new model::String(result);
 }
 
-model::Object* ischild(model::Object* self, const model::List* args) {
-    kiz::Vm::assert_argc(2, args);
-
-    const auto a = args->val[0];
-    const auto b = args->val[1];
+model::Object* ischild(model::Object* self, model::Args args) {
+    const auto a = args[0];
+    const auto b = args[1];
     return check_based_object(a, b);
     
 }
 
-model::Object* help(model::Object* self, const model::List* args) {
+model::Object* help(model::Object* self, model::Args args) {
     const std::string text = R"(
 The kiz help
 
@@ -58,6 +56,7 @@ Built-in Functions:
     hasattr(current_only=False, obj, attr_name)
     delattr(obj, attr_name)
     get_refc(obj)
+    alloc_stats()
 
 Built-in Objects:
 ===========================
@@ -79,47 +78,47 @@ Built-in Objects:
     return model::load_nil();
 }
 
-model::Object* breakpoint(model::Object* self, const model::List* args) {
+model::Object* breakpoint(model::Object* self, model::Args args) {
     size_t i = 0;
     for (auto& frame: kiz::Vm::call_stack) {
-        std::cout << "Frame [" << i << "] " << frame->name << "\n";
+        std::cout << "Frame [" << i << "] " << frame.name() << "\n";
         std::cout << "=================================" << "\n";
-        std::cout << "Owner: " << kiz::Vm::obj_to_debug_str(frame->owner) << "\n";
-        std::cout << "Pc: " << frame->pc << "\n";
+        std::cout << "Owner: " << kiz::Vm::obj_to_debug_str(frame.owner) << "\n";
+        std::cout << "Pc: " << frame.pc << "\n";
 
         size_t j = 1;
         std::cout << "Locals: " << "\n";
-        for (const auto& n : frame->code_object->var_names) {
-            auto l = kiz::Vm::op_stack[frame->bp + j - 1];
+        for (const auto& n : frame.code_object->var_names) {
+            auto l = kiz::Vm::op_stack[frame.bp + j - 1];
             std::cout << n << " = " << kiz::Vm::obj_to_debug_str(l);
-            if (j<frame->code_object->var_names.size()) std::cout << ", ";
+            if (j<frame.code_object->var_names.size()) std::cout << ", ";
             ++j;
         }
         
         std::cout << "\n";
         std::cout << "VarNames: ";
         j = 1;
-        for (const auto& n: frame->code_object->var_names) {
+        for (const auto& n: frame.code_object->var_names) {
             std::cout << n;
-            if (j<frame->code_object->var_names.size()) std::cout << ", ";
+            if (j<frame.code_object->var_names.size()) std::cout << ", ";
             ++j;
         }
 
         std::cout << "\n";
         std::cout << "AttrNames: ";
         j = 1;
-        for (const auto& n: frame->code_object->attr_names) {
-            std::cout << n;
-            if (j<frame->code_object->attr_names.size()) std::cout << ", ";
+        for (const auto& n: frame.code_object->attr_names) {
+            std::cout << n.str();
+            if (j<frame.code_object->attr_names.size()) std::cout << ", ";
             ++j;
         }
 
         std::cout << "\n";
         std::cout << "FreeNames: ";
         j = 1;
-        for (const auto& n: frame->code_object->free_names) {
+        for (const auto& n: frame.code_object->free_names) {
             std::cout << n;
-            if (j<frame->code_object->free_names.size()) std::cout << ", ";
+            if (j<frame.code_object->free_names.size()) std::cout << ", ";
             ++j;
         }
 
@@ -147,17 +146,15 @@ model::Object* breakpoint(model::Object* self, const model::List* args) {
     throw KizStopRunningSignal();
 }
 
-model::Object* cmd(model::Object* self, const model::List* args) {
-    auto arg_vector = args->val;
-    if (arg_vector.empty()) {
+model::Object* cmd(model::Object* self, model::Args args) {
+    if (args.empty()) {
         return model::load_nil();
     }
-    auto instruction = arg_vector[0];
-    std::system(model::cast_to_str(instruction)->val.c_str());
+    std::system(static_cast<model::String*>(args[0])->val.c_str());
     return model::load_nil();
 }
 
-model::Object* now(model::Object* self, const model::List* args) {
+model::Object* now(model::Object* self, model::Args args) {
     auto now =
         std::chrono::high_resolution_clock::now()
         .time_since_epoch();
@@ -165,216 +162,157 @@ model::Object* now(model::Object* self, const model::List* args) {
     return new model::Int( dep::BigInt(std::to_string(time)) );
 }
 
-model::Object* range(model::Object* self, const model::List* args) {
-    auto arg_vector = args->val;
-    std::vector<model::Object*> range_vector;
-    dep::BigInt start_int = 0;
-    dep::BigInt step_int = 1;
-    dep::BigInt end_int = 1;
-
-    if (arg_vector.size() == 1) {
-        auto end_obj = arg_vector[0];
-        auto end_int_obj = model::cast_to_int(end_obj);
-        end_int = end_int_obj->val;
-    }
-    else if (arg_vector.size() == 2) {
-        auto start_obj = arg_vector[0];
-        auto start_int_obj = model::cast_to_int(start_obj);
-        start_int = start_int_obj->val;
-
-        auto end_obj = arg_vector[1];
-        auto end_int_obj = model::cast_to_int(end_obj);
-        end_int = end_int_obj->val;
-    }
-    else if (arg_vector.size() == 3) {
-        auto start_obj = arg_vector[0];
-        auto start_int_obj = model::cast_to_int(start_obj);
-        start_int = start_int_obj->val;
-
-        auto step_obj = arg_vector[1];
-        auto step_int_obj = model::cast_to_int(step_obj);
-        step_int = step_int_obj->val;
-
-        auto end_obj = arg_vector[2];
-        auto end_int_obj = model::cast_to_int(end_obj);
-        end_int = end_int_obj->val;
-    } else kiz::Vm::assert_argc({1,2,3}, args);
-
-    for (dep::BigInt i = start_int; i < end_int; i+=step_int) {
-        auto i_obj = new model::Int(i);
-        range_vector.emplace_back(i_obj);
-    }
-    return new model::List(range_vector);
+model::Object* range(model::Object* self, model::Args args) {
+    // 与Range(...)相同, 返回惰性区间而非预先生成的列表
+    return model::range_call(model::based_range, args);
 }
 
-model::Object* setattr(model::Object* self, const model::List* args) {
-    const auto arg_vector = args->val;
-    kiz::Vm::assert_argc(3, args);
-    auto for_set = arg_vector[0];
-    auto attr_name = arg_vector[1];
-    auto value = arg_vector[2];
-    for_set->attrs_insert(model::cast_to_str(attr_name)->val, value);
+model::Object* setattr(model::Object* self, model::Args args) {
+    auto for_set = args[0];
+    auto attr_name = static_cast<model::String*>(args[1]);
+    auto value = args[2];
+    for_set->attrs_insert(attr_name->val, value);
     return model::load_nil();
 }
 
-model::Object* getattr(model::Object* self, const model::List* args) {
-    auto arg_vector = args->val;
+model::Object* getattr(model::Object* self, model::Args args) {
+    auto arg_vector = args;
     model::Object* obj;
     model::Object* attr_name;
     model::Object* default_value =  model::load_nil();
-    if (arg_vector.size() == 2 or arg_vector.size() == 3) {
+    if (arg_vector.size() != 4) {
         obj = arg_vector[0];
         attr_name = arg_vector[1];
         if (arg_vector.size() == 3) {
             default_value = arg_vector[2];
         }
-        try {
-            return kiz::Vm::get_attr(obj, model::cast_to_str(attr_name)->val);
-        } catch (...) {
-            return default_value;
-        }
+        const auto name_str = model::cast_to_str(attr_name);
+        if (!name_str) return nullptr;
+        const auto value = kiz::Vm::try_get_attr(obj, dep::intern(name_str->val));
+        return value ? value : default_value;
     }
-    if (arg_vector.size() == 4) {
-        model::Object* current_only = arg_vector[0];
-        obj = arg_vector[1];
-        attr_name = arg_vector[2];
-        default_value = arg_vector[3];
-        if (kiz::Vm::is_true(current_only)) {
-            if (const auto value =
-                obj->attrs.find(model::cast_to_str(attr_name)->val)
-            ) return value->value;
-            return default_value;
-        }
-
-        try {
-            return kiz::Vm::get_attr(obj, model::cast_to_str(attr_name)->val);
-        } catch (...) {
-            return default_value;
-        }
-
+    model::Object* current_only = arg_vector[0];
+    obj = arg_vector[1];
+    attr_name = arg_vector[2];
+    default_value = arg_vector[3];
+    const auto name_str = model::cast_to_str(attr_name);
+    if (!name_str) return nullptr;
+    if (kiz::Vm::is_true(current_only)) {
+        if (const auto value = obj->find_attr(name_str->val)) return value;
+        return default_value;
     }
-    kiz::Vm::assert_argc({2,3,4}, args);
-}
 
-model::Object* delattr(model::Object* self, const model::List* args) {
-    kiz::Vm::assert_argc(2, args);
-    auto arg_vector = args->val;
+    const auto value = kiz::Vm::try_get_attr(obj, dep::intern(name_str->val));
+    return value ? value : default_value;
+}
 
-    model::Object* obj = arg_vector[0];
-    model::Object* attr_name = arg_vector[1];
-    obj->attrs.del(model::cast_to_str(attr_name)->val);
+model::Object* delattr(model::Object* self, model::Args args) {
+    model::Object* obj = args[0];
+    const auto attr_name = static_cast<model::String*>(args[1]);
+    obj->attrs_del(attr_name->val);
     return model::load_nil();
 }
 
-model::Object* hasattr(model::Object* self, const model::List* args) {
-    auto arg_vector = args->val;
+model::Object* hasattr(model::Object* self, model::Args args) {
+    auto arg_vector = args;
     model::Object* obj;
     model::Object* attr_name;
     if (arg_vector.size() == 2) {
         obj = arg_vector[0];
         attr_name = arg_vector[1];
 
-        try {
-            kiz::Vm::get_attr(obj, model::cast_to_str(attr_name)->val);
-            return model::load_true();
-        } catch (...) {
-            return model::load_false();
-        }
+        const auto name_str = model::cast_to_str(attr_name);
+        if (!name_str) return nullptr;
+        return model::load_bool(kiz::Vm::try_get_attr(obj, dep::intern(name_str->val)) != nullptr);
     }
-    if (arg_vector.size() == 3) {
-        model::Object* current_only = arg_vector[0];
-        obj = arg_vector[1];
-        attr_name = arg_vector[2];
-        if (kiz::Vm::is_true(current_only)) {
-            if (const auto value =
-                obj->attrs.find(model::cast_to_str(attr_name)->val)
-            ) return model::load_true();
-            return model::load_false();
-        }
-        try {
-            kiz::Vm::get_attr(obj, model::cast_to_str(attr_name)->val);
-            return model::load_true();
-        } catch (...) {
-            return model::load_false();
-        }
+    model::Object* current_only = arg_vector[0];
+    obj = arg_vector[1];
+    attr_name = arg_vector[2];
+    const auto name_str = model::cast_to_str(attr_name);
+    if (!name_str) return nullptr;
+    if (kiz::Vm::is_true(current_only)) {
+        if (const auto value = obj->find_attr(name_str->val)) return model::load_true();
+        return model::load_false();
     }
-    kiz::Vm::assert_argc({2,3}, args);
+    return model::load_bool(kiz::Vm::try_get_attr(obj, dep::intern(name_str->val)) != nullptr);
 }
 
-model::Object* get_refc(model::Object* self, const model::List* args) {
-    const auto obj = get_one_arg(args);
-    return new model::Int( obj->get_refc_() );
+model::Object* get_refc(model::Object* self, model::Args args) {
+    return new model::Int( args[0]->get_refc_() );
 }
 
-model::Object* create(model::Object* self, const model::List* args) {
-    if (args->val.empty()) {
+model::Object* create(model::Object* self, model::Args args) {
+    if (args.empty()) {
         auto o = new model::Object();
 
-        o->attrs_insert("__parent__", model::based_obj);
+        o->set_parent(model::based_obj);
+        kiz::Gc::track(o);
 
         return o;
     }
-    const auto obj = get_one_arg(args);
+    const auto obj = args[0];
     if (obj->get_type() != model::Object::ObjectType::Object) {
-        throw NativeFuncError("TypeError", "Cannot create object from a instance of a native type");
+        return kiz::Vm::raise("TypeError", "Cannot create object from a instance of a native type");
     }
     const auto new_obj = new model::Object();
 
-    new_obj->attrs_insert("__parent__", obj);
+    new_obj->set_parent(obj);
+    kiz::Gc::track(new_obj);
 
     return new_obj;
 }
 
-model::Object* type_of_obj(model::Object* self, const model::List* args) {
-    const auto for_check = get_one_arg(args);
-    std::string type_str;
-    switch (for_check->get_type()) {
-        case model::Object::ObjectType::Bool: type_str = "Bool"; break;
-        case model::Object::ObjectType::Int: type_str = "Int"; break;
-        case model::Object::ObjectType::String: type_str = "Str"; break;
-        case model::Object::ObjectType::Object: type_str = "Object"; break;
-        case model::Object::ObjectType::Nil: type_str = "Nil"; break;
-        case model::Object::ObjectType::Error: type_str = "Error"; break;
-        case model::Object::ObjectType::Function: type_str = "Func"; break;
-        case model::Object::ObjectType::List: type_str = "List"; break;
-        case model::Object::ObjectType::Dictionary: type_str = "Dict"; break;
-        case model::Object::ObjectType::Decimal: type_str = "Decimal"; break;
-        case model::Object::ObjectType::CodeObject: type_str = "__CodeObject"; break;
-        case model::Object::ObjectType::NativeFunction: type_str = "NFunc"; break;
-        case model::Object::ObjectType::Module: type_str = "Module"; break;
-        default: type_str = "<Unknown>"; break;
-    }
-    return new model::String(type_str);
+model::Object* type_of_obj(model::Object* self, model::Args args) {
+    return new model::String(model::type_name(args[0]->get_type()));
 }
 
-model::Object* debug_str(model::Object* self, const model::List* args) {
-    auto for_check = get_one_arg(args);
-    auto debug_str = kiz::Vm::obj_to_debug_str(for_check);
+model::Object* debug_str(model::Object* self, model::Args args) {
+    auto debug_str = kiz::Vm::obj_to_debug_str(args[0]);
     return new model::String(debug_str);
 }
 
-model::Object* attr(model::Object* self, const model::List* args) {
-    auto obj = get_one_arg(args);
-    std::vector<std::pair<dep::BigInt, std::pair<model::Object*, model::Object*>>> elem_list;
-    for (auto& [name, obj]: obj->attrs.to_vector()) {
-        obj->make_ref();
+model::Object* attr(model::Object* self, model::Args args) {
+    auto obj = args[0];
+    std::vector<std::pair<size_t, std::pair<model::Object*, model::Object*>>> elem_list;
+    for (auto& [name, obj]: obj->attrs_to_vector()) {
         elem_list.emplace_back(dep::hash_string(name),
             std::pair {new model::String(name), obj}
         );
     }
-    return new model::Dictionary(dep::Dict(elem_list));
+    return new model::Dictionary(model::DictStore(elem_list));
+}
+
+model::Object* alloc_stats(model::Object* self, model::Args args) {
+    const auto stats = dep::ObjectPool::stats(); // 拷贝快照, 下面构造结果时还会继续分配
+    size_t allocs = stats.fallback_allocs;
+    size_t frees = stats.fallback_frees;
+    for (const auto& c : stats.classes) {
+        allocs += c.allocs;
+        frees += c.frees;
+    }
+    std::vector<std::pair<size_t, std::pair<model::Object*, model::Object*>>> elem_list;
+    auto insert = [&](const std::string& name, const size_t value) {
+        elem_list.emplace_back(dep::hash_string(name),
+            std::pair {new model::String(name), new model::Int(value)}
+        );
+    };
+    insert("allocs", allocs);
+    insert("frees", frees);
+    insert("live", stats.live());
+    insert("fallback_allocs", stats.fallback_allocs);
+    insert("reserved_bytes", stats.reserved_bytes());
+    return new model::Dictionary(model::DictStore(elem_list));
 }
 
-model::Object* sleep(model::Object* self, const model::List* args) {
-    auto time = model::cast_to_int(get_one_arg(args)) ->val.to_unsigned_long_long();
+model::Object* sleep(model::Object* self, model::Args args) {
+    auto time = static_cast<model::Int*>(args[0])->val.to_unsigned_long_long();
     std::this_thread::sleep_for(std::chrono::milliseconds(time));
     return model::load_nil();
 }
 
-model::Object* open(model::Object* self, const model::List* args) {
-    kiz::Vm::assert_argc(2, args);
-    auto path = cast_to_str(args->val[0])->val;
-    auto mode = cast_to_str(args->val[1])->val;
+model::Object* open(model::Object* self, model::Args args) {
+    auto path = static_cast<model::String*>(args[0])->val;
+    auto mode = static_cast<model::String*>(args[1])->val;
 
     auto real_path = kiz::Vm::get_exe_abs_dir() / kiz::Vm::get_current_file_path().parent_path() / path;
 
@@ -383,7 +321,7 @@ model::Object* open(model::Object* self, const model::List* args) {
     if (mode == "r") {
         open_mode = std::ios_base::in;
         if (!std::filesystem::is_regular_file(real_path)) {
-            throw NativeFuncError("PathError", "File not found: " + real_path.string());
+            return kiz::Vm::raise("PathError", "File not found: " + real_path.string());
         }
     } else if (mode == "w") {
         open_mode = std::ios_base::out | std::ios_base::trunc;
@@ -392,12 +330,12 @@ model::Object* open(model::Object* self, const model::List* args) {
     } else if (mode == "r+") {
         open_mode = std::ios_base::in | std::ios_base::out;
         if (!std::filesystem::is_regular_file(real_path)) {
-            throw NativeFuncError("PathError", "File not found: " + real_path.string());
+            return kiz::Vm::raise("PathError", "File not found: " + real_path.string());
         }
     } else if (mode == "w+") {
         open_mode = std::ios_base::in | std::ios_base::out | std::ios_base::trunc;
     } else {
-        throw NativeFuncError("ModeError", "Invalid file mode: " + mode);
+        return kiz::Vm::raise("ModeError", "Invalid file mode: " + mode);
     }
 
     auto file_stream = new std::fstream();
@@ -405,11 +343,11 @@ model::Object* open(model::Object* self, const model::List* args) {
 
     if (!file_stream->is_open()) {
         delete file_stream;
-        throw NativeFuncError("FileOpenError", "Failed to open file: " + real_path.string());
+        return kiz::Vm::raise("FileOpenError", "Failed to open file: " + real_path.string());
     }
 
     auto fh_obj = new model::FileHandle();
-    fh_obj->attrs_insert("__parent__", model::based_file_handle);
+    fh_obj->set_parent(model::based_file_handle);
     fh_obj->attrs_insert("mode", new model::String(mode));
     fh_obj->attrs_insert("path", new model::String(real_path.string()));
     fh_obj->file_handle = file_stream; // 核心：存储文件句柄
@@ -418,26 +356,22 @@ model::Object* open(model::Object* self, const model::List* args) {
 }
 
 
-model::Object* assert_(model::Object* self, const model::List* args) {
-    auto args_vec = args->val;
+model::Object* assert_(model::Object* self, model::Args args) {
+    if (kiz::Vm::is_true(args[0])) {
+        return model::load_nil();
+    }
     std::string msg = "...";
-    if (args_vec.size() == 1) {
-        if (kiz::Vm::is_true(args_vec[0])) {
-            return model::load_nil();
-        }
+    if (args.size() == 2) {
+        const auto msg_str = model::cast_to_str(args[1]);
+        if (!msg_str) return nullptr;
+        msg = msg_str->val;
     }
-    else if (args_vec.size() == 2) {
-        if (kiz::Vm::is_true(args_vec[0])) {
-            return model::load_nil();
-        }
-        msg = model::cast_to_str(args_vec[1]) ->val;
-    } else kiz::Vm::assert_argc({1,2}, args);
 
-    throw NativeFuncError("Assert", msg);
+    return kiz::Vm::raise("Assert", msg);
 }
 
-model::Object* panic(model::Object* self, const model::List* args) {
-    std::string msg = model::cast_to_str(args->val[0]) ->val;
+model::Object* panic(model::Object* self, model::Args args) {
+    std::string msg = static_cast<model::String*>(args[0])->val;
     std::cout << Color::BRIGHT_RED << "A Panic! : " << Color::RESET << msg << std::endl;
     exit(3);
 }
@@ -1,7 +1,7 @@
 #include "include/builtins_lib.hpp"
 
 namespace builtins_lib {
-model::Object* init_module(model::Object* self, const model::List* args) {
+model::Object* init_module(model::Object* self, model::Args args) {
     auto mod = new model::Module("builtins_lib");
 
     for (size_t i = 0; i < kiz::Vm::builtin_names.size(); ++i) {
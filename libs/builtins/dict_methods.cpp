@@ -3,29 +3,14 @@
 
 namespace model {
 
-dep::BigInt hash_object(Object* key_obj) {
-    // hash对象
-    kiz::Vm::call_method(key_obj, "__hash__", {});
-
-    const auto result = kiz::Vm::get_and_pop_stack_top();
-
-    const auto result_int = dynamic_cast<Int*>(result.get());
-    if (!result_int)
-        throw NativeFuncError("TypeError", "Object's hash method return a value which type isn't Int");
-    dep::BigInt key_hash_val = result_int->val;
-    return key_hash_val;
-}
-
 // Dictionary.__add__
-Object* dict_add(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-    
-    auto self_dict = dynamic_cast<Dictionary*>(self);
+Object* dict_add(Object* self, Object* other) {
+    auto self_dict = self->as<model::Dictionary>();
     assert(self_dict != nullptr);
     
-    auto another_dict = dynamic_cast<Dictionary*>(args->val[0]);
+    auto another_dict = other->as<model::Dictionary>();
     if (! another_dict)
-        throw NativeFuncError("TypeError", "Dict.add first argument must be Dict type");
+        return kiz::Vm::raise("TypeError", "Dict.add first argument must be Dict type");
 
     auto self_dict_to_vec = self_dict->val.to_vector();
     auto another_dict_to_vec = another_dict->val.to_vector();
@@ -36,7 +21,7 @@ Object* dict_add(Object* self, const List* args) {
         another_dict_to_vec.end()
     );
     
-    auto new_dict = new Dictionary(dep::Dict(
+    auto new_dict = new Dictionary(DictStore(
         self_dict_to_vec
     ));
     new_dict->make_ref();
@@ -45,19 +30,15 @@ Object* dict_add(Object* self, const List* args) {
 };
 
 // Dictionary.contains：判断是否包含指定键（key: String），返回Bool
-Object* dict_contains(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-    
-    auto self_dict = dynamic_cast<Dictionary*>(self);
+Object* dict_contains(Object* self, Args args) {
+    auto self_dict = self->as<model::Dictionary>();
     assert(self_dict != nullptr);
     
     // 键
-    auto key_obj = args->val[0];
-    dep::BigInt key_hash_val = hash_object(key_obj);
-
-    auto found_pair_it = self_dict->val.find(
-        key_hash_val
-    );
+    auto key_obj = args[0];
+    const size_t key_hash = dict_key_hash(key_obj);
+    if (kiz::Vm::error_pending) return nullptr;
+    auto found_pair_it = self_dict->val.find(key_hash, key_obj);
 
     if (found_pair_it) {
         return load_true();
@@ -65,105 +46,146 @@ Object* dict_contains(Object* self, const List* args) {
     return load_false();
 };
 
-Object* dict_setitem(Object* self, const List* args) {
-    kiz::Vm::assert_argc(2, args);
-    auto self_dict = dynamic_cast<Dictionary*>(self);
-    auto key_obj = args->val[0];
-    auto value_obj = args->val[1];
-    dep::BigInt key_hash_val = hash_object(key_obj);
-
-    self_dict->val.insert(
-        key_hash_val,
+Object* dict_setitem(Object* self, Object* key, Object* value) {
+    auto self_dict = self->as<model::Dictionary>();
+    auto key_obj = key;
+    auto value_obj = value;
+    const size_t key_hash = dict_key_hash(key_obj);
+    if (kiz::Vm::error_pending) return nullptr;
+
+    key_obj->make_ref();
+    value_obj->make_ref();
+    auto [old_key, old_value] = self_dict->val.mut().insert(
+        key_hash,
         std::pair{key_obj, value_obj}
     );
+    // 覆盖已有键时释放旧的键值
+    if (old_key) old_key->del_ref();
+    if (old_value) old_value->del_ref();
     return load_nil();
 }
 
-Object* dict_getitem(Object* self, const List* args) {
-    auto self_dict = dynamic_cast<Dictionary*>(self);
-    auto key_obj = builtin::get_one_arg(args);
+Object* dict_getitem(Object* self, Object* other) {
+    auto self_dict = self->as<model::Dictionary>();
+    auto key_obj = other;
 
-    dep::BigInt key_hash_val = hash_object(key_obj);
+    const size_t key_hash = dict_key_hash(key_obj);
+    if (kiz::Vm::error_pending) return nullptr;
 
-    auto found_pair_it = self_dict->val.find(key_hash_val);
+    auto found_pair_it = self_dict->val.find(key_hash, key_obj);
     if (found_pair_it) {
         return found_pair_it->value.second;
     }
 
-    throw NativeFuncError("KeyError",
+    return kiz::Vm::raise("KeyError",
             "Undefined key " + key_obj->debug_string() + " in Dictionary object " + self->debug_string()
     );
 }
 
 
-Object* dict_str(Object* self, const List* args) {
-    auto self_dict = dynamic_cast<Dictionary*>(self);
+Object* dict_str(Object* self) {
+    auto self_dict = self->as<model::Dictionary>();
     std::string result = "{";
-    auto kv_list = self_dict->val.to_vector();
-    size_t i = 0;
-    for (auto& kv_pair : kv_list | std::views::values) {
-        result += kiz::Vm::obj_to_str(kv_pair.first) + ": " + kiz::Vm::obj_to_str(kv_pair.second);
-        if (i != kv_list.size() - 1) {
+    // __str__ 可能执行用户代码，按下标访问而非持有条目引用
+    for (size_t i = 0; i < self_dict->val.size(); ++i) {
+        const auto [key, value] = self_dict->val.entries()[i].value;
+        if (i != 0) {
             result += ", ";
         }
-        ++i;
+        result += kiz::Vm::obj_to_str(key) + ": " + kiz::Vm::obj_to_str(value);
     }
     result += "}";
     return new String(result);
 }
 
-Object* dict_dstr(Object* self, const List* args) {
-    auto self_dict = dynamic_cast<Dictionary*>(self);
+Object* dict_dstr(Object* self, Args args) {
+    auto self_dict = self->as<model::Dictionary>();
     std::string result = "{";
-    auto kv_list = self_dict->val.to_vector();
-    size_t i = 0;
-    for (auto& kv_pair : kv_list | std::views::values) {
-        result += kiz::Vm::obj_to_debug_str(kv_pair.first) + ": " + kiz::Vm::obj_to_debug_str(kv_pair.second);
-        if (i != kv_list.size() - 1) {
+    for (size_t i = 0; i < self_dict->val.size(); ++i) {
+        const auto [key, value] = self_dict->val.entries()[i].value;
+        if (i != 0) {
             result += ", ";
         }
-        ++i;
+        result += kiz::Vm::obj_to_debug_str(key) + ": " + kiz::Vm::obj_to_debug_str(value);
     }
     result += "}";
     return new String(result);
 }
 
-Object* dict_foreach(Object* self, const List* args) {
-    auto func_obj = builtin::get_one_arg(args);
+Object* dict_foreach(Object* self, Args args) {
+    auto func_obj = args[0];
 
-    auto self_dict = dynamic_cast<Dictionary*>(self);
+    auto self_dict = self->as<model::Dictionary>();
     assert(self_dict != nullptr);
 
-    dep::BigInt idx = 0;
-    for (auto pair : self_dict->val.to_vector() | std::views::values) {
-        kiz::Vm::call_function(func_obj, {pair.first, pair.second}, nullptr);
-        idx += 1;
+    // 回调可能修改字典，每步按下标重新取条目
+    for (size_t i = 0; i < self_dict->val.size(); ++i) {
+        const auto [key, value] = self_dict->val.entries()[i].value;
+        Object* argv[] = {key, value};
+        kiz::Vm::call_function(func_obj, argv, nullptr);
     }
     return load_nil();
 }
 
-Object* dict_next(Object* self, const List* args) {
-    auto curr_idx_it = self->attrs.find("__current_index__");
-    if(!curr_idx_it)
-        throw NativeFuncError("TypeError", "Dict.next cannot find attribute '__current_index__' to get current item");
-
-    auto curr_idx = curr_idx_it->value;
-
-    auto index =  cast_to_int(curr_idx) ->val.to_unsigned_long_long();
+Object* dict_next(Object* self) {
+    auto self_dict = self->as<model::Dictionary>();
+    assert(self_dict != nullptr);
 
-    auto self_dict = dynamic_cast<Dictionary*>(self);
-    if (index < self_dict->val.size()) {
-        auto res = self_dict->val.to_vector()[index].second.second;
-        self->attrs_insert("__current_index__", new Int(index+1));
-        return res;
+    if (self_dict->next_cursor < self_dict->val.size()) {
+        return self_dict->val.entries()[self_dict->next_cursor++].value.second;
     }
-    self->attrs_insert("__current_index__", kiz::Vm::small_int_pool[0]);
+    self_dict->next_cursor = 0;
     return load_stop_iter_signal();
 }
 
-Object* dict_len(Object* self, const List* args) {
-    auto self_dict = dynamic_cast<Dictionary*>(self);
-    return new Int(self_dict->val.to_vector().size());
+// Dict.__iter__: for 循环按插入顺序遍历值
+Object* dict_iter(Object* self, Args args) {
+    auto self_dict = self->as<model::Dictionary>();
+    assert(self_dict != nullptr);
+    return new DictIterator(self_dict, DictIterator::Kind::Values);
+}
+
+Object* dict_len(Object* self) {
+    auto self_dict = self->as<model::Dictionary>();
+    return new Int(self_dict->val.size());
+}
+
+Object* dict_keys(Object* self, Args args) {
+    auto self_dict = self->as<model::Dictionary>();
+    assert(self_dict != nullptr);
+    return new DictIterator(self_dict, DictIterator::Kind::Keys);
+}
+
+Object* dict_values(Object* self, Args args) {
+    auto self_dict = self->as<model::Dictionary>();
+    assert(self_dict != nullptr);
+    return new DictIterator(self_dict, DictIterator::Kind::Values);
+}
+
+Object* dict_items(Object* self, Args args) {
+    auto self_dict = self->as<model::Dictionary>();
+    assert(self_dict != nullptr);
+    return new DictIterator(self_dict, DictIterator::Kind::Items);
+}
+
+Object* DictIterator::next() {
+    const auto& store = dict->val;
+    if (store.size() != expected_size)
+        return kiz::Vm::raise("RuntimeError", "Dict changed size during iteration");
+    if (cursor >= store.size()) {
+        return load_stop_iter_signal();
+    }
+
+    const auto [key, value] = store.entries()[cursor++].value;
+    switch (view) {
+    case Kind::Keys:
+        return key;
+    case Kind::Values:
+        return value;
+    case Kind::Items:
+        return new List({key, value});
+    }
+    return load_nil();
 }
 
 }  // namespace model
\ No newline at end of file
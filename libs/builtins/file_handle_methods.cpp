@@ -2,38 +2,35 @@
 
 namespace model {
 
-Object* file_handle_flush(Object* self, const List* args) {
-    kiz::Vm::assert_argc(0, args);
-
-    auto f_obj = dynamic_cast<FileHandle*>(self);
+Object* file_handle_flush(Object* self, Args args) {
+    auto f_obj = self->as<model::FileHandle>();
     assert(f_obj);
 
     if (f_obj->is_closed) {
-        throw NativeFuncError("FileError", "Cannot flush closed file handle");
+        return kiz::Vm::raise("FileError", "Cannot flush closed file handle");
     }
     if (!f_obj->file_handle || !f_obj->file_handle->good()) {
-        throw NativeFuncError("FileError", "Invalid or corrupted file handle");
+        return kiz::Vm::raise("FileError", "Invalid or corrupted file handle");
     }
 
     f_obj->file_handle->flush();
 
     if (f_obj->file_handle->bad()) {
-        throw NativeFuncError("FileError", "Flush failed due to stream error");
+        return kiz::Vm::raise("FileError", "Flush failed due to stream error");
     }
 
     return load_nil();
 }
 
-Object* file_handle_read(Object* self, const List* args) {
-    kiz::Vm::assert_argc(0, args);
-    auto f_obj = dynamic_cast<FileHandle*>(self);
+Object* file_handle_read(Object* self, Args args) {
+    auto f_obj = self->as<model::FileHandle>();
     assert(f_obj);
 
     if (f_obj->is_closed) {
-        throw NativeFuncError("FileError", "Cannot read from closed file handle");
+        return kiz::Vm::raise("FileError", "Cannot read from closed file handle");
     }
     if (!f_obj->file_handle || !f_obj->file_handle->good()) {
-        throw NativeFuncError("FileError", "Invalid or corrupted file handle");
+        return kiz::Vm::raise("FileError", "Invalid or corrupted file handle");
     }
 
     // 清除 EOF 等错误状态，并将读指针移至文件开头
@@ -46,28 +43,26 @@ Object* file_handle_read(Object* self, const List* args) {
 
     // 检查读取是否成功（可选）
     if (f_obj->file_handle->fail() && !f_obj->file_handle->eof()) {
-        throw NativeFuncError("FileError", "Read failed");
+        return kiz::Vm::raise("FileError", "Read failed");
     }
     return new String(oss.str());
 }
 
-Object* file_handle_write(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-
+Object* file_handle_write(Object* self, Args args) {
     // 类型转换并校验
-    auto f_obj = dynamic_cast<FileHandle*>(self);
+    auto f_obj = self->as<model::FileHandle>();
     assert(f_obj);
 
     // 校验文件句柄状态
     if (f_obj->is_closed) {
-        throw NativeFuncError("FileError", "Cannot write to closed file handle");
+        return kiz::Vm::raise("FileError", "Cannot write to closed file handle");
     }
     if (!f_obj->file_handle || !f_obj->file_handle->good()) {
-        throw NativeFuncError("FileError", "Invalid or corrupted file handle");
+        return kiz::Vm::raise("FileError", "Invalid or corrupted file handle");
     }
 
     // 提取要写入的字符串内容
-    std::string content = kiz::Vm::obj_to_str(args->val[0]);
+    std::string content = kiz::Vm::obj_to_str(args[0]);
 
     // 写入内容并刷新缓冲区
     *f_obj->file_handle << content;
@@ -77,22 +72,18 @@ Object* file_handle_write(Object* self, const List* args) {
     return load_nil();
 }
 
-Object* file_handle_readline(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-
-    auto f_obj = dynamic_cast<FileHandle*>(self);
+Object* file_handle_readline(Object* self, Args args) {
+    auto f_obj = self->as<model::FileHandle>();
     assert(f_obj);
 
     if (f_obj->is_closed) {
-        throw NativeFuncError("FileError", "Cannot read from closed file handle");
+        return kiz::Vm::raise("FileError", "Cannot read from closed file handle");
     }
     if (!f_obj->file_handle || !f_obj->file_handle->good()) {
-        throw NativeFuncError("FileError", "Invalid or corrupted file handle");
+        return kiz::Vm::raise("FileError", "Invalid or corrupted file handle");
     }
 
-    // 安全转换参数
-    auto lineno_obj = cast_to_int(args->val[0]);
-    size_t lineno = lineno_obj->val.to_unsigned_long_long();
+    size_t lineno = static_cast<Int*>(args[0])->val.to_unsigned_long_long();
 
     std::string target_line;
     std::string current_line;
@@ -116,11 +107,9 @@ Object* file_handle_readline(Object* self, const List* args) {
     return new String(target_line);
 }
 
-Object* file_handle_close(Object* self, const List* args) {
-    kiz::Vm::assert_argc(0, args);
-
+Object* file_handle_close(Object* self, Args args) {
     // 类型转换并校验
-    auto f_obj = dynamic_cast<FileHandle*>(self);
+    auto f_obj = self->as<model::FileHandle>();
     assert(f_obj);
 
     if (f_obj->is_closed) {
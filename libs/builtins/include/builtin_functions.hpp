@@ -5,13 +5,6 @@
 
 namespace builtin {
 
-inline model::Object* get_one_arg(const model::List* args) {
-    if (!args->val.empty()) {
-        return args->val[0];
-    }
-    kiz::Vm::assert_argc(1, args);
-}
-
 inline model::Object* check_based_object_inner(
     model::Object* src_obj,
     model::Object* for_check_obj,
@@ -23,13 +16,13 @@ inline model::Object* check_based_object_inner(
     visited.insert(src_obj);
 
     // 查找__parent__属性
-    const auto it = src_obj->attrs.find("__parent__");
-    if (it == nullptr) {
+    const auto parent = src_obj->get_parent();
+    if (parent == nullptr) {
         return  model::load_false();
     }
     // 找到目标返回true，否则递归检查父对象
-    if (it->value == for_check_obj) return  model::load_true();
-    return check_based_object_inner(it->value, for_check_obj, visited);
+    if (parent == for_check_obj) return  model::load_true();
+    return check_based_object_inner(parent, for_check_obj, visited);
 }
 
 // 对外接口
@@ -39,26 +32,27 @@ inline model::Object* check_based_object(model::Object* src_obj, model::Object*
 }
 
 // 内置函数
-model::Object* print(model::Object* self, const model::List* args);
-model::Object* input(model::Object* self, const model::List* args);
-model::Object* ischild(model::Object* self, const model::List* args);
-model::Object* help(model::Object* self, const model::List* args);
-model::Object* breakpoint(model::Object* self, const model::List* args);
-model::Object* range(model::Object* self, const model::List* args);
-model::Object* cmd(model::Object* self, const model::List* args);
-model::Object* now(model::Object* self, const model::List* args);
-model::Object* setattr(model::Object* self, const model::List* args);
-model::Object* getattr(model::Object* self, const model::List* args);
-model::Object* delattr(model::Object* self, const model::List* args);
-model::Object* hasattr(model::Object* self, const model::List* args);
-model::Object* get_refc(model::Object* self, const model::List* args);
-model::Object* create(model::Object* self, const model::List* args);
-model::Object* type_of_obj(model::Object* self, const model::List* args);
-model::Object* debug_str(model::Object* self, const model::List* args);
-model::Object* attr(model::Object* self, const model::List* args);
-model::Object* sleep(model::Object* self, const model::List* args);
-model::Object* open(model::Object* self, const model::List* args);
-model::Object* assert_(model::Object* self, const model::List* args);
-model::Object* panic(model::Object* self, const model::List* args);
+model::Object* print(model::Object* self, model::Args args);
+model::Object* input(model::Object* self, model::Args args);
+model::Object* ischild(model::Object* self, model::Args args);
+model::Object* help(model::Object* self, model::Args args);
+model::Object* breakpoint(model::Object* self, model::Args args);
+model::Object* range(model::Object* self, model::Args args);
+model::Object* cmd(model::Object* self, model::Args args);
+model::Object* now(model::Object* self, model::Args args);
+model::Object* setattr(model::Object* self, model::Args args);
+model::Object* getattr(model::Object* self, model::Args args);
+model::Object* delattr(model::Object* self, model::Args args);
+model::Object* hasattr(model::Object* self, model::Args args);
+model::Object* get_refc(model::Object* self, model::Args args);
+model::Object* create(model::Object* self, model::Args args);
+model::Object* type_of_obj(model::Object* self, model::Args args);
+model::Object* debug_str(model::Object* self, model::Args args);
+model::Object* attr(model::Object* self, model::Args args);
+model::Object* alloc_stats(model::Object* self, model::Args args);
+model::Object* sleep(model::Object* self, model::Args args);
+model::Object* open(model::Object* self, model::Args args);
+model::Object* assert_(model::Object* self, model::Args args);
+model::Object* panic(model::Object* self, model::Args args);
 
 }
\ No newline at end of file
@@ -1,147 +1,172 @@
 #pragma once
 #include <functional>
+#include <type_traits>
 
 #include "../../../src/models/models.hpp"
 
 namespace model {
 
+// 槽位函数的 kiz 可见包装(__add__ 等属性): 参数个数已由注册时的签名校验, 直接转发到槽位函数
+template <auto F>
+Object* slot_method(Object* self, Args args) {
+    if constexpr (std::is_same_v<decltype(F), TypeSlots::Unary>) {
+        return F(self);
+    } else if constexpr (std::is_same_v<decltype(F), TypeSlots::Binary>) {
+        return F(self, args[0]);
+    } else {
+        static_assert(std::is_same_v<decltype(F), TypeSlots::Ternary>);
+        return F(self, args[0], args[1]);
+    }
+}
+
 // Object类型
-Object* object_str(Object* self, const List* args);
-Object* object_eq(Object* self, const List* args);
-Object* object_setitem(Object* self, const List* args);
-Object* object_getitem(Object* self, const List* args);
+Object* object_str(Object* self, Args args);
+Object* object_eq(Object* self, Args args);
+Object* object_setitem(Object* self, Args args);
+Object* object_getitem(Object* self, Args args);
 
 // Int 类型原生函数
-Object* int_add(Object* self, const List* args);
-Object* int_sub(Object* self, const List* args);
-Object* int_mul(Object* self, const List* args);
-Object* int_div(Object* self, const List* args);
-Object* int_pow(Object* self, const List* args);
-Object* int_mod(Object* self, const List* args);
-Object* int_neg(Object* self, const List* args);
-Object* int_eq(Object* self, const List* args);
-Object* int_lt(Object* self, const List* args);
-Object* int_gt(Object* self, const List* args);
-Object* int_bool(Object* self, const List* args);
-Object* int_call(Object* self, const List* args);
-Object* int_hash(Object* self, const List* args);
-Object* int_str(Object* self, const List* args);
+Object* int_add(Object* self, Object* other);
+Object* int_sub(Object* self, Object* other);
+Object* int_mul(Object* self, Object* other);
+Object* int_div(Object* self, Object* other);
+Object* int_pow(Object* self, Object* other);
+Object* int_mod(Object* self, Object* other);
+Object* int_neg(Object* self);
+Object* int_eq(Object* self, Object* other);
+Object* int_lt(Object* self, Object* other);
+Object* int_gt(Object* self, Object* other);
+Object* int_bool(Object* self);
+Object* int_call(Object* self, Args args);
+Object* int_hash(Object* self);
+Object* int_str(Object* self);
 
 // Decimal类型原生函数
-Object* decimal_add(Object* self, const List* args);
-Object* decimal_sub(Object* self, const List* args);
-Object* decimal_mul(Object* self, const List* args);
-Object* decimal_div(Object* self, const List* args);
-Object* decimal_pow(Object* self, const List* args);
-Object* decimal_neg(Object* self, const List* args);
-Object* decimal_eq(Object* self, const List* args);
-Object* decimal_lt(Object* self, const List* args);
-Object* decimal_gt(Object* self, const List* args);
-Object* decimal_bool(Object* self, const List* args);
-Object* decimal_call(Object* self, const List* args);
-Object* decimal_hash(Object* self, const List* args);
-Object* decimal_str(Object* self, const List* args);
-Object* decimal_limit_div(Object* self, const List* args);
-Object* decimal_round_div(Object* self, const List* args);
-Object* decimal_approx(Object* self, const List* args);
+Object* decimal_add(Object* self, Object* other);
+Object* decimal_sub(Object* self, Object* other);
+Object* decimal_mul(Object* self, Object* other);
+Object* decimal_div(Object* self, Object* other);
+Object* decimal_pow(Object* self, Object* other);
+Object* decimal_neg(Object* self);
+Object* decimal_eq(Object* self, Object* other);
+Object* decimal_lt(Object* self, Object* other);
+Object* decimal_gt(Object* self, Object* other);
+Object* decimal_bool(Object* self);
+Object* decimal_call(Object* self, Args args);
+Object* decimal_hash(Object* self);
+Object* decimal_str(Object* self);
+Object* decimal_limit_div(Object* self, Args args);
+Object* decimal_round_div(Object* self, Args args);
+Object* decimal_approx(Object* self, Args args);
 
 // Nil 类型原生函数
-Object* nil_eq(Object* self, const List* args);
-Object* nil_hash(Object* self, const List* args);
-Object* nil_str(Object* self, const List* args);
+Object* nil_eq(Object* self, Object* other);
+Object* nil_hash(Object* self);
+Object* nil_str(Object* self);
 
 // Bool 类型原生函数
-Object* bool_eq(Object* self, const List* args);
-Object* bool_call(Object* self, const List* args);
-Object* bool_hash(Object* self, const List* args);
-Object* bool_str(Object* self, const List* args);
+Object* bool_eq(Object* self, Object* other);
+Object* bool_call(Object* self, Args args);
+Object* bool_hash(Object* self);
+Object* bool_str(Object* self);
 
 // String 类型原生函数
-Object* str_eq(Object* self, const List* args);
-Object* str_add(Object* self, const List* args);
-Object* str_mul(Object* self, const List* args);
-Object* str_contains(Object* self, const List* args);
-Object* str_call(Object* self, const List* args);
-Object* str_bool(Object* self, const List* args);
-Object* str_hash(Object* self, const List* args);
-Object* str_next(Object* self, const List* args);
-Object* str_getitem(Object* self, const List* args);
-Object* str_str(Object* self, const List* args);
-Object* str_dstr(Object* self, const List* args);
+Object* str_eq(Object* self, Object* other);
+Object* str_add(Object* self, Object* other);
+Object* str_mul(Object* self, Object* other);
+Object* str_contains(Object* self, Args args);
+Object* str_call(Object* self, Args args);
+Object* str_bool(Object* self);
+Object* str_hash(Object* self);
+Object* str_next(Object* self);
+Object* str_iter(Object* self, Args args);
+Object* str_getitem(Object* self, Object* other);
+Object* str_str(Object* self);
+Object* str_dstr(Object* self, Args args);
 // 普通方法
-Object* str_foreach(Object* self, const List* args);
-Object* str_count(Object* self, const List* args);
-Object* str_startswith(Object* self, const List* args);
-Object* str_endswith(Object* self, const List* args);
-Object* str_len(Object* self, const List* args);
-Object* str_substr(Object* self, const List* args);
-Object* str_is_alpha(Object* self, const List* args);
-Object* str_is_digit(Object* self, const List* args);
-Object* str_to_lower(Object* self, const List* args);
-Object* str_to_upper(Object* self, const List* args);
-Object* str_format(Object* self, const List* args);
+Object* str_foreach(Object* self, Args args);
+Object* str_count(Object* self, Args args);
+Object* str_startswith(Object* self, Args args);
+Object* str_endswith(Object* self, Args args);
+Object* str_len(Object* self);
+Object* str_substr(Object* self, Args args);
+Object* str_is_alpha(Object* self, Args args);
+Object* str_is_digit(Object* self, Args args);
+Object* str_to_lower(Object* self, Args args);
+Object* str_to_upper(Object* self, Args args);
+Object* str_format(Object* self, Args args);
 
 // Dict 类型原生函数
-Object* dict_eq(Object* self, const List* args);
-Object* dict_add(Object* self, const List* args);
-Object* dict_contains(Object* self, const List* args);
-Object* dict_setitem(Object* self, const List* args);
-Object* dict_getitem(Object* self, const List* args);
-Object* dict_str(Object* self, const List* args);
-Object* dict_dstr(Object* self, const List* args);
-Object* dict_foreach(Object* self, const List* args);
-Object* dict_next(Object* self, const List* args);
-Object* dict_len(Object* self, const List* args);
+Object* dict_eq(Object* self, Args args);
+Object* dict_add(Object* self, Object* other);
+Object* dict_contains(Object* self, Args args);
+Object* dict_setitem(Object* self, Object* key, Object* value);
+Object* dict_getitem(Object* self, Object* other);
+Object* dict_str(Object* self);
+Object* dict_dstr(Object* self, Args args);
+Object* dict_foreach(Object* self, Args args);
+Object* dict_next(Object* self);
+Object* dict_iter(Object* self, Args args);
+Object* dict_len(Object* self);
+Object* dict_keys(Object* self, Args args);
+Object* dict_values(Object* self, Args args);
+Object* dict_items(Object* self, Args args);
 
 // List 类型原生函数
-Object* list_eq(Object* self, const List* args);
-Object* list_add(Object* self, const List* args);
-Object* list_mul(Object* self, const List* args);
-Object* list_call(Object* self, const List* args);
-Object* list_bool(Object* self, const List* args);
-Object* list_next(Object* self, const List* args);
-Object* list_setitem(Object* self, const List* args);
-Object* list_getitem(Object* self, const List* args);
-Object* list_str(Object* self, const List* args);
-Object* list_dstr(Object* self, const List* args);
+Object* list_eq(Object* self, Object* other);
+Object* list_add(Object* self, Object* other);
+Object* list_mul(Object* self, Object* other);
+Object* list_call(Object* self, Args args);
+Object* list_bool(Object* self);
+Object* list_next(Object* self);
+Object* list_iter(Object* self, Args args);
+Object* list_setitem(Object* self, Object* key, Object* value);
+Object* list_getitem(Object* self, Object* other);
+Object* list_str(Object* self);
+Object* list_dstr(Object* self, Args args);
 // 普通方法
-Object* list_contains(Object* self, const List* args);
-Object* list_append(Object* self, const List* args);
-Object* list_foreach(Object* self, const List* args);
-Object* list_reverse(Object* self, const List* args);
-Object* list_extend(Object* self, const List* args);
-Object* list_pop(Object* self, const List* args);
-Object* list_insert(Object* self, const List* args);
-Object* list_find(Object* self, const List* args);
-Object* list_map(Object* self, const List* args);
-Object* list_count(Object* self, const List* args);
-Object* list_len(Object* self, const List* args);
-Object* list_filter(Object* self, const List* args);
-Object* list_join(Object* self, const List* args);
+Object* list_contains(Object* self, Args args);
+Object* list_append(Object* self, Args args);
+Object* list_foreach(Object* self, Args args);
+Object* list_reverse(Object* self, Args args);
+Object* list_extend(Object* self, Args args);
+Object* list_pop(Object* self, Args args);
+Object* list_insert(Object* self, Args args);
+Object* list_find(Object* self, Args args);
+Object* list_map(Object* self, Args args);
+Object* list_count(Object* self, Args args);
+Object* list_len(Object* self);
+Object* list_filter(Object* self, Args args);
+Object* list_join(Object* self, Args args);
 
 // FileHandle类型
-Object* file_handle_read(Object* self, const List* args);
-Object* file_handle_flush(Object* self, const List* args);
-Object* file_handle_write(Object* self, const List* args);
-Object* file_handle_readline(Object* self, const List* args);
-Object* file_handle_close(Object* self, const List* args);
+Object* file_handle_read(Object* self, Args args);
+Object* file_handle_flush(Object* self, Args args);
+Object* file_handle_write(Object* self, Args args);
+Object* file_handle_readline(Object* self, Args args);
+Object* file_handle_close(Object* self, Args args);
 
 // Range类型
-Object* range_call(Object* self, const List* args);
-Object* range_next(Object* self, const List* args);
-Object* range_str(Object* self, const List* args);
+Object* range_call(Object* self, Args args);
+Object* range_next(Object* self, Args args);
+Object* range_iter(Object* self, Args args);
+Object* range_str(Object* self, Args args);
+
+// Iterator类型
+Object* iterator_next(Object* self, Args args);
+Object* iterator_iter(Object* self, Args args);
 
 // Error类型
-Object* error_str(Object* self, const List* args);
-Object* error_call(Object* self, const List* args);
+Object* error_str(Object* self, Args args);
+Object* error_call(Object* self, Args args);
 
 // Function类型
-Object* function_str(Object* self, const List* args);
+Object* function_str(Object* self, Args args);
 
 // NativeFunction类型
-Object* native_function_str(Object* self, const List* args);
+Object* native_function_str(Object* self, Args args);
 
 // Module类型
-Object* module_str(Object* self, const List* args);
+Object* module_str(Object* self, Args args);
 
 }
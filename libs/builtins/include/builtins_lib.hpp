@@ -4,5 +4,5 @@
 #include "builtin_methods.hpp"
 
 namespace builtins_lib {
-model::Object* init_module(model::Object* self, const model::List* args);
+model::Object* init_module(model::Object* self, model::Args args);
 }
\ No newline at end of file
@@ -6,10 +6,10 @@
 namespace model {
 
 // Int.__call__
-Object* int_call(Object* self, const List* args) {
-    auto a = builtin::get_one_arg(args);
+Object* int_call(Object* self, Args args) {
+    auto a = args[0];
     dep::BigInt val(0);
-    if (auto s = dynamic_cast<String*>(a)) {
+    if (auto s = a->as<model::String>()) {
         auto str = dep::UTF8String(s->val);
         bool is_digit = true;
         for (const auto& c : str) {
@@ -18,13 +18,13 @@ Object* int_call(Object* self, const List* args) {
         if (is_digit) {
             val = dep::BigInt(s->val);
         } else {
-            throw NativeFuncError("TypeError", "Cannot cast this string to Int");
+            return kiz::Vm::raise("TypeError", "Cannot cast this string to Int");
         }
     }
-    if (auto i = dynamic_cast<Int*>(a)) {
+    if (auto i = a->as<model::Int>()) {
         val = dep::BigInt(i->val);
     }
-    if (auto i = dynamic_cast<Decimal*>(a)) {
+    if (auto i = a->as<model::Decimal>()) {
         val = dep::BigInt(i->val.integer_part());
     }
 
@@ -33,118 +33,108 @@ Object* int_call(Object* self, const List* args) {
 }
 
 // Int.__bool__
-Object* int_bool(Object* self, const List* args) {
-    const auto self_int = dynamic_cast<Int*>(self);
+Object* int_bool(Object* self) {
+    const auto self_int = self->as<model::Int>();
     if (self_int->val == dep::BigInt(0)) {
         return load_false();
     }
     return load_true();
 }
 
-// Int.__add__ 整数加法：self + args[0]（仅支持Int/Decimal）
-Object* int_add(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-
-    const auto self_int = dynamic_cast<Int*>(self);
+// Int.__add__ 整数加法：self + other（仅支持Int/Decimal）
+Object* int_add(Object* self, Object* other) {
+    const auto self_int = self->as<model::Int>();
     assert(self_int!=nullptr);
 
     // 与Int相加
-    auto another_int = dynamic_cast<Int*>(args->val[0]);
+    auto another_int = other->as<model::Int>();
     if (another_int) {
         return new Int(self_int->val + another_int->val);
     }
     // 与Decimal相加（返回Decimal）
-    auto another_dec = dynamic_cast<Decimal*>(args->val[0]);
+    auto another_dec = other->as<model::Decimal>();
     if (another_dec) {
         dep::Decimal left_dec(self_int->val);
         return new Decimal(left_dec + another_dec->val);
     }
     // 仅允许Int/Decimal
-    throw NativeFuncError("TypeError", "function Int.add second arg need be Int or Decimal");
+    return kiz::Vm::raise("TypeError", "function Int.add second arg need be Int or Decimal");
 };
 
-// Int.__sub__ 整数减法：self - args[0]（仅支持Int/Decimal）
-Object* int_sub(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-
-    auto self_int = dynamic_cast<Int*>(self);
+// Int.__sub__ 整数减法：self - other（仅支持Int/Decimal）
+Object* int_sub(Object* self, Object* other) {
+    auto self_int = self->as<model::Int>();
     // 与Int相减
-    auto another_int = dynamic_cast<Int*>(args->val[0]);
+    auto another_int = other->as<model::Int>();
     if (another_int) {
         return new Int(self_int->val - another_int->val);
     }
     // 与Decimal相减（返回Decimal）
-    auto another_dec = dynamic_cast<Decimal*>(args->val[0]);
+    auto another_dec = other->as<model::Decimal>();
     if (another_dec) {
         dep::Decimal left_dec(self_int->val);
         return new Decimal(left_dec - another_dec->val);
     }
     // 仅允许Int/Decimal
-    throw NativeFuncError("TypeError", "function Int.sub second arg need be Int or Decimal");
+    return kiz::Vm::raise("TypeError", "function Int.sub second arg need be Int or Decimal");
 };
 
-// Int.__mul__ 整数乘法：self * args[0]（仅支持Int/Decimal）
-Object* int_mul(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-
-    auto self_int = dynamic_cast<Int*>(self);
+// Int.__mul__ 整数乘法：self * other（仅支持Int/Decimal）
+Object* int_mul(Object* self, Object* other) {
+    auto self_int = self->as<model::Int>();
     // 与Int相乘
-    auto another_int = dynamic_cast<Int*>(args->val[0]);
+    auto another_int = other->as<model::Int>();
     if (another_int) {
         return new Int(self_int->val * another_int->val);
     }
     // 与Decimal相乘（返回Decimal）
-    auto another_dec = dynamic_cast<Decimal*>(args->val[0]);
+    auto another_dec = other->as<model::Decimal>();
     if (another_dec) {
         dep::Decimal left_dec(self_int->val);
         return new Decimal(left_dec * another_dec->val);
     }
     // 仅允许Int/Decimal
-    throw NativeFuncError("TypeError", "function Int.mul second arg need be Int or Decimal");
+    return kiz::Vm::raise("TypeError", "function Int.mul second arg need be Int or Decimal");
 };
 
 // Int.__neg__ 取反
-Object* int_neg(Object* self, const List* args) {
-    auto self_int = dynamic_cast<Int*>(self);
+Object* int_neg(Object* self) {
+    auto self_int = self->as<model::Int>();
     assert(self_int!=nullptr);
 
     auto new_int = dep::BigInt(0) - self_int->val;
     return new Int(new_int);
 }
 
-// Int.__div__ 整数除法 self / args[0]（仅支持Int/Decimal，返回Decimal）
-Object* int_div(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-
-    auto self_int = dynamic_cast<Int*>(self);
+// Int.__div__ 整数除法 self / other（仅支持Int/Decimal，返回Decimal）
+Object* int_div(Object* self, Object* other) {
+    auto self_int = self->as<model::Int>();
     assert(self_int!=nullptr);
     // 与Int相除（返回Decimal，保留10位小数）
-    auto another_int = dynamic_cast<Int*>(args->val[0]);
+    auto another_int = other->as<model::Int>();
     if (another_int) {
-        if (another_int->val == 0) throw NativeFuncError("CalculateError", "divisor cannot be zero");
+        if (another_int->val == 0) return kiz::Vm::raise("CalculateError", "divisor cannot be zero");
         dep::Decimal left_dec(self_int->val);
         dep::Decimal right_dec(another_int->val);
         return new Decimal(left_dec.div(right_dec, 10));
     }
     // 与Decimal相除（返回Decimal）
-    auto another_dec = dynamic_cast<Decimal*>(args->val[0]);
+    auto another_dec = other->as<model::Decimal>();
     if (another_dec) {
-        if(another_dec->val == dep::Decimal(0)) throw NativeFuncError("CalculateError", "divisor cannot be zero");
+        if(another_dec->val == dep::Decimal(0)) return kiz::Vm::raise("CalculateError", "divisor cannot be zero");
         dep::Decimal left_dec(self_int->val);
         return new Decimal(left_dec.div(another_dec->val, 10));
     }
     // 仅允许Int/Decimal
-    throw NativeFuncError("TypeError", "function Int.div second arg need be Int or Decimal");
+    return kiz::Vm::raise("TypeError", "function Int.div second arg need be Int or Decimal");
 };
 
-// Int.__pow__ 整数幂运算：self ^ args[0]（self的args[0]次方，仅支持Int指数）
-Object* int_pow(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-
-    auto self_int = dynamic_cast<Int*>(self);
-    auto exp_int = dynamic_cast<Int*>(args->val[0]);
+// Int.__pow__ 整数幂运算：self ^ other（self的other次方，仅支持Int指数）
+Object* int_pow(Object* self, Object* other) {
+    auto self_int = self->as<model::Int>();
+    auto exp_int = other->as<model::Int>();
     if (! exp_int)
-        throw NativeFuncError("TypeError", "function Int.pow second arg need be Int");
+        return kiz::Vm::raise("TypeError", "function Int.pow second arg need be Int");
 
     // 指数非负时返回Int，负指数返回Decimal（扩展支持）
     if (exp_int->val.is_negative()) {
@@ -159,18 +149,16 @@ Object* int_pow(Object* self, const List* args) {
     }
 };
 
-// Int.__mod__ 整数取模：self % args[0]（仅支持Int）
-Object* int_mod(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-
-    auto another_int = dynamic_cast<Int*>(args->val[0]);
+// Int.__mod__ 整数取模：self % other（仅支持Int）
+Object* int_mod(Object* self, Object* other) {
+    auto another_int = other->as<model::Int>();
     if (! another_int)
-        throw NativeFuncError("TypeError", "function Int.mod second arg need be Int");
+        return kiz::Vm::raise("TypeError", "function Int.mod second arg need be Int");
 
     if(another_int->val == dep::BigInt(0))
-        throw NativeFuncError("CalculateError", "mod by zero");
+        return kiz::Vm::raise("CalculateError", "mod by zero");
 
-    auto self_int = dynamic_cast<Int*>(self);
+    auto self_int = self->as<model::Int>();
     dep::BigInt remainder = self_int->val % another_int->val;
     // 修正余数符号（确保与除数同号）
     if (remainder != dep::BigInt(0)
@@ -181,74 +169,68 @@ Object* int_mod(Object* self, const List* args) {
     return new Int(dep::BigInt(remainder));
 };
 
-// Int.__eq__ 相等判断：self == args[0]（仅支持Int/Decimal）
-Object* int_eq(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-
-    auto self_int = dynamic_cast<Int*>(self);
+// Int.__eq__ 相等判断：self == other（仅支持Int/Decimal）
+Object* int_eq(Object* self, Object* other) {
+    auto self_int = self->as<model::Int>();
     // 与Int比较
-    auto another_int = dynamic_cast<Int*>(args->val[0]);
+    auto another_int = other->as<model::Int>();
     if (another_int) {
         return load_bool(self_int->val == another_int->val);
     }
     // 与Decimal比较
-    auto another_dec = dynamic_cast<Decimal*>(args->val[0]);
+    auto another_dec = other->as<model::Decimal>();
     if (another_dec) {
         dep::Decimal cmp_val(self_int->val);
         return load_bool(cmp_val == another_dec->val);
     }
     // 仅允许Int/Decimal
-    throw NativeFuncError("TypeError", "function Int.eq second arg need be Int or Decimal");
+    return kiz::Vm::raise("TypeError", "function Int.eq second arg need be Int or Decimal");
 };
 
-// Int.__lt__ 小于判断：self < args[0]（仅支持Int/Decimal）
-Object* int_lt(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-
-    auto self_int = dynamic_cast<Int*>(self);
+// Int.__lt__ 小于判断：self < other（仅支持Int/Decimal）
+Object* int_lt(Object* self, Object* other) {
+    auto self_int = self->as<model::Int>();
     // 与Int比较
-    auto another_int = dynamic_cast<Int*>(args->val[0]);
+    auto another_int = other->as<model::Int>();
     if (another_int) {
         return load_bool(self_int->val < another_int->val);
     }
     // 与Decimal比较
-    auto another_dec = dynamic_cast<Decimal*>(args->val[0]);
+    auto another_dec = other->as<model::Decimal>();
     if (another_dec) {
         dep::Decimal cmp_val(self_int->val);
         return load_bool(cmp_val < another_dec->val);
     }
     // 仅允许Int/Decimal
-    throw NativeFuncError("TypeError", "function Int.lt second arg need be Int or Decimal");
+    return kiz::Vm::raise("TypeError", "function Int.lt second arg need be Int or Decimal");
 };
 
-// Int.__gt__ 大于判断：self > args[0]（仅支持Int/Decimal）
-Object* int_gt(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-
-    auto self_int = dynamic_cast<Int*>(self);
+// Int.__gt__ 大于判断：self > other（仅支持Int/Decimal）
+Object* int_gt(Object* self, Object* other) {
+    auto self_int = self->as<model::Int>();
     // 与Int比较
-    auto another_int = dynamic_cast<Int*>(args->val[0]);
+    auto another_int = other->as<model::Int>();
     if (another_int) {
         return load_bool(self_int->val > another_int->val);
     }
     // 与Decimal比较
-    auto another_dec = dynamic_cast<Decimal*>(args->val[0]);
+    auto another_dec = other->as<model::Decimal>();
     if (another_dec) {
         dep::Decimal cmp_val(self_int->val);
         return load_bool(cmp_val > another_dec->val);
     }
     // 仅允许Int/Decimal
-    throw NativeFuncError("TypeError", "function Int.gt second arg need be Int or Decimal");
+    return kiz::Vm::raise("TypeError", "function Int.gt second arg need be Int or Decimal");
 };
 
 // Int.__hash__
-Object* int_hash(Object* self, const List* args) {
-    auto self_int = dynamic_cast<Int*>(self);
+Object* int_hash(Object* self) {
+    auto self_int = self->as<model::Int>();
     return new Int(self_int->val);
 }
 
-Object* int_str(Object* self, const List* args) {
-    auto self_int = dynamic_cast<Int*>(self);
+Object* int_str(Object* self) {
+    auto self_int = self->as<model::Int>();
     return new String(self_int->val.to_string());
 }
 
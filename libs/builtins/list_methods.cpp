@@ -6,15 +6,15 @@
 namespace model {
 
 // List.__call__
-Object* list_call(Object* self, const List* args) {
+Object* list_call(Object* self, Args args) {
     std::vector<Object*> list = {};
-    if (args->val.empty()) {
+    if (args.empty()) {
         return new List({});
     }
 
-    auto for_cast = builtin::get_one_arg(args);
+    auto for_cast = args[0];
     while (true) {
-        kiz::Vm::call_method(for_cast, "__next__", {});
+        kiz::Vm::call_method(for_cast, model::magic_name::next_item, {});
         auto res = kiz::Vm::simple_get_and_pop_stack_top();
         if (res == stop_iter_signal) {
             break;
@@ -25,43 +25,39 @@ Object* list_call(Object* self, const List* args) {
 }
 
 // List.__bool__
-Object* list_bool(Object* self, const List* args) {
-    const auto self_int = dynamic_cast<List*>(self);
+Object* list_bool(Object* self) {
+    const auto self_int = self->as<model::List>();
     assert(self_int != nullptr);
     if (self_int->val.empty()) return load_false();
     return load_true();
 }
 
 //  List.__add__：拼接另一个List（self + 传入List，返回新List）
-Object* list_add(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-    
-    auto self_list = dynamic_cast<List*>(self);
+Object* list_add(Object* self, Object* other) {
+    auto self_list = self->as<model::List>();
     assert(self_list != nullptr);
     
-    auto another_list = dynamic_cast<List*>(args->val[0]);
+    auto another_list = other->as<model::List>();
     if (!another_list)
-        throw NativeFuncError("TypeError", "List.add only supports List type argument");
+        return kiz::Vm::raise("TypeError", "List.add only supports List type argument");
     
     // 浅拷贝
-    std::vector<Object*> new_vals = self_list->val;
+    std::vector<Object*> new_vals = self_list->val.get();
     new_vals.insert(new_vals.end(), another_list->val.begin(), another_list->val.end());
     
     return new List(std::move(new_vals));
 };
 
 // List.__mul__：重复自身n次 self * n
-Object* list_mul(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-    
-    auto self_list = dynamic_cast<List*>(self);
+Object* list_mul(Object* self, Object* other) {
+    auto self_list = self->as<model::List>();
     assert(self_list != nullptr);
     
-    auto times_int = dynamic_cast<Int*>(args->val[0]);
+    auto times_int = other->as<model::Int>();
     if (! times_int)
-        throw NativeFuncError("TypeError", "List.mul only supports Int type argument");
+        return kiz::Vm::raise("TypeError", "List.mul only supports Int type argument");
     if (times_int->val < dep::BigInt(0))
-        throw NativeFuncError("TypeError", "List.mul requires non-negative integer argument");
+        return kiz::Vm::raise("TypeError", "List.mul requires non-negative integer argument");
     
     std::vector<Object*> new_vals;
     dep::BigInt times = times_int->val;
@@ -73,15 +69,13 @@ Object* list_mul(Object* self, const List* args) {
 };
 
 // List.__eq__：判断两个List是否相等
-Object* list_eq(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-    
-    auto self_list = dynamic_cast<List*>(self);
+Object* list_eq(Object* self, Object* other) {
+    auto self_list = self->as<model::List>();
     assert(self_list != nullptr);
     
-    auto another_list = dynamic_cast<List*>(args->val[0]);
+    auto another_list = other->as<model::List>();
     if (! another_list)
-        throw NativeFuncError("TypeError", "List.eq only supports List type argument");
+        return kiz::Vm::raise("TypeError", "List.eq only supports List type argument");
     
     // 比较元素个数，不同直接返回false
     if (self_list->val.size() != another_list->val.size()) {
@@ -93,15 +87,14 @@ Object* list_eq(Object* self, const List* args) {
         Object* self_elem = self_list->val[i];
         Object* another_elem = another_list->val[i];
         // 调用 __eq__
-        kiz::Vm::call_method(
-            self_elem, "__eq__", {another_elem}
-        );
+        Object* argv[] = {another_elem};
+        kiz::Vm::call_method(self_elem, model::magic_name::eq, argv);
         const auto eq_result = kiz::Vm::simple_get_and_pop_stack_top();
 
         // 解析比较结果
-        const auto eq_bool = dynamic_cast<Bool*>(eq_result);
+        const auto eq_bool = eq_result->as<model::Bool>();
         if (! eq_bool)
-            throw NativeFuncError("TypeError", "__eq__ method must return Bool type");
+            return kiz::Vm::raise("TypeError", "__eq__ method must return Bool type");
         
         // 任意元素不相等，返回 false
         if (!eq_bool->val) {
@@ -113,8 +106,8 @@ Object* list_eq(Object* self, const List* args) {
     return load_true();
 };
 
-Object* list_str(Object* self, const List* args) {
-    auto self_list = dynamic_cast<List*>(self);
+Object* list_str(Object* self) {
+    auto self_list = self->as<model::List>();
     std::string result = "[";
     for (size_t i = 0; i < self_list->val.size(); ++i) {
         if (self_list->val[i]) {
@@ -130,8 +123,8 @@ Object* list_str(Object* self, const List* args) {
     return new String(result);
 }
 
-Object* list_dstr(Object* self, const List* args) {
-    auto self_list = dynamic_cast<List*>(self);
+Object* list_dstr(Object* self, Args args) {
+    auto self_list = self->as<model::List>();
     std::string result = "[";
     for (size_t i = 0; i < self_list->val.size(); ++i) {
         if (self_list->val[i] != nullptr) {
@@ -148,20 +141,17 @@ Object* list_dstr(Object* self, const List* args) {
 }
 
 // List.contains：判断列表是否包含目标元素
-Object* list_contains(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-    
-    auto self_list = dynamic_cast<List*>(self);
+Object* list_contains(Object* self, Args args) {
+    auto self_list = self->as<model::List>();
     assert(self_list != nullptr);
     
-    Object* target_elem = args->val[0];
+    Object* target_elem = args[0];
 
     // 遍历列表元素，逐个判断是否与目标元素相等
     for (Object* elem : self_list->val) {
 
-        kiz::Vm::call_method(
-            elem, "__eq__", {target_elem}
-        );
+        Object* argv[] = {target_elem};
+        kiz::Vm::call_method(elem, model::magic_name::eq, argv);
         const auto result = kiz::Vm::simple_get_and_pop_stack_top();
 
         // 找到匹配元素，立即返回true
@@ -173,147 +163,152 @@ Object* list_contains(Object* self, const List* args) {
 };
 
 // List.append：向列表尾部添加一个元素
-Object* list_append(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-    
-    auto self_list = dynamic_cast<List*>(self);
+Object* list_append(Object* self, Args args) {
+    auto self_list = self->as<model::List>();
     assert(self_list != nullptr);
     
-    Object* elem_to_add = args->val[0];
+    Object* elem_to_add = args[0];
 
     // 添加元素到列表尾部
-    self_list->val.push_back(elem_to_add);
+    self_list->val.mut().push_back(elem_to_add);
     elem_to_add->make_ref();
     
-    // 返回列表自身，支持链式调用
-    self->make_ref();
+    // 返回列表自身，支持链式调用(压栈时由VM持有引用)
     return self;
 };
 
-Object* list_next(Object* self, const List* args) {
-    auto curr_idx_it = self->attrs.find("__current_index__");
-    if(!curr_idx_it)
-        throw NativeFuncError("TypeError", "List.next cannot find attribute '__current_index__' to get current index");
+Object* list_next(Object* self) {
+    auto self_list = self->as<model::List>();
+    assert(self_list != nullptr);
 
-    auto curr_idx = curr_idx_it->value;
+    if (self_list->next_cursor < self_list->val.size()) {
+        return self_list->val[self_list->next_cursor++];
+    }
+    self_list->next_cursor = 0;
+    return load_stop_iter_signal();
+}
 
-    auto index =  cast_to_int(curr_idx) ->val.to_unsigned_long_long();
+Object* list_iter(Object* self, Args args) {
+    auto self_list = self->as<model::List>();
+    assert(self_list != nullptr);
+    return new ListIterator(self_list);
+}
 
-    auto self_list = dynamic_cast<List*>(self);
-    if (index < self_list->val.size()) {
-        auto res = self_list->val[index];
-        self->attrs_insert("__current_index__", new Int(index+1));
-        return res;
+Object* ListIterator::next() {
+    if (cursor < list->val.size()) {
+        return list->val[cursor++];
     }
-    self->attrs_insert("__current_index__", kiz::Vm::small_int_pool[0]);
     return load_stop_iter_signal();
 }
 
-Object* list_foreach(Object* self, const List* args) {
-    auto func_obj = builtin::get_one_arg(args);
+Object* list_foreach(Object* self, Args args) {
+    auto func_obj = args[0];
 
-    auto self_list = dynamic_cast<List*>(self);
+    auto self_list = self->as<model::List>();
     assert(self_list != nullptr);
 
     dep::BigInt idx = 0;
     for (auto e : self_list->val) {
-        kiz::Vm::call_function(func_obj, {e}, nullptr);
+        Object* argv[] = {e};
+        kiz::Vm::call_function(func_obj, argv, nullptr);
         idx += 1;
     }
     return load_nil();
 }
 
-Object* list_reverse(Object* self, const List* args) {
-    const auto self_list = dynamic_cast<List*>(self);
+Object* list_reverse(Object* self, Args args) {
+    const auto self_list = self->as<model::List>();
     assert(self_list != nullptr);
 
-    std::ranges::reverse(self_list->val);
+    std::ranges::reverse(self_list->val.mut());
     return load_nil();
 }
 
-Object* list_extend(Object* self, const List* args) {
-    auto self_list = dynamic_cast<List*>(self);
+Object* list_extend(Object* self, Args args) {
+    auto self_list = self->as<model::List>();
     assert(self_list != nullptr);
 
-    auto other_list_obj = builtin::get_one_arg(args);
-    auto other_list = dynamic_cast<List*>(other_list_obj);
-    if (!other_list)
-        throw NativeFuncError("TypeError", "The first argument of List.extend must be List type");
+    const auto other_list = static_cast<List*>(args[0]);
 
-    for (auto e: other_list->val) {
-        self_list->val.push_back(e);
+    // 先取出对方的元素: other_list 可能就是 self_list
+    const auto other_items = other_list->val.get();
+    auto& items = self_list->val.mut();
+    for (auto e: other_items) {
+        e->make_ref();
+        items.push_back(e);
     }
     return load_nil();
 }
 
-Object* list_pop(Object* self, const List* args) {
-    auto self_list = dynamic_cast<List*>(self);
+Object* list_pop(Object* self, Args args) {
+    auto self_list = self->as<model::List>();
     assert(self_list != nullptr);
 
     if (self_list->val.empty()) {
         return load_nil();
     }
     auto back = self_list->val.back();
-    self_list->val.pop_back();
+    self_list->val.mut().pop_back();
     return back;
 }
 
-Object* list_insert(Object* self, const List* args) {
-    auto self_list = dynamic_cast<List*>(self);
+Object* list_insert(Object* self, Args args) {
+    auto self_list = self->as<model::List>();
     assert(self_list != nullptr);
-    kiz::Vm::assert_argc(2, args);
-    if (args->val.size() == 2) {
-        auto value_obj = args->val[0];
-        auto idx_int = dynamic_cast<Int*>(args->val[1]);
-        if (!idx_int)
-            throw NativeFuncError("TypeError", "The first argument of List.setitem must be Int type");
-        auto idx = idx_int->val.to_unsigned_long_long();
-        if (idx < self_list->val.size()) {
-            self_list->val[idx] = value_obj;
-        }
+    auto value_obj = args[0];
+    auto idx = static_cast<Int*>(args[1])->val.to_unsigned_long_long();
+    if (idx < self_list->val.size()) {
+        auto& slot = self_list->val.mut()[idx];
+        value_obj->make_ref();
+        if (slot) slot->del_ref();
+        slot = value_obj;
     }
     return load_nil();
 }
 
-Object* list_setitem(Object* self, const List* args) {
-    kiz::Vm::assert_argc(2, args);
-    auto self_list = dynamic_cast<List*>(self);
+Object* list_setitem(Object* self, Object* key, Object* value) {
+    auto self_list = self->as<model::List>();
 
-    auto idx_obj = dynamic_cast<Int*>(args->val[0]);
+    auto idx_obj = key->as<model::Int>();
     if (!idx_obj)
-        throw NativeFuncError("TypeError", "The first argument of List.setitem must be Int type");
+        return kiz::Vm::raise("TypeError", "The first argument of List.setitem must be Int type");
 
     auto index = idx_obj->val.to_unsigned_long_long();
 
-    auto value_obj = args->val[1];
+    auto value_obj = value;
 
     if (index < self_list->val.size()) {
-        self_list->val[index] = value_obj;
+        auto& slot = self_list->val.mut()[index];
+        value_obj->make_ref();
+        if (slot) slot->del_ref();
+        slot = value_obj;
         return load_nil();
     }
-    throw NativeFuncError("SetItemError", std::format("index {} out of range", index));
+    return kiz::Vm::raise("SetItemError", std::format("index {} out of range", index));
 }
 
-Object* list_getitem(Object* self, const List* args) {
-    auto self_list = dynamic_cast<List*>(self);
-    auto idx_obj = dynamic_cast<Int*>(builtin::get_one_arg(args));
+Object* list_getitem(Object* self, Object* other) {
+    auto self_list = self->as<model::List>();
+    auto idx_obj = other->as<model::Int>();
     if (!idx_obj)
-        throw NativeFuncError("TypeError", "The first argument of List.getitem must be Int type");
+        return kiz::Vm::raise("TypeError", "The first argument of List.getitem must be Int type");
 
     auto index = idx_obj->val.to_unsigned_long_long();
     if (index < self_list->val.size()) {
         return self_list->val[index];
     }
-    throw NativeFuncError("GetItemError", std::format("index {} out of range", index));
+    return kiz::Vm::raise("GetItemError", std::format("index {} out of range", index));
 }
 
-Object* list_count(Object* self, const List* args) {
-    const auto obj = builtin::get_one_arg(args);
+Object* list_count(Object* self, Args args) {
+    const auto obj = args[0];
     size_t count = 0;
     auto self_list = cast_to_list(self);
+    if (!self_list) return nullptr;
 
     for (const auto& item : self_list->val) {
-        kiz::Vm::call_method(obj, "__eq__", {item});
+        Object* argv[] = {item};
+        kiz::Vm::call_method(obj, model::magic_name::eq, argv);
         auto res = kiz::Vm::simple_get_and_pop_stack_top();
         if (res) {
             ++ count;
@@ -322,14 +317,15 @@ Object* list_count(Object* self, const List* args) {
     return new Int(count);
 }
 
-Object* list_find(Object* self, const List* args) {
-    auto func_obj = builtin::get_one_arg(args);
+Object* list_find(Object* self, Args args) {
+    auto func_obj = args[0];
 
-    auto self_list = dynamic_cast<List*>(self);
+    auto self_list = self->as<model::List>();
     assert(self_list != nullptr);
 
     for (auto e : self_list->val) {
-        kiz::Vm::call_function(func_obj, {e}, nullptr);
+        Object* argv[] = {e};
+        kiz::Vm::call_function(func_obj, argv, nullptr);
         auto res = kiz::Vm::simple_get_and_pop_stack_top();
         if (kiz::Vm::is_true(res)) {
             res->make_ref();
@@ -339,16 +335,17 @@ Object* list_find(Object* self, const List* args) {
     return load_nil();
 }
 
-Object* list_map(Object* self, const List* args) {
-    auto func_obj = builtin::get_one_arg(args);
+Object* list_map(Object* self, Args args) {
+    auto func_obj = args[0];
 
-    auto self_list = dynamic_cast<List*>(self);
+    auto self_list = self->as<model::List>();
     assert(self_list != nullptr);
 
     std::vector<Object*> new_vec;
 
     for (auto e : self_list->val) {
-        kiz::Vm::call_function(func_obj, {e}, nullptr);
+        Object* argv[] = {e};
+        kiz::Vm::call_function(func_obj, argv, nullptr);
         auto res = kiz::Vm::simple_get_and_pop_stack_top();
         
         new_vec.push_back(res);
@@ -356,16 +353,17 @@ Object* list_map(Object* self, const List* args) {
     return new List(new_vec);
 }
 
-Object* list_filter(Object* self, const List* args) {
-    auto func_obj = builtin::get_one_arg(args);
+Object* list_filter(Object* self, Args args) {
+    auto func_obj = args[0];
 
-    auto self_list = dynamic_cast<List*>(self);
+    auto self_list = self->as<model::List>();
     assert(self_list != nullptr);
 
     std::vector<Object*> new_vec;
 
     for (auto e : self_list->val) {
-        kiz::Vm::call_function(func_obj, {e}, nullptr);
+        Object* argv[] = {e};
+        kiz::Vm::call_function(func_obj, argv, nullptr);
         auto res = kiz::Vm::simple_get_and_pop_stack_top();
         if (kiz::Vm::is_true(res)) {
             new_vec.push_back(res);
@@ -374,17 +372,17 @@ Object* list_filter(Object* self, const List* args) {
     return new List(new_vec);
 }
 
-Object* list_len(Object* self, const List* args) {
-    auto self_list = dynamic_cast<List*>(self);
+Object* list_len(Object* self) {
+    auto self_list = self->as<model::List>();
     assert(self_list != nullptr);
     return new Int(dep::BigInt(self_list->val.size()));
 }
 
-Object* list_join(Object* self, const List* args) {
-    auto self_list = dynamic_cast<List*>(self);
+Object* list_join(Object* self, Args args) {
+    auto self_list = self->as<model::List>();
     assert(self_list != nullptr);
 
-    auto sep = kiz::Vm::obj_to_str(builtin::get_one_arg(args));
+    auto sep = kiz::Vm::obj_to_str(args[0]);
 
     std::string text;
     size_t index = 0;
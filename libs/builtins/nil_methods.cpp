@@ -3,19 +3,18 @@
 namespace model {
 
 // Nil.__eq__ 相等判断：仅当另一个对象也是Nil时返回true
-Object* nil_eq(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
+Object* nil_eq(Object* self, Object* other) {
     // Nil仅与自身相等
-    auto another_nil = dynamic_cast<Nil*>(args->val[0]);
+    auto another_nil = other->as<model::Nil>();
     return load_bool(another_nil != nullptr);
 }
 
 // Nil.__hash__
-Object* nil_hash(Object* self, const List* args) {
+Object* nil_hash(Object* self) {
     return kiz::Vm::small_int_pool[0];
 }
 
-Object* nil_str(Object* self, const List* args) {
+Object* nil_str(Object* self) {
     return new model::String("Nil");
 }
 
@@ -4,130 +4,145 @@
 namespace model {
 
 // Object类型
-Object* object_str(Object* self, const List* args) {
+Object* object_str(Object* self, Args args) {
     return new String("<Object at " + model::ptr_to_string(self) + ">");
 }
 
-Object* object_eq(Object* self, const List* args) {
-    const auto other_obj = builtin::get_one_arg(args);
+Object* object_eq(Object* self, Args args) {
+    const auto other_obj = args[0];
     return model::load_bool(self == other_obj);
 }
 
-Object* object_setitem(Object* self, const List* args) {
-    assert(args->val.size() == 2);
-    auto attr = args->val[0];
-    auto attr_str = dynamic_cast<model::String*>(attr);
+Object* object_setitem(Object* self, Args args) {
+    assert(args.size() == 2);
+    auto attr = args[0];
+    auto attr_str = attr->as<model::String>();
     assert(attr_str != nullptr);
-    self->attrs_insert(attr_str->val, args->val[1]);
+    self->attrs_insert(attr_str->val, args[1]);
     return self;
 }
 
-Object* object_getitem(Object* self, const List* args) {
-    auto attr = builtin::get_one_arg(args);
-    auto attr_str = dynamic_cast<model::String*>(attr);
+Object* object_getitem(Object* self, Args args) {
+    auto attr = args[0];
+    auto attr_str = attr->as<model::String>();
     assert(attr_str != nullptr);
-    return kiz::Vm::get_attr(self, attr_str->val);
+    return kiz::Vm::get_attr(self, dep::intern(attr_str->val));
 }
 
 
-// Range类型
-Object* range_call(Object* self, const List* args) {
-    auto arg_vector = args->val;
-    dep::BigInt start_int = 0;
-    dep::BigInt step_int = 1;
-    dep::BigInt end_int = 1;
-    auto r_obj = new Object();
-    r_obj->attrs_insert("__parent__", self);
+// Range类型: 边界不合法时以 raise 报告错误并返回false
+static bool range_bound(Object* obj, int64_t& out) {
+    const auto int_obj = cast_to_int(obj);
+    if (!int_obj) return false;
+    if (!int_obj->val.is_small()) {
+        kiz::Vm::raise("ValueError", "Range bound must fit in a 64-bit integer");
+        return false;
+    }
+    out = int_obj->val.small_value();
+    return true;
+}
+
+// Range(end) / Range(start, end) / Range(start, step, end)
+Object* range_call(Object* self, Args args) {
+    const auto& arg_vector = args;
+    int64_t start = 0;
+    int64_t step = 1;
+    int64_t end = 1;
 
     if (arg_vector.size() == 1) {
-        end_int = cast_to_int(arg_vector[0])->val.to_unsigned_long_long();
+        if (!range_bound(arg_vector[0], end)) return nullptr;
     }
     else if (arg_vector.size() == 2) {
-        start_int = cast_to_int(arg_vector[0])->val.to_unsigned_long_long();
-        end_int = cast_to_int(arg_vector[1])->val.to_unsigned_long_long();
+        if (!range_bound(arg_vector[0], start) or !range_bound(arg_vector[1], end)) return nullptr;
     }
     else if (arg_vector.size() == 3) {
-        start_int = cast_to_int(arg_vector[0])->val.to_unsigned_long_long();
-        step_int = cast_to_int(arg_vector[1])->val.to_unsigned_long_long();
-        end_int = cast_to_int(arg_vector[2])->val.to_unsigned_long_long();
-
-    } else kiz::Vm::assert_argc({1,2,3}, args);
-
-    r_obj->attrs_insert("current", new Int(start_int));
-    r_obj->attrs_insert("start", new Int(start_int));
-    r_obj->attrs_insert("step", new Int(step_int));
-    r_obj->attrs_insert("end", new Int(end_int));
-    return r_obj;
-}
-
-Object* range_next(Object* self, const List* args) {
-    Int* start_obj = cast_to_int(kiz::Vm::get_attr_current(self, "start"));
-    Int* step_obj = cast_to_int(kiz::Vm::get_attr_current(self, "step"));
-    Int* end_obj = cast_to_int(kiz::Vm::get_attr_current(self, "end"));
-    Int* current_obj = cast_to_int(kiz::Vm::get_attr_current(self, "current"));
-
-    dep::BigInt& start_int = start_obj->val;
-    dep::BigInt& step_int = step_obj->val;
-    dep::BigInt& end_int = end_obj->val;
-    dep::BigInt& current = current_obj->val;
-
-    bool is_end = false;
-    if (step_int > 0) {
-        is_end = current >= end_int;
-    } else {
-        return load_stop_iter_signal();
+        if (!range_bound(arg_vector[0], start) or !range_bound(arg_vector[1], step)
+            or !range_bound(arg_vector[2], end)) return nullptr;
     }
 
-    if (is_end) {
+    if (step == 0)
+        return kiz::Vm::raise("ValueError", "Range step cannot be zero");
+    auto range = new Range(start, step, end);
+    range->expose_bounds();
+    return range;
+}
+
+Object* range_next(Object* self, Args args) {
+    auto self_range = self->as<model::Range>();
+    assert(self_range != nullptr);
+
+    auto iter = RangeIterator(self_range);
+    iter.current = self_range->current;
+    int64_t val;
+    if (!iter.advance(val)) {
+        self_range->current = self_range->start;
         return load_stop_iter_signal();
     }
+    self_range->current = iter.current;
+    return load_int(val);
+}
+
+Object* range_iter(Object* self, Args args) {
+    auto self_range = self->as<model::Range>();
+    assert(self_range != nullptr);
+    return new RangeIterator(self_range);
+}
 
-    dep::BigInt old_val = current;
-    current += step_int;
+Object* range_str(Object* self, Args args) {
+    auto self_range = self->as<model::Range>();
+    assert(self_range != nullptr);
+    return new String(self_range->debug_string());
+}
 
-    // 返回迭代值
-    return new Int(old_val);
+Object* RangeIterator::next() {
+    int64_t val;
+    if (!advance(val)) return load_stop_iter_signal();
+    return load_int(val);
 }
 
-Object* range_str(Object* self, const List* args) {
-    dep::BigInt start_int = cast_to_int(kiz::Vm::get_attr_current(self, "start"))->val;
-    dep::BigInt step_int = cast_to_int(kiz::Vm::get_attr_current(self, "step"))->val;
-    dep::BigInt end_int = cast_to_int(kiz::Vm::get_attr_current(self, "end"))->val;
-    dep::BigInt current = cast_to_int(kiz::Vm::get_attr_current(self, "current"))->val;
+// Iterator类型
+Object* iterator_next(Object* self, Args args) {
+    auto self_iter = self->as<model::NativeIterator>();
+    assert(self_iter != nullptr);
+    return self_iter->next();
+}
 
-    return new String(std::format("Range(start={}, step={}, end={}, current={})", start_int.to_string(),
-        step_int.to_string(), end_int.to_string(), current.to_string()));
+Object* iterator_iter(Object* self, Args args) {
+    return self;
 }
 
 // Error类型
-Object* error_str(Object* self, const List* args) {
-    auto name = kiz::Vm::obj_to_debug_str(kiz::Vm::get_attr_current(self, "__name__"));
-    auto msg = kiz::Vm::obj_to_debug_str(kiz::Vm::get_attr_current(self, "__msg__"));
+Object* error_str(Object* self, Args args) {
+    const auto name_obj = kiz::Vm::get_attr_current(self, model::magic_name::name);
+    if (!name_obj) return nullptr;
+    const auto msg_obj = kiz::Vm::get_attr_current(self, model::magic_name::msg);
+    if (!msg_obj) return nullptr;
+    auto name = kiz::Vm::obj_to_debug_str(name_obj);
+    auto msg = kiz::Vm::obj_to_debug_str(msg_obj);
     return new String(std::format("Error(name={}, msg={})", name, msg));
 }
 
-Object* error_call(Object* self, const List* args) {
-    kiz::Vm::assert_argc(2, args);
-    auto err_name = args->val[0];
-    auto err_msg = args->val[1];
+Object* error_call(Object* self, Args args) {
+    auto err_name = args[0];
+    auto err_msg = args[1];
 
     auto err = new Error(kiz::Vm::make_pos_info());
-    err->attrs_insert("__name__", err_name);
-    err->attrs_insert("__msg__", err_msg);
+    err->attrs_insert(model::magic_name::name, err_name);
+    err->attrs_insert(model::magic_name::msg, err_msg);
     return err;
 }
 
 // Function类型
-Object* function_str(Object* self, const List* args) {
-    auto self_fn = dynamic_cast<Function*>(self);
+Object* function_str(Object* self, Args args) {
+    auto self_fn = self->as<model::Function>();
     return new String(
         "<Function: path='" + self_fn->name + "', argc=" + std::to_string(self_fn->argc) + " at " + ptr_to_string(self_fn) + ">"
     );
 }
 
 // NativeFunction类型
-Object* native_function_str(Object* self, const List* args) {
-    auto self_nfn = dynamic_cast<NativeFunction*>(self);
+Object* native_function_str(Object* self, Args args) {
+    auto self_nfn = self->as<model::NativeFunction>();
     return new model::String(
      "<NativeFunction" +
          (self_nfn->name.empty()
@@ -139,10 +154,10 @@ Object* native_function_str(Object* self, const List* args) {
 }
 
 // Module类型
-Object* module_str(Object* self, const List* args) {
-    auto self_mod = dynamic_cast<model::Module*>(self);
+Object* module_str(Object* self, Args args) {
+    auto self_mod = self->as<model::Module>();
     return new model::String(
-        "<Module: path='" + self_mod->path + "', attr=" + self_mod->attrs.to_string() + ", at " + ptr_to_string(self_mod) + ">"
+        "<Module: path='" + self_mod->path + "', attr=" + self_mod->attrs_to_string() + ", at " + ptr_to_string(self_mod) + ">"
     );
 }
 
@@ -5,48 +5,46 @@
 namespace model {
 
 // String.__call__
-Object* str_call(Object* self, const List* args) {
+Object* str_call(Object* self, Args args) {
     std::string val;
-    if (args->val.empty()) {
+    if (args.empty()) {
         val = "";
     } else {
-        val = kiz::Vm::obj_to_str(args->val[0]);
+        val = kiz::Vm::obj_to_str(args[0]);
     }
     return new String(val);
 }
 
 // String.__bool__
-Object* str_bool(Object* self, const List* args) {
-    const auto self_int = dynamic_cast<String*>(self);
+Object* str_bool(Object* self) {
+    const auto self_int = self->as<model::String>();
     if (self_int->val.empty()) load_false();
     return load_true();
 }
 
 // String.__add__：字符串拼接（self + 传入String，返回新String，不修改原对象）
-Object* str_add(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-    auto self_str = dynamic_cast<String*>(self);
+Object* str_add(Object* self, Object* other) {
+    auto self_str = self->as<model::String>();
     assert(self_str != nullptr);
     
-    auto another_str = dynamic_cast<String*>(args->val[0]);
+    auto another_str = other->as<model::String>();
     if (!another_str)
-        throw NativeFuncError("TypeError", "String.add only supports String type argument");
+        return kiz::Vm::raise("TypeError", "String.add only supports String type argument");
     
     // 拼接并返回新String
     return new String(self_str->val + another_str->val);
 };
 
 // String.__mul__：字符串重复n次（self * n，返回新String，n为非负整数）
-Object* str_mul(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-    auto self_str = dynamic_cast<String*>(self);
+Object* str_mul(Object* self, Object* other) {
+    auto self_str = self->as<model::String>();
     assert(self_str != nullptr);
     
-    auto times_int = dynamic_cast<Int*>(args->val[0]);
+    auto times_int = other->as<model::Int>();
     if (!times_int)
-        throw NativeFuncError("TypeError","String.mul only supports Int type argument");
+        return kiz::Vm::raise("TypeError","String.mul only supports Int type argument");
     if(times_int->val < dep::BigInt(0))
-        throw NativeFuncError("TypeError", "String.mul requires non-negative integer argument");
+        return kiz::Vm::raise("TypeError", "String.mul requires non-negative integer argument");
     
     std::string result;
     dep::BigInt times = times_int->val;
@@ -58,110 +56,121 @@ Object* str_mul(Object* self, const List* args) {
 };
 
 // String.__eq__：判断两个字符串是否相等 self == x
-Object* str_eq(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-    
-    auto self_str = dynamic_cast<String*>(self);
+Object* str_eq(Object* self, Object* other) {
+    auto self_str = self->as<model::String>();
     assert(self_str != nullptr);
     
-    auto another_str = dynamic_cast<String*>(args->val[0]);
+    auto another_str = other->as<model::String>();
     if (! another_str)
-        throw NativeFuncError("TypeError","String.eq only supports String type argument");
+        return kiz::Vm::raise("TypeError","String.eq only supports String type argument");
     
     return load_bool(self_str->val == another_str->val);
 };
 
 // String.__contains__：判断是否包含子字符串 x in self
-Object* str_contains(Object* self, const List* args) {
-    kiz::Vm::assert_argc(1, args);
-    
-    auto self_str = dynamic_cast<String*>(self);
-    assert(self_str != nullptr);
-    
-    auto sub_str = dynamic_cast<String*>(args->val[0]);
-    if(! sub_str)
-        throw NativeFuncError("TypeError", "String.contains only supports String type argument");
-    
+Object* str_contains(Object* self, Args args) {
+    const auto self_str = static_cast<String*>(self);
+    const auto sub_str = static_cast<String*>(args[0]);
+
     bool exists = self_str->val.find(sub_str->val) != std::string::npos;
     return load_bool(exists);
 };
 
 // String.__hash__
-Object* str_hash(Object* self, const List* args) {
-    auto self_str = dynamic_cast<String*>(self);
+Object* str_hash(Object* self) {
+    auto self_str = self->as<model::String>();
     assert(self_str != nullptr);
     auto hashed_str = dep::hash_string(self_str->val);
     return new Int(dep::BigInt(hashed_str));
 }
 
-Object* str_next(Object* self, const List* args) {
-    auto curr_idx_it = self->attrs.find("__current_index__");
-    assert(curr_idx_it != nullptr);
+// 从字节游标处切出一个 UTF-8 字符并推进游标（非法字节按单字节处理）
+static std::string next_utf8_char(const std::string& s, size_t& cursor) {
+    const auto byte = static_cast<unsigned char>(s[cursor]);
+    size_t len = 1;
+    if ((byte & 0xE0) == 0xC0) len = 2;
+    else if ((byte & 0xF0) == 0xE0) len = 3;
+    else if ((byte & 0xF8) == 0xF0) len = 4;
+    if (cursor + len > s.size()) len = 1;
+
+    std::string res = s.substr(cursor, len);
+    cursor += len;
+    return res;
+}
 
-    auto curr_idx = curr_idx_it->value;
+Object* str_next(Object* self) {
+    auto self_str = self->as<model::String>();
+    assert(self_str != nullptr);
 
-    auto index = cast_to_int(curr_idx) ->val.to_unsigned_long_long();
+    if (self_str->next_cursor < self_str->val.size()) {
+        return new String(next_utf8_char(self_str->val, self_str->next_cursor));
+    }
+    self_str->next_cursor = 0;
+    return load_stop_iter_signal();
+}
 
-    auto self_str = dynamic_cast<String*>(self);
+Object* str_iter(Object* self, Args args) {
+    auto self_str = self->as<model::String>();
     assert(self_str != nullptr);
+    return new StringIterator(self_str);
+}
 
-    if (index < self_str->val.size()) {
-        auto res = dep::UTF8String(self_str->val)[index];
-        self->attrs_insert("__current_index__", new Int(index+1));
-        return new String(res.to_string());
+Object* StringIterator::next() {
+    if (cursor < str->val.size()) {
+        return new String(next_utf8_char(str->val, cursor));
     }
-    self->attrs_insert("__current_index__", kiz::Vm::small_int_pool[0]);
     return load_stop_iter_signal();
 }
 
-Object* str_str(Object* self, const List* args) {
-    auto self_str = dynamic_cast<String*>(self);
+Object* str_str(Object* self) {
+    auto self_str = self->as<model::String>();
     assert(self_str != nullptr);
     return new String(self_str->val);
 }
 
-Object* str_dstr(Object* self, const List* args) {
-    auto self_str = dynamic_cast<String*>(self);
+Object* str_dstr(Object* self, Args args) {
+    auto self_str = self->as<model::String>();
     assert(self_str != nullptr);
     return new String("\"" + self_str->val + "\"");
 }
 
-Object* str_getitem(Object* self, const List* args) {
-    auto self_str = dynamic_cast<String*>(self);
-    auto idx_obj = cast_to_int(builtin::get_one_arg(args));
+Object* str_getitem(Object* self, Object* other) {
+    auto self_str = self->as<model::String>();
+    auto idx_obj = cast_to_int(other);
+    if (!idx_obj) return nullptr;
     auto index = idx_obj->val.to_unsigned_long_long();
     auto text = dep::UTF8String(self_str->val);
 
     if (index >= text.size()) {
-        throw NativeFuncError("GetItemError", std::format("index {} out of range", index));
+        return kiz::Vm::raise("GetItemError", std::format("index {} out of range", index));
     }
     return new String( text[index] .to_string() );
 }
 
-Object* str_foreach(Object* self, const List* args) {
-    const auto func_obj = builtin::get_one_arg(args);
+Object* str_foreach(Object* self, Args args) {
+    const auto func_obj = args[0];
 
     auto self_str = cast_to_str(self);
+    if (!self_str) return nullptr;
 
     dep::BigInt idx = 0;
     for (const auto& e : dep::UTF8String(self_str->val)) {
-        kiz::Vm::call_function(func_obj, {
-            new String(e.to_string())
-        }, nullptr);
+        Object* argv[] = {new String(e.to_string())};
+        kiz::Vm::call_function(func_obj, argv, nullptr);
         idx += 1;
     }
     return load_nil();
 }
 
-Object* str_count(Object* self, const List* args) {
-    const auto obj = builtin::get_one_arg(args);
+Object* str_count(Object* self, Args args) {
+    const auto obj = args[0];
     size_t count = 0;
     auto self_str = cast_to_str(self);
+    if (!self_str) return nullptr;
 
     for (const auto& c : dep::UTF8String(self_str->val)) {
-        kiz::Vm::call_method(obj, "__eq__", {
-            new String(c.to_string())
-        });
+        Object* argv[] = {new String(c.to_string())};
+        kiz::Vm::call_method(obj, model::magic_name::eq, argv);
         auto res = kiz::Vm::get_and_pop_stack_top();
         if (res.get()) {
             ++ count;
@@ -171,11 +180,9 @@ Object* str_count(Object* self, const List* args) {
 }
 
 
-Object* str_startswith(Object* self, const List* args) {
-    auto self_str = cast_to_str(self)->val;
-    auto prefix = cast_to_str(
-        builtin::get_one_arg(args)
-    ) -> val;
+Object* str_startswith(Object* self, Args args) {
+    const auto& self_str = static_cast<String*>(self)->val;
+    const auto& prefix = static_cast<String*>(args[0])->val;
 
     if (prefix.empty()) {
         return load_true();
@@ -187,11 +194,9 @@ Object* str_startswith(Object* self, const List* args) {
     return load_bool(self_str.compare(0, prefix.size(), prefix) == 0);
 }
 
-Object* str_endswith(Object* self, const List* args) {
-    auto self_str = cast_to_str(self)->val;
-    auto suffix = cast_to_str(
-        builtin::get_one_arg(args)
-    ) -> val;
+Object* str_endswith(Object* self, Args args) {
+    const auto& self_str = static_cast<String*>(self)->val;
+    const auto& suffix = static_cast<String*>(args[0])->val;
 
     if (suffix.empty()) {
         return load_true();
@@ -205,14 +210,16 @@ Object* str_endswith(Object* self, const List* args) {
 
 }
 
-Object* str_len(Object* self, const List* args) {
+Object* str_len(Object* self) {
     auto self_str = cast_to_str(self);
+    if (!self_str) return nullptr;
 
     return new Int(dep::UTF8String(self_str->val).size());
 }
 
-Object* str_is_alpha(Object* self, const List* args) {
+Object* str_is_alpha(Object* self, Args args) {
     auto self_str = cast_to_str(self);
+    if (!self_str) return nullptr;
     auto str = dep::UTF8String(self_str->val);
     bool is_alpha = true;
     for (const auto& c : str) {
@@ -221,8 +228,9 @@ Object* str_is_alpha(Object* self, const List* args) {
     return load_bool(is_alpha);
 }
 
-Object* str_is_digit(Object* self, const List* args) {
+Object* str_is_digit(Object* self, Args args) {
     auto self_str = cast_to_str(self);
+    if (!self_str) return nullptr;
     auto str = dep::UTF8String(self_str->val);
     bool is_digit = true;
     for (const auto& c : str) {
@@ -232,15 +240,12 @@ Object* str_is_digit(Object* self, const List* args) {
 
 }
 
-Object* str_substr(Object* self, const List* args) {
-    auto self_str = cast_to_str(self);
-    auto args_vec = args->val;
-    kiz::Vm::assert_argc(2, args);
-
-    size_t pos = cast_to_int(args_vec[0])->val.to_unsigned_long_long();
+Object* str_substr(Object* self, Args args) {
+    const auto self_str = static_cast<String*>(self);
+    size_t pos = static_cast<Int*>(args[0])->val.to_unsigned_long_long();
     size_t len = 1;
-    if (args_vec.size() > 1) {
-        len = cast_to_int(args_vec[1])->val.to_unsigned_long_long();
+    if (args.size() > 1) {
+        len = static_cast<Int*>(args[1])->val.to_unsigned_long_long();
     }
 
     return new String(dep::UTF8String(self_str->val).substr(
@@ -248,23 +253,27 @@ Object* str_substr(Object* self, const List* args) {
     ).to_string());
 }
 
-Object* str_to_lower(Object* self, const List* args) {
+Object* str_to_lower(Object* self, Args args) {
     auto self_str = cast_to_str(self);
+    if (!self_str) return nullptr;
 
     return new String(dep::UTF8String(self_str->val).to_lower().to_string());
 }
 
-Object* str_to_upper(Object* self, const List* args) {
+Object* str_to_upper(Object* self, Args args) {
     auto self_str = cast_to_str(self);
+    if (!self_str) return nullptr;
 
     return new String(dep::UTF8String(self_str->val).to_upper().to_string());
 
 }
 
-Object* str_format(Object* self, const List* args) {
-    auto format_str = cast_to_str(self)->val;
+Object* str_format(Object* self, Args args) {
+    const auto format_obj = cast_to_str(self);
+    if (!format_obj) return nullptr;
+    const auto& format_str = format_obj->val;
     std::vector<std::string> str_vec;
-    for (auto item : args->val) {
+    for (auto item : args) {
         str_vec.push_back(kiz::Vm::obj_to_str(item));
     }
 
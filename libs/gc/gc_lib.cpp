@@ -0,0 +1,101 @@
+#include "include/gc_lib.hpp"
+
+#include <string>
+#include "gc/gc.hpp"
+
+namespace gc_lib {
+
+namespace {
+
+constexpr auto INT = model::type_of<model::Int>;
+
+constexpr model::NativeDef gc_natives[] = {
+    {"collect", collect, {0, 1, {INT}}},
+    {"stats", stats, {0, 0}},
+    {"enable", enable, {0, 0}},
+    {"disable", disable, {0, 0}},
+    {"is_enabled", is_enabled, {0, 0}},
+    {"set_threshold", set_threshold, {1, 3, {INT, INT, INT}}},
+};
+
+// 不是非负小整数时以 raise 报告错误并返回false
+bool to_count(model::Object* obj, size_t& out) {
+    const auto& val = static_cast<model::Int*>(obj)->val;
+    if (!val.is_small() or val.small_value() < 0) {
+        kiz::Vm::raise("ValueError", "expect a non-negative integer");
+        return false;
+    }
+    out = static_cast<size_t>(val.small_value());
+    return true;
+}
+
+model::List* make_int_list(const std::array<size_t, kiz::Gc::GENERATIONS>& values) {
+    std::vector<model::Object*> items;
+    for (const auto v : values) items.push_back(new model::Int(v));
+    return new model::List(items);
+}
+
+} // namespace
+
+model::Object* init_module(model::Object* self, model::Args args) {
+    auto mod = new model::Module("gc");
+    model::def_natives(mod, gc_natives);
+    return mod;
+}
+
+// gc.collect(generation=2): 回收第 0..generation 代, 返回回收的对象数
+model::Object* collect(model::Object* self, model::Args args) {
+    size_t generation = kiz::Gc::GENERATIONS - 1;
+    if (!args.empty()) {
+        if (!to_count(args[0], generation)) return nullptr;
+        if (generation >= kiz::Gc::GENERATIONS)
+            return kiz::Vm::raise("ValueError", std::format("generation must be 0 to {}", kiz::Gc::GENERATIONS - 1));
+    }
+    return new model::Int(kiz::Gc::collect(generation));
+}
+
+model::Object* stats(model::Object* self, model::Args args) {
+    const auto& gc_stats = kiz::Gc::stats();
+    std::array<size_t, kiz::Gc::GENERATIONS> tracked{};
+    for (size_t g = 0; g < kiz::Gc::GENERATIONS; ++g) tracked[g] = kiz::Gc::tracked_count(g);
+
+    std::vector<std::pair<size_t, std::pair<model::Object*, model::Object*>>> elem_list;
+    auto insert = [&](const std::string& name, model::Object* value) {
+        elem_list.emplace_back(dep::hash_string(name),
+            std::pair {new model::String(name), value}
+        );
+    };
+    insert("tracked", make_int_list(tracked));
+    insert("collections", make_int_list(gc_stats.collections));
+    insert("collected", new model::Int(gc_stats.collected));
+    insert("full_passes", new model::Int(gc_stats.full_passes));
+    insert("thresholds", make_int_list(kiz::Gc::thresholds));
+    return new model::Dictionary(model::DictStore(elem_list));
+}
+
+model::Object* enable(model::Object* self, model::Args args) {
+    kiz::Gc::enabled = true;
+    return model::load_nil();
+}
+
+model::Object* disable(model::Object* self, model::Args args) {
+    kiz::Gc::enabled = false;
+    kiz::Gc::pending = false;
+    return model::load_nil();
+}
+
+model::Object* is_enabled(model::Object* self, model::Args args) {
+    return model::load_bool(kiz::Gc::enabled);
+}
+
+// gc.set_threshold(t0, [t1, [t2]])
+model::Object* set_threshold(model::Object* self, model::Args args) {
+    std::array<size_t, kiz::Gc::GENERATIONS> thresholds = kiz::Gc::thresholds;
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (!to_count(args[i], thresholds[i])) return nullptr;
+    }
+    kiz::Gc::thresholds = thresholds;
+    return model::load_nil();
+}
+
+} // namespace gc_lib
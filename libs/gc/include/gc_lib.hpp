@@ -0,0 +1,15 @@
+#pragma once
+#include "models/models.hpp"
+
+namespace gc_lib {
+
+model::Object* init_module(model::Object* self, model::Args args);
+
+model::Object* collect(model::Object* self, model::Args args);
+model::Object* stats(model::Object* self, model::Args args);
+model::Object* enable(model::Object* self, model::Args args);
+model::Object* disable(model::Object* self, model::Args args);
+model::Object* is_enabled(model::Object* self, model::Args args);
+model::Object* set_threshold(model::Object* self, model::Args args);
+
+}
@@ -5,17 +5,17 @@ namespace os_lib {
 
 inline std::vector<char*> rest_argv;
 
-model::Object* init_module(model::Object* self, const model::List* args);
+model::Object* init_module(model::Object* self, model::Args args);
 
-model::Object* get_args(model::Object* self, const model::List* args);
-model::Object* get_env(model::Object* self, const model::List* args);
-model::Object* exit_(model::Object* self, const model::List* args);
-model::Object* cwd(model::Object* self, const model::List* args);
+model::Object* get_args(model::Object* self, model::Args args);
+model::Object* get_env(model::Object* self, model::Args args);
+model::Object* exit_(model::Object* self, model::Args args);
+model::Object* cwd(model::Object* self, model::Args args);
 
-model::Object* chdir_(model::Object* self, const model::List* args);
-model::Object* mkdir_(model::Object* self, const model::List* args);
-model::Object* rmdir(model::Object* self, const model::List* args);
+model::Object* chdir_(model::Object* self, model::Args args);
+model::Object* mkdir_(model::Object* self, model::Args args);
+model::Object* rmdir(model::Object* self, model::Args args);
 
-model::Object* remove(model::Object* self, const model::List* args);
+model::Object* remove(model::Object* self, model::Args args);
 
 }
\ No newline at end of file
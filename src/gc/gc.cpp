@@ -0,0 +1,202 @@
+#include "gc.hpp"
+#include "../models/models.hpp"
+
+namespace kiz {
+
+std::array<size_t, Gc::GENERATIONS> Gc::thresholds {700, 10, 10};
+bool Gc::enabled = true;
+bool Gc::pending = false;
+
+std::array<std::vector<model::Object*>, Gc::SPACE_COUNT> Gc::spaces {};
+std::array<size_t, Gc::GENERATIONS> Gc::counts {};
+bool Gc::collecting = false;
+Gc::Stats Gc::stats_ {};
+
+void Gc::track(model::Object* obj) {
+    assert(obj->gc_space_ == UNTRACKED);
+    auto& young = spaces[YOUNG];
+    obj->gc_space_ = YOUNG;
+    obj->gc_index_ = static_cast<uint32_t>(young.size());
+    young.push_back(obj);
+    if (++counts[0] > thresholds[0] and enabled) pending = true;
+}
+
+void Gc::untrack(model::Object* obj) {
+    const auto space = obj->gc_space_;
+    if (space == UNTRACKED) return;
+    auto& objects = spaces[space];
+    const uint32_t idx = obj->gc_index_;
+    if (space == WORK) {
+        // 回收进行中, 保持其余对象的下标不变
+        objects[idx] = nullptr;
+    } else {
+        const auto last = objects.back();
+        objects[idx] = last;
+        last->gc_index_ = idx;
+        objects.pop_back();
+        if (space == YOUNG and counts[0] > 0) --counts[0];
+    }
+    obj->gc_space_ = UNTRACKED;
+}
+
+void Gc::move_to(model::Object* obj, const Space space) {
+    untrack(obj);
+    auto& objects = spaces[space];
+    obj->gc_space_ = space;
+    obj->gc_index_ = static_cast<uint32_t>(objects.size());
+    objects.push_back(obj);
+}
+
+void Gc::move_all(const Space from, const Space to) {
+    auto& src = spaces[from];
+    auto& dst = spaces[to];
+    for (const auto obj : src) {
+        if (!obj) continue;
+        obj->gc_space_ = to;
+        obj->gc_index_ = static_cast<uint32_t>(dst.size());
+        dst.push_back(obj);
+    }
+    src.clear();
+}
+
+void Gc::collect_pending() {
+    pending = false;
+    if (collecting or !enabled) return;
+    if (counts[1] < thresholds[1]) {
+        collect(0);
+    } else if (counts[2] < thresholds[2]) {
+        collect(1);
+    } else {
+        collect_increment();
+    }
+}
+
+size_t Gc::collect(const size_t generation) {
+    if (collecting) return 0;
+    collecting = true;
+
+    move_all(YOUNG, WORK);
+    if (generation >= 1) move_all(MIDDLE, WORK);
+    if (generation >= 2) {
+        move_all(OLD_PENDING, WORK);
+        move_all(OLD_SCANNED, WORK);
+    }
+    const size_t collected = collect_work(generation == 0 ? MIDDLE : OLD_SCANNED);
+    if (generation >= 2) ++stats_.full_passes;
+    finish(std::min(generation, GENERATIONS - 1), collected);
+    return collected;
+}
+
+void Gc::collect_increment() {
+    collecting = true;
+
+    move_all(YOUNG, WORK);
+    move_all(MIDDLE, WORK);
+
+    // 上一轮已扫描完时, 已扫描的一半成为新一轮的待扫描对象
+    auto& old_pending = spaces[OLD_PENDING];
+    if (old_pending.empty()) move_all(OLD_SCANNED, OLD_PENDING);
+
+    auto& work = spaces[WORK];
+    const size_t slice_begin = work.size();
+    for (size_t i = 0; i < INCREMENT_SIZE and !old_pending.empty(); ++i) {
+        move_to(old_pending.back(), WORK);
+    }
+    // 第 2 代中从这一片可达的对象一并纳入, 使跨片的引用环完整地出现在工作集中
+    for (size_t i = slice_begin; i < work.size(); ++i) {
+        work[i]->gc_traverse([](model::Object* child) {
+            if (child and (child->gc_space_ == OLD_PENDING or child->gc_space_ == OLD_SCANNED)) {
+                move_to(child, WORK);
+            }
+        });
+    }
+
+    const size_t collected = collect_work(OLD_SCANNED);
+    if (old_pending.empty()) ++stats_.full_passes;
+    finish(GENERATIONS - 1, collected);
+}
+
+size_t Gc::collect_work(const Space survivors) {
+    auto& work = spaces[WORK];
+    const size_t n = work.size();
+
+    // 引用计数减去来自工作集内部的引用, 剩下的就是外部引用
+    std::vector<ptrdiff_t> refs(n);
+    for (size_t i = 0; i < n; ++i) {
+        const size_t refc = work[i]->get_refc_();
+        refs[i] = refc == 0 ? 1 : static_cast<ptrdiff_t>(refc); // 尚未被持有的新对象视为外部可达
+    }
+    for (const auto obj : work) {
+        obj->gc_traverse([&](model::Object* child) {
+            if (child and child->gc_space_ == WORK) --refs[child->gc_index_];
+        });
+    }
+
+    // 从被外部引用的对象出发标记可达对象
+    std::vector<bool> reachable(n);
+    std::vector<model::Object*> stack;
+    for (size_t i = 0; i < n; ++i) {
+        if (refs[i] > 0) {
+            reachable[i] = true;
+            stack.push_back(work[i]);
+        }
+    }
+    while (!stack.empty()) {
+        const auto obj = stack.back();
+        stack.pop_back();
+        obj->gc_traverse([&](model::Object* child) {
+            if (child and child->gc_space_ == WORK and !reachable[child->gc_index_]) {
+                reachable[child->gc_index_] = true;
+                stack.push_back(child);
+            }
+        });
+    }
+
+    std::vector<model::Object*> garbage;
+    for (size_t i = 0; i < n; ++i) {
+        if (reachable[i]) {
+            move_to(work[i], survivors);
+        } else {
+            garbage.push_back(work[i]);
+        }
+    }
+
+    // 先持有全部垃圾对象, 再释放它们持有的引用打断引用环, 最后放手交给引用计数回收
+    for (const auto obj : garbage) obj->make_ref();
+    for (const auto obj : garbage) obj->gc_clear();
+    size_t collected = 0;
+    for (const auto obj : garbage) {
+        if (obj->get_refc_() == 1) ++collected;
+        obj->del_ref();
+    }
+
+    // 计数与实际引用不符而未被释放的对象留在存活者中
+    for (const auto obj : work) {
+        if (obj) move_to(obj, survivors);
+    }
+    work.clear();
+    return collected;
+}
+
+void Gc::finish(const size_t generation, const size_t collected) {
+    collecting = false;
+    pending = false;
+    ++stats_.collections[generation];
+    stats_.collected += collected;
+    for (size_t g = 0; g <= generation; ++g) counts[g] = 0;
+    if (generation + 1 < GENERATIONS) ++counts[generation + 1];
+}
+
+size_t Gc::tracked_count(const size_t generation) {
+    switch (generation) {
+    case 0: return spaces[YOUNG].size();
+    case 1: return spaces[MIDDLE].size();
+    default: return spaces[OLD_PENDING].size() + spaces[OLD_SCANNED].size();
+    }
+}
+
+const Gc::Stats& Gc::stats() {
+    return stats_;
+}
+
+} // namespace kiz
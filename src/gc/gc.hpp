@@ -0,0 +1,72 @@
+/**
+ * @file gc.hpp
+ * @brief 引用计数之上的分代循环垃圾回收器
+ *  * 只追踪可能构成引用环的容器对象: 脚本创建的普通对象、List、Dictionary、Function、Module;
+ *  * 采用试删除(trial deletion): 从每个对象的引用计数中减去来自被回收对象的内部引用,
+ *    剩余计数大于 0 的对象被外部持有, 从它们可达的对象存活, 其余对象释放所持引用后由引用计数回收;
+ *  * 新对象进入第 0 代, 每存活一次回收晋升一代; 第 2 代分片增量扫描, 单次暂停只处理一片及其在第 2 代内的可达闭包;
+ *  * 自动回收只发生在最外层调度循环的安全点(循环回边、函数调用), 此时存活对象都已被计数持有;
+ *    引用计数为 0 的对象(尚未被任何地方持有)一律视为外部可达。
+ *
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace model {
+class Object;
+}
+
+namespace kiz {
+
+class Gc {
+public:
+    static constexpr size_t GENERATIONS = 3;
+    static constexpr uint8_t UNTRACKED = 0xff;
+    static constexpr size_t INCREMENT_SIZE = 1024; // 第 2 代每片扫描的对象数(不含可达闭包)
+
+    struct Stats {
+        std::array<size_t, GENERATIONS> collections{}; // 各代回收次数, 第 2 代按增量片计
+        size_t collected = 0;   // 累计回收的对象数
+        size_t full_passes = 0; // 第 2 代完整扫描一遍的次数
+    };
+
+    ///| 第 0 代: 自上次回收以来新追踪的对象数; 第 1/2 代: 低一代的回收次数
+    static std::array<size_t, GENERATIONS> thresholds;
+    static bool enabled;
+    static bool pending; // 第 0 代超过阈值, 等待下一个安全点回收
+
+    static void track(model::Object* obj);
+    static void untrack(model::Object* obj);
+
+    ///| 安全点调用: 按阈值回收年轻代, 轮到第 2 代时附带扫描一片
+    static void collect_pending();
+    ///| 完整回收第 0..generation 代, 返回回收的对象数
+    static size_t collect(size_t generation = GENERATIONS - 1);
+
+    [[nodiscard]] static size_t tracked_count(size_t generation);
+    [[nodiscard]] static const Stats& stats();
+
+private:
+    // 对象所在空间: 第 2 代分为本轮待扫描与已扫描两半, WORK 为回收进行中的对象
+    enum Space : uint8_t { YOUNG, MIDDLE, OLD_PENDING, OLD_SCANNED, WORK, SPACE_COUNT };
+
+    static std::array<std::vector<model::Object*>, SPACE_COUNT> spaces;
+    static std::array<size_t, GENERATIONS> counts;
+    static bool collecting;
+    static Stats stats_;
+
+    static void move_to(model::Object* obj, Space space);
+    static void move_all(Space from, Space to);
+    static void collect_increment();
+    static void finish(size_t generation, size_t collected);
+    ///| 对 WORK 中的对象执行试删除, 存活者移入 survivors, 返回回收的对象数
+    static size_t collect_work(Space survivors);
+};
+
+} // namespace kiz
@@ -12,9 +12,9 @@ void IRGenerator::gen_expr(Expr* expr) {
         // 生成LOAD_CONST指令（加载字面量常量）
         auto const_obj = make_int_obj(dynamic_cast<NumberExpr*>(expr));
         size_t const_idx = get_or_add_const(const_obj);
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::LOAD_CONST,
-            std::vector{const_idx},
+            {const_idx},
             expr->pos
         );
         break;
@@ -23,9 +23,9 @@ void IRGenerator::gen_expr(Expr* expr) {
         // 生成LOAD_CONST指令（加载字面量常量）
         auto const_obj = make_string_obj(dynamic_cast<StringExpr*>(expr));
         size_t const_idx = get_or_add_const(const_obj);
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::LOAD_CONST,
-            std::vector{const_idx},
+            {const_idx},
             expr->pos
         );
         break;
@@ -34,9 +34,9 @@ void IRGenerator::gen_expr(Expr* expr) {
         // 生成LOAD_CONST指令（加载字面量常量）
         auto const_obj = make_decimal_obj(dynamic_cast<DecimalExpr*>(expr));
         size_t const_idx = get_or_add_const(const_obj);
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::LOAD_CONST,
-            std::vector{const_idx},
+            {const_idx},
             expr->pos
         );
         break;
@@ -47,9 +47,9 @@ void IRGenerator::gen_expr(Expr* expr) {
         const auto name_idx_it = std::ranges::find(code_chunks.back().var_names, ident->name);
         if (name_idx_it != code_chunks.back().var_names.end()) {
             size_t name_idx = std::distance(code_chunks.back().var_names.begin(), name_idx_it);
-            code_chunks.back().code_list.emplace_back(
+            emit(
                 Opcode::LOAD_VAR,
-                std::vector{name_idx},
+                {name_idx},
                 expr->pos
             );
         } else {
@@ -57,9 +57,9 @@ void IRGenerator::gen_expr(Expr* expr) {
             auto may_be_free_it = std::ranges::find(code_chunks.back().free_names, ident->name);
             if (may_be_free_it != code_chunks.back().free_names.end()) {
                 size_t name_idx = std::distance(code_chunks.back().free_names.begin(), may_be_free_it);
-                code_chunks.back().code_list.emplace_back(
+                emit(
                     Opcode::LOAD_FREE_VAR,
-                    std::vector{name_idx},
+                    {name_idx},
                     expr->pos
                 );
                 break;
@@ -80,9 +80,9 @@ void IRGenerator::gen_expr(Expr* expr) {
             if (!find_free_var_it) {
                 auto builtin_it = std::ranges::find(Vm::builtin_names, ident->name);
                 if (builtin_it != Vm::builtin_names.end()) {
-                    code_chunks.back().code_list.emplace_back(
+                    emit(
                         Opcode::LOAD_BUILTINS,
-                        std::vector{static_cast<size_t>(builtin_it - Vm::builtin_names.begin())},
+                        {static_cast<size_t>(builtin_it - Vm::builtin_names.begin())},
                         expr->pos
                     );
                     break;
@@ -91,9 +91,9 @@ void IRGenerator::gen_expr(Expr* expr) {
             } else {
                 code_chunks.back().free_names.push_back(ident->name);
                 code_chunks.back().upvalues.push_back({i, name_idx});
-                code_chunks.back().code_list.emplace_back(
+                emit(
                     Opcode::LOAD_FREE_VAR,
-                    std::vector{code_chunks.back().upvalues.size() - 1},
+                    {code_chunks.back().upvalues.size() - 1},
                     expr->pos
                 );
             }
@@ -106,10 +106,10 @@ void IRGenerator::gen_expr(Expr* expr) {
         if (bin_expr->op == "and"){
             gen_expr(bin_expr->left.get());  // 左操作数
 
-            code_chunks.back().code_list.emplace_back(Opcode::COPY_TOP, std::vector<size_t>{}, expr->pos);
+            emit(Opcode::COPY_TOP, {}, expr->pos);
 
             size_t jump_if_false_idx = code_chunks.back().code_list.size();
-            code_chunks.back().code_list.emplace_back(Opcode::JUMP_IF_FALSE, std::vector<size_t>{0}, expr->pos);
+            emit(Opcode::JUMP_IF_FALSE, {0}, expr->pos);
 
             gen_expr(bin_expr->right.get()); // 右操作数（栈中顺序：左在下，右在上）
             code_chunks.back().code_list[jump_if_false_idx].opn_list[0] = code_chunks.back().code_list.size();
@@ -118,11 +118,11 @@ void IRGenerator::gen_expr(Expr* expr) {
         if (bin_expr->op == "or") {
             gen_expr(bin_expr->left.get());  // 左操作数
 
-            code_chunks.back().code_list.emplace_back(Opcode::COPY_TOP, std::vector<size_t>{}, expr->pos);
+            emit(Opcode::COPY_TOP, {}, expr->pos);
 
-            code_chunks.back().code_list.emplace_back(Opcode::OP_NOT, std::vector<size_t>{}, expr->pos);
+            emit(Opcode::OP_NOT, {}, expr->pos);
             size_t jump_if_false_idx = code_chunks.back().code_list.size();
-            code_chunks.back().code_list.emplace_back(Opcode::JUMP_IF_FALSE, std::vector<size_t>{0}, expr->pos);
+            emit(Opcode::JUMP_IF_FALSE, {0}, expr->pos);
 
             gen_expr(bin_expr->right.get()); // 右操作数（栈中顺序：左在下，右在上）
             code_chunks.back().code_list[jump_if_false_idx].opn_list[0] = code_chunks.back().code_list.size();
@@ -153,9 +153,9 @@ void IRGenerator::gen_expr(Expr* expr) {
 
         else assert(false);
 
-        code_chunks.back().code_list.emplace_back(
+        emit(
             opc,
-            std::vector<size_t>{},
+            {},
             expr->pos
         );
         break;
@@ -170,9 +170,9 @@ void IRGenerator::gen_expr(Expr* expr) {
         else if (unary_expr->op == "not") opc = Opcode::OP_NOT;
         else assert(false);
 
-        code_chunks.back().code_list.emplace_back(
+        emit(
             opc,
-            std::vector<size_t>{},
+            {},
             expr->pos
         );
         break;
@@ -190,9 +190,9 @@ void IRGenerator::gen_expr(Expr* expr) {
             gen_expr(e.get());
         }
         // 生成 OP_MAKE_LIST 指令
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::MAKE_LIST,
-            std::vector{list_expr->elements.size()},
+            {list_expr->elements.size()},
             expr->pos
        );
         break;
@@ -202,9 +202,9 @@ void IRGenerator::gen_expr(Expr* expr) {
         auto get_mem = dynamic_cast<GetMemberExpr*>(expr);
         gen_expr(get_mem->father.get()); // 生成对象IR
         size_t name_idx = get_or_add_name(code_chunks.back().attr_names, get_mem->child->name);
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::GET_ATTR,
-            std::vector<size_t>{name_idx},
+            {name_idx},
             expr->pos
         );
         break;
@@ -213,22 +213,16 @@ void IRGenerator::gen_expr(Expr* expr) {
         auto get_mem_expr = dynamic_cast<GetItemExpr*>(expr);
         size_t arg_count = get_mem_expr->params.size();
 
+        // 下标直接留在操作数栈上, GET_ITEM 的操作数为下标个数
         for (auto& arg : get_mem_expr->params) {
             gen_expr(arg.get());
         }
 
-        // 生成 OP_MAKE_LIST 指令：将栈顶 arg_count 个元素打包成参数列表，压回栈
-        code_chunks.back().code_list.emplace_back(
-            Opcode::MAKE_LIST,
-            std::vector{arg_count},
-            get_mem_expr->pos
-        );
-
         gen_expr(get_mem_expr->father.get());
 
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::GET_ITEM,
-            std::vector<size_t>{},
+            {arg_count},
             get_mem_expr->pos
         );
         break;
@@ -250,14 +244,14 @@ void IRGenerator::gen_expr(Expr* expr) {
         if (code_chunks.back().code_list.empty() || code_chunks.back().code_list.back().opc != Opcode::RET) {
             const auto nil = model::load_nil();
             const size_t nil_idx = get_or_add_const(nil);
-            code_chunks.back().code_list.emplace_back(
+            emit(
                 Opcode::LOAD_CONST,
-                std::vector{nil_idx},
+                {nil_idx},
                 expr->pos
             );
-            code_chunks.back().code_list.emplace_back(
+            emit(
                 Opcode::RET,
-                std::vector<size_t>{},
+                {},
                 expr->pos
             );
         }
@@ -281,13 +275,15 @@ void IRGenerator::gen_expr(Expr* expr) {
 
         auto code_obj = new model::CodeObject(
             code_chunks.back().code_list,
+            code_chunks.back().positions,
             code_chunks.back().var_names,
             code_chunks.back().attr_names,
             code_chunks.back().free_names,
             code_chunks.back().upvalues,
             code_chunks.back().var_names.size(),
             code_chunks.back().exception_tables,
-            code_chunks.back().ensure_stmts
+            code_chunks.back().ensure_stmts,
+            code_chunks.back().ensure_positions
         );
         code_chunks.pop_back();
 
@@ -303,14 +299,14 @@ void IRGenerator::gen_expr(Expr* expr) {
 
         // 加载lambda函数对象
         const size_t fn_const_idx = get_or_add_const(lambda_fn);
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::LOAD_CONST,
-            std::vector{fn_const_idx},
+            {fn_const_idx},
             expr->pos
         );
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::CREATE_CLOSURE,
-            std::vector<size_t>{},
+            {},
             expr->pos
         );
         break;
@@ -318,9 +314,9 @@ void IRGenerator::gen_expr(Expr* expr) {
     case AstType::NilExpr : {
         const auto nil = model::load_nil();
         const size_t nil_idx = get_or_add_const(nil);
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::LOAD_CONST,
-            std::vector{nil_idx},
+            {nil_idx},
             expr->pos
         );
         break;
@@ -330,9 +326,9 @@ void IRGenerator::gen_expr(Expr* expr) {
         assert(bool_ast!=nullptr);
         const auto bool_obj = model::load_bool(bool_ast->val);
         const size_t bool_idx = get_or_add_const(bool_obj);
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::LOAD_CONST,
-            std::vector{bool_idx},
+            {bool_idx},
             expr->pos
         );
         break;
@@ -346,18 +342,11 @@ void IRGenerator::gen_fn_call(CallExpr* call_expr) {
     assert(call_expr && "gen_fn_call: 函数调用节点为空");
     size_t arg_count = call_expr->args.size();
 
-    // 生成所有参数的IR，最终打包成List（与原逻辑一致）
+    // 生成所有参数的IR: 实参按顺序留在操作数栈上, 由调用指令按个数直接取用, 不再打包成List
     for (auto& arg : call_expr->args) {
         gen_expr(arg.get());
     }
 
-    // 生成 OP_MAKE_LIST 指令：将栈顶 arg_count 个元素打包成参数列表，压回栈
-    code_chunks.back().code_list.emplace_back(
-        Opcode::MAKE_LIST,
-        std::vector<size_t>{arg_count},
-        call_expr->pos
-    );
-
     // 判断 callee 是否为 GetMemberExpr
     if (auto member_expr = dynamic_cast<GetMemberExpr*>(call_expr->callee.get())) {
         gen_expr(member_expr->father.get()); 
@@ -366,18 +355,23 @@ void IRGenerator::gen_fn_call(CallExpr* call_expr) {
         const std::string& method_name = member_expr->child->name;
         size_t method_name_idx = get_or_add_name(code_chunks.back().attr_names, method_name);
 
-        // 生成 CALL_METHOD 指令：操作数为 方法名索引 + 参数个数（用于校验）
-        code_chunks.back().code_list.emplace_back(
+        if (arg_count > CALL_METHOD_MAX_ARGC) {
+            err::error_reporter(file_path, call_expr->pos, "SyntaxError",
+                std::format("Too many arguments in method call (at most {})", CALL_METHOD_MAX_ARGC));
+        }
+
+        // 生成 CALL_METHOD 指令：操作数为 方法名索引, 实参个数 (CodeObject 会在第二个操作数的高位填入内联缓存下标)
+        emit(
             Opcode::CALL_METHOD,
-            std::vector{method_name_idx, arg_count},
+            {method_name_idx, arg_count},
             call_expr->pos
         );
     } else {
         // 普通函数调用：生成函数对象IR → 生成 CALL 指令
         gen_expr(call_expr->callee.get());
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::CALL,
-            std::vector{arg_count},
+            {arg_count},
             call_expr->pos
         );
     }
@@ -392,9 +386,9 @@ void IRGenerator::gen_dict(DictExpr* expr) {
     }
 
     size_t dict_size = expr->elements.size();
-    code_chunks.back().code_list.emplace_back(
+    emit(
         Opcode::MAKE_DICT,
-        std::vector{dict_size},
+        {dict_size},
         expr->pos
     );
 }
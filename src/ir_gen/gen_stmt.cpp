@@ -1,4 +1,5 @@
 #include <format>
+#include <optional>
 
 #include "../kiz.hpp"
 #include "../opcode/opcode.hpp"
@@ -29,17 +30,17 @@ void IRGenerator::gen_block(const BlockStmt* block) {
             const auto import_stmt = dynamic_cast<ImportStmt*>(stmt.get());
             const size_t name_idx = get_or_add_name(code_chunks.back().attr_names, import_stmt->path);
 
-            code_chunks.back().code_list.emplace_back(
+            emit(
                 Opcode::IMPORT,
-                std::vector{name_idx},
+                {name_idx},
                 stmt->pos
             );
 
             const size_t local_name_idx = get_or_add_name(code_chunks.back().var_names, import_stmt->var_name);
 
-            code_chunks.back().code_list.emplace_back(
+            emit(
                 Opcode::SET_LOCAL,
-                std::vector{local_name_idx},
+                {local_name_idx},
                 stmt->pos
             );
             break;
@@ -52,23 +53,20 @@ void IRGenerator::gen_block(const BlockStmt* block) {
             // 计算新生成的指令范围
             size_t new_size = code_chunks.back().code_list.size();
             if (new_size > old_size) {
-                //正向复制指令
-                std::vector<Instruction> defer_block;
-                defer_block.reserve(new_size - old_size);
-                for (size_t i = old_size; i < new_size; ++i) {
-                    defer_block.push_back(code_chunks.back().code_list[i]);
-                }
-
-                // 删除原code_list中的这些指令（保留顺序删除）
-                code_chunks.back().code_list.erase(
-                    code_chunks.back().code_list.begin() + old_size,
-                    code_chunks.back().code_list.end()
-                );
-
-                code_chunks.back().ensure_stmts.insert(
-                    code_chunks.back().ensure_stmts.begin(),
-                    defer_block.begin(),
-                    defer_block.end());
+                auto& chunk = code_chunks.back();
+                // 将新生成的指令及其位置信息整体前插到ensure_stmts（保留顺序）
+                chunk.ensure_stmts.insert(
+                    chunk.ensure_stmts.begin(),
+                    chunk.code_list.begin() + old_size,
+                    chunk.code_list.end());
+                chunk.ensure_positions.insert(
+                    chunk.ensure_positions.begin(),
+                    chunk.positions.begin() + old_size,
+                    chunk.positions.end());
+
+                // 删除原code_list中的这些指令
+                chunk.code_list.erase(chunk.code_list.begin() + old_size, chunk.code_list.end());
+                chunk.positions.erase(chunk.positions.begin() + old_size, chunk.positions.end());
             }
             break;
         }
@@ -78,9 +76,9 @@ void IRGenerator::gen_block(const BlockStmt* block) {
             gen_expr(var_decl->expr.get()); // 生成初始化表达式IR
             const size_t name_idx = get_or_add_name(code_chunks.back().var_names, var_decl->name);
 
-            code_chunks.back().code_list.emplace_back(
+            emit(
                 Opcode::SET_LOCAL,
-                std::vector{name_idx},
+                {name_idx},
                 stmt->pos
             );
             break;
@@ -94,9 +92,9 @@ void IRGenerator::gen_block(const BlockStmt* block) {
             auto may_be_free_it = std::ranges::find(code_chunks.back().free_names, var_decl->name);
             if (may_be_free_it != code_chunks.back().free_names.end()) {
                 size_t name_idx = std::distance(code_chunks.back().free_names.begin(), may_be_free_it);
-                code_chunks.back().code_list.emplace_back(
+                emit(
                     Opcode::SET_NONLOCAL,
-                    std::vector{name_idx},
+                    {name_idx},
                     stmt->pos
                 );
                 break;
@@ -117,9 +115,9 @@ void IRGenerator::gen_block(const BlockStmt* block) {
             if (find_free_var_it) {
                 code_chunks.back().free_names.push_back(var_decl->name);
                 code_chunks.back().upvalues.push_back({i, name_idx});
-                code_chunks.back().code_list.emplace_back(
+                emit(
                     Opcode::SET_NONLOCAL,
-                    std::vector{code_chunks.back().upvalues.size() - 1},
+                    {code_chunks.back().upvalues.size() - 1},
                     stmt->pos
                 );
             } else {
@@ -135,9 +133,9 @@ void IRGenerator::gen_block(const BlockStmt* block) {
             if (free_it != code_chunks.front().var_names.end()) {
                 size_t name_idx = std::distance(code_chunks.front().var_names.begin(), free_it);
                 gen_expr(var_decl->expr.get());
-                code_chunks.back().code_list.emplace_back(
+                emit(
                     Opcode::SET_GLOBAL,
-                    std::vector{name_idx},
+                    {name_idx},
                     stmt->pos
                 );
                 break;
@@ -176,15 +174,15 @@ void IRGenerator::gen_block(const BlockStmt* block) {
                 // 无返回值时压入Nil常量
                 auto nil = model::load_nil();
                 const size_t const_idx = get_or_add_const(nil);
-                code_chunks.back().code_list.emplace_back(
+                emit(
                     Opcode::LOAD_CONST,
-                    std::vector<size_t>{const_idx},
+                    {const_idx},
                     stmt->pos
                 );
             }
-            code_chunks.back().code_list.emplace_back(
+            emit(
                 Opcode::RET,
-                std::vector<size_t>{},
+                {},
                 stmt->pos
             );
             break;
@@ -192,9 +190,9 @@ void IRGenerator::gen_block(const BlockStmt* block) {
         case AstType::ThrowStmt: {
             auto throw_stmt = dynamic_cast<ThrowStmt*>(stmt.get());
             gen_expr(throw_stmt->expr.get());
-            code_chunks.back().code_list.emplace_back(
+            emit(
                 Opcode::THROW,
-                std::vector<size_t>{},
+                {},
                 stmt->pos
             );
             break;
@@ -204,9 +202,9 @@ void IRGenerator::gen_block(const BlockStmt* block) {
                 err::error_reporter(file_path, stmt->pos, "SyntaxError", "Break statement cannot use freely (must in while/for block)");
             }
             code_chunks.back().loop_info_stack.back().break_pos.push_back(code_chunks.back().code_list.size());
-            code_chunks.back().code_list.emplace_back(
+            emit(
                 Opcode::JUMP,
-                std::vector<size_t>{0},
+                {0},
                 stmt->pos
             );
             break;
@@ -220,9 +218,9 @@ void IRGenerator::gen_block(const BlockStmt* block) {
                 err::error_reporter(file_path, stmt->pos, "SyntaxError", "Next statement cannot use freely (must in while/for block)");
             }
             code_chunks.back().loop_info_stack.back().continue_pos.push_back(code_chunks.back().code_list.size());
-            code_chunks.back().code_list.emplace_back(
+            emit(
                 Opcode::JUMP,
-                std::vector<size_t>{0},
+                {0},
                 stmt->pos
             );
             break;
@@ -236,9 +234,9 @@ void IRGenerator::gen_block(const BlockStmt* block) {
             gen_expr(set_mem->val.get());   // 生成值IR
 
             size_t name_idx = get_or_add_name(code_chunks.back().attr_names, get_mem->child->name);
-            code_chunks.back().code_list.emplace_back(
+            emit(
                 Opcode::SET_ATTR,
-                std::vector<size_t>{name_idx},
+                {name_idx},
                 stmt->pos
             );
             break;
@@ -251,9 +249,9 @@ void IRGenerator::gen_block(const BlockStmt* block) {
             gen_expr(get_item->params[0].get()); // 生成第一参数(仅支持一个参数)
             gen_expr(set_item->val.get());   // 生成值IR
 
-            code_chunks.back().code_list.emplace_back(
+            emit(
                 Opcode::SET_ITEM,
-                std::vector<size_t>{},
+                {},
                 stmt->pos
             );
             break;
@@ -271,9 +269,9 @@ void IRGenerator::gen_if(IfStmt* if_stmt) {
 
     // 生成JUMP_IF_FALSE指令（目标先占位，后续填充）
     size_t jump_if_false_idx = code_chunks.back().code_list.size();
-    code_chunks.back().code_list.emplace_back(
+    emit(
         Opcode::JUMP_IF_FALSE,
-        std::vector<size_t>{0}, // 占位目标索引
+        {0}, // 占位目标索引
         if_stmt->pos
     );
 
@@ -282,9 +280,9 @@ void IRGenerator::gen_if(IfStmt* if_stmt) {
 
     // 生成JUMP指令（跳过else块，目标占位）
     size_t jump_else_idx = code_chunks.back().code_list.size();
-    code_chunks.back().code_list.emplace_back(
+    emit(
         Opcode::JUMP,
-        std::vector<size_t>{0}, // 占位目标索引
+        {0}, // 占位目标索引
         if_stmt->pos
     );
 
@@ -315,14 +313,14 @@ void IRGenerator::gen_fn_decl(NamedFuncDeclStmt* func) {
     if (code_chunks.back().code_list.empty() || code_chunks.back().code_list.back().opc != Opcode::RET) {
         const auto nil = model::load_nil();
         const size_t nil_idx = get_or_add_const(nil);
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::LOAD_CONST,
-            std::vector{nil_idx},
+            {nil_idx},
             func->pos
         );
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::RET,
-            std::vector<size_t>{},
+            {},
             func->pos
         );
     }
@@ -346,13 +344,15 @@ void IRGenerator::gen_fn_decl(NamedFuncDeclStmt* func) {
 
     auto code_obj = new model::CodeObject(
         code_chunks.back().code_list,
+        code_chunks.back().positions,
         code_chunks.back().var_names,
         code_chunks.back().attr_names,
         code_chunks.back().free_names,
         code_chunks.back().upvalues,
         code_chunks.back().var_names.size(),
         code_chunks.back().exception_tables,
-        code_chunks.back().ensure_stmts
+        code_chunks.back().ensure_stmts,
+        code_chunks.back().ensure_positions
     );
     code_chunks.pop_back();
 
@@ -368,29 +368,36 @@ void IRGenerator::gen_fn_decl(NamedFuncDeclStmt* func) {
 
     // 加载函数对象
     const size_t fn_const_idx = get_or_add_const(fn);
-    code_chunks.back().code_list.emplace_back(
+    emit(
         Opcode::LOAD_CONST,
-        std::vector{fn_const_idx},
+        {fn_const_idx},
         func->pos
     );
 
     const size_t name_idx = get_or_add_name(code_chunks.back().var_names, func->name);
 
-    code_chunks.back().code_list.emplace_back(
+    emit(
         Opcode::SET_LOCAL,
-        std::vector{name_idx},
+        {name_idx},
         func->pos
     );
 
-    code_chunks.back().code_list.emplace_back(
+    emit(
         Opcode::LOAD_VAR,
-        std::vector{name_idx},
+        {name_idx},
         func->pos
     );
 
-    code_chunks.back().code_list.emplace_back(
+    emit(
         Opcode::CREATE_CLOSURE,
-        std::vector<size_t>{},
+        {},
+        func->pos
+    );
+
+    // 捕获了自由变量的函数会得到新的函数对象, 重新绑定到函数名上
+    emit(
+        Opcode::SET_LOCAL,
+        {name_idx},
         func->pos
     );
 }
@@ -398,46 +405,46 @@ void IRGenerator::gen_fn_decl(NamedFuncDeclStmt* func) {
 void IRGenerator::gen_object_stmt(ObjectStmt* obj_decl) {
     const size_t name_idx = get_or_add_name(code_chunks.back().var_names, obj_decl->name);
 
-    code_chunks.back().code_list.emplace_back(
+    emit(
         Opcode::CREATE_OBJECT,
-        std::vector<size_t>{},
+        {},
         obj_decl->pos
     );
 
-    code_chunks.back().code_list.emplace_back(
+    emit(
         Opcode::SET_LOCAL,
-        std::vector{name_idx},
+        {name_idx},
         obj_decl->pos
     );
 
     if (!obj_decl->parent_name.empty()) {
         const size_t parent_name_idx = get_or_add_name(code_chunks.back().var_names, obj_decl->parent_name);
 
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::LOAD_VAR,
-            std::vector{name_idx},
+            {name_idx},
             obj_decl->pos
         );
 
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::LOAD_VAR,
-            std::vector{parent_name_idx},
+            {parent_name_idx},
             obj_decl->pos
         );
 
         const size_t parent_text_idx = get_or_add_name(code_chunks.back().attr_names, "__parent__");
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::SET_ATTR,
-            std::vector{parent_text_idx},
+            {parent_text_idx},
             obj_decl->pos
         );
     }
 
     for (const auto& sub_assign: obj_decl->body->statements) {
         if (const auto sub_assign_stmt = dynamic_cast<AssignStmt*>(sub_assign.get())) {
-            code_chunks.back().code_list.emplace_back(
+            emit(
                 Opcode::LOAD_VAR,
-                std::vector{name_idx},
+                {name_idx},
                 obj_decl->pos
             );
             assert(sub_assign_stmt->expr.get());
@@ -445,33 +452,35 @@ void IRGenerator::gen_object_stmt(ObjectStmt* obj_decl) {
 
             const size_t sub_name_idx = get_or_add_name(code_chunks.back().attr_names, sub_assign_stmt->name);
 
-            code_chunks.back().code_list.emplace_back(
+            emit(
                 Opcode::SET_ATTR,
-                std::vector{sub_name_idx},
+                {sub_name_idx},
                 obj_decl->pos
             );
         } else if (auto f_decl = dynamic_cast<NamedFuncDeclStmt*>(sub_assign.get())) {
             gen_fn_decl(f_decl);
             // 定位到set local指令
-            auto set_func_instr = code_chunks.back().code_list[code_chunks.back().code_list.size() - 3];
-            code_chunks.back().code_list.emplace_back(
+            const size_t set_func_pc = code_chunks.back().code_list.size() - 3;
+            auto set_func_instr = code_chunks.back().code_list[set_func_pc];
+            auto set_func_pos = code_chunks.back().positions[set_func_pc];
+            emit(
                 Opcode::LOAD_VAR,
-                std::vector{name_idx},
-                set_func_instr.pos
+                {name_idx},
+                set_func_pos
             );
 
-            code_chunks.back().code_list.emplace_back(
+            emit(
                 Opcode::LOAD_VAR,
-                std::vector{set_func_instr.opn_list[0]},
-                set_func_instr.pos
+                {set_func_instr.opn_list[0]},
+                set_func_pos
             );
 
             auto sub_func_name = code_chunks.back().var_names[set_func_instr.opn_list[0]];
             auto sub_func_name_idx = get_or_add_name(code_chunks.back().attr_names, sub_func_name);
-            code_chunks.back().code_list.emplace_back(
+            emit(
                 Opcode::SET_ATTR,
-                std::vector{sub_func_name_idx},
-                set_func_instr.pos
+                {sub_func_name_idx},
+                set_func_pos
             );
         } else {
             err::error_reporter(file_path, obj_decl->pos,
@@ -492,9 +501,9 @@ void IRGenerator::gen_while(WhileStmt* while_stmt) {
 
     // 生成JUMP_IF_FALSE指令（目标：循环结束位置，先占位）
     const size_t jump_if_false_idx = code_chunks.back().code_list.size();
-    code_chunks.back().code_list.emplace_back(
+    emit(
         Opcode::JUMP_IF_FALSE,
-        std::vector<size_t>{0}, // 占位，后续填充为循环结束位置
+        {0}, // 占位，后续填充为循环结束位置
         while_stmt->pos
     );
 
@@ -505,9 +514,9 @@ void IRGenerator::gen_while(WhileStmt* while_stmt) {
     gen_block(while_stmt->body.get());
 
     // 生成JUMP指令，跳回循环入口
-    code_chunks.back().code_list.emplace_back(
+    emit(
         Opcode::JUMP,
-        std::vector<size_t>{loop_entry_idx},
+        {loop_entry_idx},
         while_stmt->pos
     );
 
@@ -532,53 +541,54 @@ void IRGenerator::gen_for(ForStmt* for_stmt) {
     // 生成循环iter IR
     gen_expr(for_stmt->iter.get());
 
-    code_chunks.back().code_list.emplace_back(
+    emit(
         Opcode::CACHE_ITER,
-        std::vector<size_t>{},
+        {},
         for_stmt->pos
     );
 
     // 记录循环入口（条件判断开始位置）→ continue跳这里
     size_t loop_entry_idx = code_chunks.back().code_list.size();
 
-    code_chunks.back().code_list.emplace_back(
-        Opcode::MAKE_LIST,
-        std::vector<size_t>{0},
-        for_stmt->pos
-    );
-
-    code_chunks.back().code_list.emplace_back(
-        Opcode::GET_ITER,
-        std::vector<size_t>{},
-        for_stmt->pos
-    );
+    size_t var_name_idx = get_or_add_name(code_chunks.back().var_names, for_stmt->item_var_name);
 
-    size_t name_idx = get_or_add_name(code_chunks.back().attr_names, "__next__");
+    // for i in range(...): 先尝试计数循环, range被遮蔽时FOR_RANGE顺序执行下面的通用取值指令
+    const auto iter_call = dynamic_cast<CallExpr*>(for_stmt->iter.get());
+    const auto iter_callee = iter_call ? dynamic_cast<IdentifierExpr*>(iter_call->callee.get()) : nullptr;
+    std::optional<size_t> for_range_idx;
+    if (iter_callee and iter_callee->name == "range") {
+        for_range_idx = code_chunks.back().code_list.size();
+        emit(
+            Opcode::FOR_RANGE,
+            {var_name_idx, 0}, // 循环结束位置占位，后续填充
+            for_stmt->pos
+        );
+    }
 
-    code_chunks.back().code_list.emplace_back(
-        Opcode::CALL_METHOD,
-        std::vector{name_idx},
+    // 取迭代器的下一个元素
+    emit(
+        Opcode::GET_ITER,
+        {},
         for_stmt->pos
     );
 
-    size_t var_name_idx = get_or_add_name(code_chunks.back().var_names, for_stmt->item_var_name);
-    code_chunks.back().code_list.emplace_back(
+    emit(
         Opcode::SET_LOCAL,
-        std::vector{var_name_idx},
+        {var_name_idx},
         for_stmt->pos
     );
 
-    code_chunks.back().code_list.emplace_back(
+    emit(
         Opcode::LOAD_VAR,
-        std::vector{var_name_idx},
+        {var_name_idx},
         for_stmt->pos
     );
 
     // 生成JUMP_IF_FALSE指令（目标：循环结束位置，先占位）
     const size_t jump_if_false_idx = code_chunks.back().code_list.size();
-    code_chunks.back().code_list.emplace_back(
+    emit(
         Opcode::JUMP_IF_FINISH_ITER,
-        std::vector<size_t>{0}, // 占位，后续填充为循环结束位置
+        {0}, // 占位，后续填充为循环结束位置
         for_stmt->pos
     );
 
@@ -589,19 +599,30 @@ void IRGenerator::gen_for(ForStmt* for_stmt) {
     gen_block(for_stmt->body.get());
 
     // 生成JUMP指令，跳回循环入口
-    code_chunks.back().code_list.emplace_back(
+    emit(
         Opcode::JUMP,
-        std::vector{loop_entry_idx},
+        {loop_entry_idx},
         for_stmt->pos
     );
 
     // 填充JUMP_IF_FALSE的目标（循环结束位置 = 当前代码列表长度）
     size_t loop_exit_idx = code_chunks.back().code_list.size();
     code_chunks.back().code_list[jump_if_false_idx].opn_list[0] = loop_exit_idx;
+    if (for_range_idx) {
+        // FOR_RANGE的快速路径按固定长度跳过通用取值指令, 生成的序列必须与 FOR_RANGE_GENERIC_SEQ 一致
+        const auto& code_list = code_chunks.back().code_list;
+        if (jump_if_false_idx - *for_range_idx != FOR_RANGE_GENERIC_LEN
+            or !std::equal(std::begin(FOR_RANGE_GENERIC_SEQ), std::end(FOR_RANGE_GENERIC_SEQ),
+                code_list.begin() + static_cast<std::ptrdiff_t>(*for_range_idx + 1),
+                [](const Opcode expected, const Instruction& instr) { return instr.opc == expected; })) {
+            throw KizStopRunningSignal("gen_for: instructions after FOR_RANGE do not match FOR_RANGE_GENERIC_SEQ");
+        }
+        code_chunks.back().code_list[*for_range_idx].opn_list[1] = loop_exit_idx;
+    }
 
-    code_chunks.back().code_list.emplace_back(
+    emit(
         Opcode::POP_ITER,
-        std::vector<size_t>{},
+        {},
         for_stmt->pos
     );
 
@@ -625,9 +646,9 @@ void IRGenerator::gen_try(TryStmt* try_stmt) {
     gen_block(try_stmt->try_block.get());
 
     size_t jump_to_finally_idx = code_chunks.back().code_list.size();
-    code_chunks.back().code_list.emplace_back(
+    emit(
         Opcode::JUMP,
-        std::vector<size_t>{0},
+        {0},
         try_stmt->pos
     );
 
@@ -642,30 +663,30 @@ void IRGenerator::gen_try(TryStmt* try_stmt) {
 
         size_t name_idx = get_or_add_name(code_chunks.back().var_names, catch_stmt->var_name);
 
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::LOAD_ERROR,
-            std::vector<size_t>{},
+            {},
             try_stmt->pos
         );
 
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::SET_LOCAL,
-            std::vector{name_idx},
+            {name_idx},
             try_stmt->pos
         );
         gen_block(catch_stmt->catch_block.get());
 
         catch_jump_to_finally_pcs.push_back(code_chunks.back().code_list.size());
-        code_chunks.back().code_list.emplace_back(
+        emit(
             Opcode::JUMP,
-            std::vector<size_t>{0},
+            {0},
             try_stmt->pos
         );
     }
 
     exception_table.mismatch_pc = code_chunks.back().code_list.size();
-    code_chunks.back().code_list.emplace_back( Opcode::LOAD_ERROR, std::vector<size_t>{}, try_stmt->pos);
-    code_chunks.back().code_list.emplace_back(Opcode::THROW, std::vector<size_t>{}, try_stmt->pos);
+    emit( Opcode::LOAD_ERROR, {}, try_stmt->pos);
+    emit(Opcode::THROW, {}, try_stmt->pos);
 
     code_chunks.back().exception_tables.push_back(exception_table);
 
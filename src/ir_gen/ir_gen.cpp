@@ -27,6 +27,16 @@ size_t IRGenerator::get_or_add_name(std::vector<std::string>& names, const std::
     return names.size() - 1;
 }
 
+size_t IRGenerator::get_or_add_name(std::vector<dep::Symbol>& names, const std::string& name) {
+    const auto sym = dep::intern(name);
+    auto it = std::ranges::find(names, sym);
+    if (it != names.end()) {
+        return std::distance(names.begin(), it);
+    }
+    names.emplace_back(sym);
+    return names.size() - 1;
+}
+
 // 辅助函数：获取常量在curr_const中的索引（不存在则添加）
 size_t IRGenerator::get_or_add_const(model::Object* obj) {
     obj->mark_as_important();
@@ -72,18 +82,41 @@ model::CodeObject* IRGenerator::gen(std::unique_ptr<BlockStmt> ast_into, const s
 
     auto code_obj = new model::CodeObject(
         code_chunks.back().code_list,
+        code_chunks.back().positions,
         code_chunks.back().var_names,
         code_chunks.back().attr_names,
         code_chunks.back().free_names,
         code_chunks.back().upvalues,
         code_chunks.back().var_names.size(),
         code_chunks.back().exception_tables,
-        code_chunks.back().ensure_stmts
+        code_chunks.back().ensure_stmts,
+        code_chunks.back().ensure_positions
     );
 
     return code_obj;
 }
 
+void IRGenerator::emit(Opcode opc, std::initializer_list<size_t> opn_list, const err::PositionInfo& pos) {
+    assert(!code_chunks.empty());
+    auto& code_list = code_chunks.back().code_list;
+    // 操作数内联为32位, 超出范围时报错而不是截断; 跳转目标不超过指令数, 因此指令数也须在范围内
+    if (opn_list.size() > 2) {
+        err::error_reporter(file_path, pos, "CompileError",
+            "instruction " + opcode_to_string(opc) + " takes at most 2 operands");
+    }
+    for (const auto opn : opn_list) {
+        if (opn > UINT32_MAX) {
+            err::error_reporter(file_path, pos, "CompileError",
+                "operand of instruction " + opcode_to_string(opc) + " is out of range (too many names, constants or instructions)");
+        }
+    }
+    if (code_list.size() >= UINT32_MAX) {
+        err::error_reporter(file_path, pos, "CompileError", "code block has too many instructions");
+    }
+    code_list.emplace_back(opc, opn_list);
+    code_chunks.back().positions.push_back(pos);
+}
+
 model::Int* IRGenerator::make_int_obj(const NumberExpr* num_expr) {
     DEBUG_OUTPUT("making int object...");
     assert(num_expr);
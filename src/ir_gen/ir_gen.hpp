@@ -25,15 +25,17 @@ struct LoopInfo {
 
 struct CodeChunk {
     std::vector<std::string> var_names;
-    std::vector<std::string> attr_names;
+    std::vector<dep::Symbol> attr_names;
     std::vector<std::string> free_names;
 
     std::vector<Instruction> code_list;
+    std::vector<err::PositionInfo> positions; // 与code_list一一对应, 生成CodeObject时压缩为LineTable
     std::vector<LoopInfo> loop_info_stack;
     std::vector<model::UpValue> upvalues;
 
     std::vector<model::ExceptionTable> exception_tables;
     std::vector<Instruction> ensure_stmts;
+    std::vector<err::PositionInfo> ensure_positions;
 };
 
 class IRGenerator {
@@ -45,6 +47,7 @@ public:
     model::CodeObject* gen(std::unique_ptr<BlockStmt> ast_into, const std::vector<std::string>& global_var_names_into = {});
 
     static size_t get_or_add_name(std::vector<std::string>& names, const std::string& name);
+    static size_t get_or_add_name(std::vector<dep::Symbol>& names, const std::string& name); // 属性名在编译期驻留为符号
     static size_t get_or_add_const(model::Object* obj);
     [[nodiscard]] static model::Module* gen_mod(
         const std::string& module_name, model::CodeObject* module_code
@@ -52,6 +55,8 @@ public:
     std::vector<std::string> get_global_var_names();
 
 private:
+    void emit(Opcode opc, std::initializer_list<size_t> opn_list, const err::PositionInfo& pos);
+
     void gen_for(ForStmt* for_stmt);
     void gen_try(TryStmt* try_stmt);
     void gen_block(const BlockStmt* block);
@@ -7,45 +7,59 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
 #include <format>
 #include <fstream>
 #include <functional>
 #include <iomanip>
+#include <memory>
 #include <ranges>
 #include <utility>
 
 #include "../kiz.hpp"
 #include "../vm/vm.hpp"
+#include "../gc/gc.hpp"
+#include "../opcode/opcode.hpp"
+#include "type_slots.hpp"
 #include "../../depends/hashmap.hpp"
+#include "../../depends/pool.hpp"
 #include "../../depends/bigint.hpp"
 #include "../../depends/decimal.hpp"
 #include "../../depends/dict.hpp"
+#include "../../depends/shape.hpp"
+#include "../../depends/symbol.hpp"
 
 
 namespace model {
 
+///| 魔术方法名等常用属性名, 启动时驻留为符号
 namespace magic_name {
-    constexpr auto add = "__add__";
-    constexpr auto sub = "__sub__";
-    constexpr auto mul = "__mul__";
-    constexpr auto div = "__div__";
-    constexpr auto pow = "__pow__";
-    constexpr auto mod = "__mod__";
-    constexpr auto eq = "__eq__";
-    constexpr auto lt = "__lt__";
-    constexpr auto gt = "__gt__";
-
-    constexpr auto parent = "__parent__";
-    constexpr auto call = "__call__";
-    constexpr auto bool_of = "__bool__";
-    constexpr auto str = "__str__";
-    constexpr auto debug_str = "__dstr__";
-    constexpr auto getitem = "__getitem__";
-    constexpr auto setitem = "__setitem__";
-    constexpr auto contains = "contains";  // contains不是魔术方法
-    constexpr auto next_item = "__next__";
-    constexpr auto hash = "__hash__";
+    inline const dep::Symbol add = dep::intern("__add__");
+    inline const dep::Symbol sub = dep::intern("__sub__");
+    inline const dep::Symbol mul = dep::intern("__mul__");
+    inline const dep::Symbol div = dep::intern("__div__");
+    inline const dep::Symbol pow = dep::intern("__pow__");
+    inline const dep::Symbol mod = dep::intern("__mod__");
+    inline const dep::Symbol neg = dep::intern("__neg__");
+    inline const dep::Symbol eq = dep::intern("__eq__");
+    inline const dep::Symbol lt = dep::intern("__lt__");
+    inline const dep::Symbol gt = dep::intern("__gt__");
+
+    inline const dep::Symbol parent = dep::intern("__parent__");
+    inline const dep::Symbol call = dep::intern("__call__");
+    inline const dep::Symbol bool_of = dep::intern("__bool__");
+    inline const dep::Symbol str = dep::intern("__str__");
+    inline const dep::Symbol debug_str = dep::intern("__dstr__");
+    inline const dep::Symbol getitem = dep::intern("__getitem__");
+    inline const dep::Symbol setitem = dep::intern("__setitem__");
+    inline const dep::Symbol contains = dep::intern("contains");  // contains不是魔术方法
+    inline const dep::Symbol iter = dep::intern("__iter__");
+    inline const dep::Symbol next_item = dep::intern("__next__");
+    inline const dep::Symbol hash = dep::intern("__hash__");
+    inline const dep::Symbol name = dep::intern("__name__");
+    inline const dep::Symbol msg = dep::intern("__msg__");
 }
 
 // 工具函数ptr转为地址的字符串
@@ -76,26 +90,187 @@ struct ExceptionTable {
     size_t mismatch_pc;
 };
 
-class Object {
-    std::atomic<size_t> refc_ = 0;
-    bool is_important = false; // 重要对象不参与make_refc/del_refc
+class Object;
+
+///| 对象自有属性表
+///| 默认为 Shape 模式: 属性名布局由共享的 Shape 描述, 属性值按槽位紧凑存放;
+///| 属性数超过 MAX_SHAPE_SLOTS 后退化为字典模式, 避免动态属性过多的对象撑大转换树
+class AttrTable {
+    dep::Shape* shape_ = dep::Shape::root(); // 字典模式下为 nullptr
+    std::vector<Object*> slots_;
+    std::unique_ptr<dep::HashMap<Object*>> dict_;
+
+    void to_dict_mode() {
+        dict_ = std::make_unique<dep::HashMap<Object*>>();
+        const auto& keys = shape_->keys();
+        for (size_t i = 0; i < keys.size(); ++i) {
+            dict_->insert(keys[i].str(), slots_[i], keys[i].hash());
+        }
+        slots_.clear();
+        slots_.shrink_to_fit();
+        shape_ = nullptr;
+    }
+
 public:
-    dep::HashMap<Object*> attrs;
+    static constexpr size_t MAX_SHAPE_SLOTS = 32;
+
+    ///| 当前 Shape, 字典模式下返回 nullptr
+    [[nodiscard]] dep::Shape* shape() const {
+        return shape_;
+    }
+
+    [[nodiscard]] Object* slot_at(const uint32_t idx) const {
+        return slots_[idx];
+    }
+
+    void set_slot(const uint32_t idx, Object* o) {
+        slots_[idx] = o;
+    }
 
-    // 对象类型枚举
-    enum class ObjectType {
+    ///| 按已知的转换结果追加属性(next 必须是当前 Shape 添加一个属性后的结果)
+    void append(dep::Shape* next, Object* o) {
+        assert(shape_ and next->size() == slots_.size() + 1);
+        shape_ = next;
+        slots_.push_back(o);
+    }
+
+    ///| 属性值所在位置, 未找到返回 nullptr(指针在下一次增删前有效)
+    [[nodiscard]] Object** find(const dep::Symbol name) {
+        if (shape_) {
+            const uint32_t idx = shape_->slot_of(name);
+            return idx == dep::Shape::NOT_FOUND ? nullptr : &slots_[idx];
+        }
+        const auto it = dict_->find(name.str(), name.hash());
+        return it ? &it->value : nullptr;
+    }
+
+    ///| 添加新属性(调用方保证 name 尚不存在)
+    void add(const dep::Symbol name, Object* o) {
+        if (shape_ and shape_->size() >= MAX_SHAPE_SLOTS) {
+            to_dict_mode();
+        }
+        if (shape_) {
+            shape_ = shape_->with_added(name);
+            slots_.push_back(o);
+            return;
+        }
+        dict_->insert(name.str(), o, name.hash());
+    }
+
+    ///| 删除属性, 返回被删除的值(不存在返回 nullptr)
+    Object* remove(const dep::Symbol name) {
+        if (shape_) {
+            const uint32_t idx = shape_->slot_of(name);
+            if (idx == dep::Shape::NOT_FOUND) return nullptr;
+            Object* old_val = slots_[idx];
+            slots_.erase(slots_.begin() + idx);
+            shape_ = shape_->without(name);
+            return old_val;
+        }
+        const auto it = dict_->find(name.str(), name.hash());
+        if (!it) return nullptr;
+        Object* old_val = it->value;
+        dict_->del(name.str(), name.hash());
+        return old_val;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return shape_ ? slots_.size() : dict_->size();
+    }
+
+    template <typename F>
+    void for_each_value(F&& f) const {
+        if (shape_) {
+            for (const auto obj : slots_) f(obj);
+            return;
+        }
+        for (const auto& obj : dict_->to_vector() | std::views::values) f(obj);
+    }
+
+    [[nodiscard]] std::vector<std::pair<std::string, Object*>> to_vector() const {
+        if (!shape_) return dict_->to_vector();
+        std::vector<std::pair<std::string, Object*>> vec;
+        vec.reserve(slots_.size());
+        const auto& keys = shape_->keys();
+        for (size_t i = 0; i < keys.size(); ++i) {
+            vec.emplace_back(keys[i].str(), slots_[i]);
+        }
+        return vec;
+    }
+};
+
+class Object {
+public:
+    // 对象类型枚举, 新增类型时需同步更新 OBJECT_TYPE_COUNT
+    enum class ObjectType : uint8_t {
         Object, Nil, Bool, Int, String, Decimal,
         List, Dictionary, CodeObject, Function,
-        NativeFunction, Module, Error
+        NativeFunction, Module, Error, Iterator,
+        Range, FileHandle
     };
 
+private:
+    // 引用计数: 默认解释器是单线程的, 使用普通整数; 定义 KIZ_ATOMIC_REFCOUNT 时改用原子计数
+#ifdef KIZ_ATOMIC_REFCOUNT
+    std::atomic<size_t> refc_ = 0;
+#else
+    size_t refc_ = 0;
+#endif
+    bool is_proto_ = false; // 曾被用作其他对象的 __parent__
+    ObjectType type_ = ObjectType::Object; // 类型标签, 由子类在构造时写入, 替代虚函数与 dynamic_cast 做类型分派
+    uint8_t gc_space_ = kiz::Gc::UNTRACKED; // 循环回收器中所在的代, 见 kiz::Gc
+    uint32_t gc_index_ = 0; // 在所在代对象表中的下标
+    friend class kiz::Gc;
+    Object* parent_ = nullptr; // 原型链上的父对象, 即脚本中的 __parent__
+    std::unique_ptr<AttrTable> attrs_; // 属性表, 第一次写入属性时才分配
+
+    // 原型的属性或原型链发生变化, 使所有内联缓存失效; 改写的是内置原型时同时停用槽位表
+    void touch_proto() const {
+        if (!is_proto_) return;
+        ++kiz::Vm::proto_epoch;
+        if (is_important()) kiz::Vm::builtin_slots_valid = false;
+    }
+
+public:
+
+    // 所有模型对象从按大小分级的对象池分配; 虚析构函数保证 delete 时传入的是实际类型的大小
+    static void* operator new(const size_t size) {
+        return dep::ObjectPool::allocate(size);
+    }
+    static void operator delete(void* p, const size_t size) noexcept {
+        dep::ObjectPool::deallocate(p, size);
+    }
+
+    // 重要(永生)对象的引用计数从该哨兵值起步, 增减永远不会使其归零, make_ref/del_ref 因此无需额外判断
+    static constexpr size_t IMMORTAL_REFC = SIZE_MAX / 2;
+
     void mark_as_important() {
-        is_important = true;
+        refc_ = IMMORTAL_REFC;
+        if (gc_space_ != kiz::Gc::UNTRACKED) kiz::Gc::untrack(this); // 永生对象不会被回收, 也不必再扫描
+    }
+
+    [[nodiscard]] bool is_important() const {
+        return refc_ >= IMMORTAL_REFC / 2;
+    }
+
+    [[nodiscard]] ObjectType get_type() const {
+        return type_;
+    }
+
+    ///| 按类型标签判断/转换, 只适用于声明了 TYPE 的模型类型; 迭代器子类共用 Iterator 标签, 需再比较 NativeIterator::kind
+    template <typename T>
+    [[nodiscard]] bool is() const {
+        return type_ == T::TYPE;
+    }
+
+    template <typename T>
+    [[nodiscard]] T* as() {
+        return type_ == T::TYPE ? static_cast<T*>(this) : nullptr;
     }
 
-    // 获取实际类型的虚函数
-    [[nodiscard]] virtual ObjectType get_type() const {
-        return ObjectType::Object;
+    template <typename T>
+    [[nodiscard]] const T* as() const {
+        return type_ == T::TYPE ? static_cast<const T*>(this) : nullptr;
     }
 
     [[nodiscard]] size_t get_refc_() const {
@@ -103,38 +278,221 @@ public:
     }
     
     void make_ref() {
-        if (is_important) return;
+#ifdef KIZ_ATOMIC_REFCOUNT
         refc_.fetch_add(1, std::memory_order_relaxed);
+#else
+        ++refc_;
+#endif
     }
     void del_ref() {
-        if (is_important) return;
+#ifdef KIZ_ATOMIC_REFCOUNT
         const size_t old_ref = refc_.fetch_sub(1, std::memory_order_acq_rel);
+#else
+        const size_t old_ref = refc_--;
+#endif
         if (old_ref == 1) {
             // std::cout << "deling object " << this->debug_string() << std::endl;
             delete this;
         }
     }
 
-    void attrs_insert(const std::string& name, Object* o) {
+    [[nodiscard]] Object* get_parent() const {
+        return parent_;
+    }
+
+    void set_parent(Object* parent) {
+        touch_proto();
+        if (parent) {
+            parent->make_ref();
+            parent->is_proto_ = true;
+        }
+        if (parent_) parent_->del_ref();
+        parent_ = parent;
+    }
+
+    ///| 只在本对象上查找属性(不沿原型链), 未找到返回nullptr
+    [[nodiscard]] Object* find_attr(const dep::Symbol name) const {
+        if (attrs_) {
+            if (const auto slot = attrs_->find(name)) return *slot;
+        }
+        if (name == magic_name::parent) return parent_;
+        return nullptr;
+    }
+
+    ///| 写入属性并持有引用(不释放被覆盖的旧值)
+    void attrs_insert(const dep::Symbol name, Object* o) {
+        assert(o != nullptr);
+        if (name == magic_name::parent) {
+            set_parent(o);
+            return;
+        }
+        touch_proto();
+        o->make_ref();
+        if (!attrs_) attrs_ = std::make_unique<AttrTable>();
+        if (const auto slot = attrs_->find(name)) {
+            *slot = o;
+            return;
+        }
+        attrs_->add(name, o);
+    }
+
+    ///| 写入属性, 覆盖时释放旧值
+    void set_attr(const dep::Symbol name, Object* o) {
         assert(o != nullptr);
+        if (name == magic_name::parent) {
+            set_parent(o);
+            return;
+        }
+        touch_proto();
+        o->make_ref();
+        if (!attrs_) attrs_ = std::make_unique<AttrTable>();
+        if (const auto slot = attrs_->find(name)) {
+            Object* old_val = *slot;
+            *slot = o;
+            if (old_val) old_val->del_ref();
+            return;
+        }
+        attrs_->add(name, o);
+    }
+
+    bool attrs_del(const dep::Symbol name) {
+        if (name == magic_name::parent) {
+            const bool had_parent = parent_ != nullptr;
+            set_parent(nullptr);
+            return had_parent;
+        }
+        if (!attrs_) return false;
+        touch_proto();
+        Object* old_val = attrs_->remove(name);
+        if (old_val) old_val->del_ref();
+        return old_val != nullptr;
+    }
+
+    ///| 字符串属性名版本, 供注册内置属性及 getattr 等动态属性名使用(需先驻留)
+    [[nodiscard]] Object* find_attr(const std::string_view name) const {
+        return find_attr(dep::intern(name));
+    }
+    void attrs_insert(const std::string_view name, Object* o) {
+        attrs_insert(dep::intern(name), o);
+    }
+    void set_attr(const std::string_view name, Object* o) {
+        set_attr(dep::intern(name), o);
+    }
+    bool attrs_del(const std::string_view name) {
+        return attrs_del(dep::intern(name));
+    }
+
+    ///| 自有属性表, 尚未写入过属性时为 nullptr
+    [[nodiscard]] AttrTable* attr_table() const {
+        return attrs_.get();
+    }
+
+    [[nodiscard]] bool is_proto() const {
+        return is_proto_;
+    }
+
+    ///| 自有属性的 Shape, 字典模式下返回 nullptr
+    [[nodiscard]] dep::Shape* get_shape() const {
+        return attrs_ ? attrs_->shape() : dep::Shape::root();
+    }
+
+    ///| 供内联缓存使用: 直接写入槽位 idx, next_shape 非空时表示追加新属性并迁移到该 Shape
+    void store_slot(const uint32_t idx, dep::Shape* next_shape, Object* o) {
+        touch_proto();
         o->make_ref();
-        attrs.insert(name, o);
+        if (next_shape) {
+            if (!attrs_) attrs_ = std::make_unique<AttrTable>();
+            attrs_->append(next_shape, o);
+            return;
+        }
+        Object* old_val = attrs_->slot_at(idx);
+        attrs_->set_slot(idx, o);
+        if (old_val) old_val->del_ref();
+    }
+
+    [[nodiscard]] bool has_own_attrs() const {
+        return attrs_ and attrs_->size() > 0;
+    }
+
+    ///| 全部属性(含 __parent__)
+    [[nodiscard]] std::vector<std::pair<std::string, Object*>> attrs_to_vector() const {
+        std::vector<std::pair<std::string, Object*>> vec;
+        if (parent_) vec.emplace_back(magic_name::parent.str(), parent_);
+        if (attrs_) {
+            auto own = attrs_->to_vector();
+            vec.insert(vec.end(), own.begin(), own.end());
+        }
+        return vec;
+    }
+
+    [[nodiscard]] std::string attrs_to_string() const {
+        std::stringstream ss;
+        ss << "{ ";
+        const auto vec = attrs_to_vector();
+        for (size_t i = 0; i < vec.size(); ++i) {
+            ss << vec[i].first << ": " << static_cast<void*>(vec[i].second);
+            if (i + 1 < vec.size()) ss << ", ";
+        }
+        ss << " }";
+        return ss.str();
     }
 
     [[nodiscard]] virtual std::string debug_string() const {
         return "<Object at " + ptr_to_string(this) + ">";
     }
 
+    ///| 访问本对象持有引用的子对象(__parent__ 与属性值), 供循环回收计算内部引用
+    virtual void gc_traverse(const std::function<void(Object*)>& visit) const {
+        if (parent_) visit(parent_);
+        if (attrs_) attrs_->for_each_value(visit);
+    }
+
+    ///| 释放本对象持有的全部引用, 供循环回收打断引用环; 之后对象仍可安全析构
+    virtual void gc_clear() {
+        touch_proto();
+        if (const auto attrs = std::move(attrs_)) {
+            attrs->for_each_value([](Object* obj) {
+                if (obj) obj->del_ref();
+            });
+        }
+        if (const auto parent = std::exchange(parent_, nullptr)) parent->del_ref();
+    }
+
     Object () = default;
 
     virtual ~Object() {
-        auto kv_list = attrs.to_vector();
-        for (const auto& obj : kv_list | std::views::values) {
-            if (obj) obj->del_ref();
+        if (gc_space_ != kiz::Gc::UNTRACKED) kiz::Gc::untrack(this);
+        if (attrs_) {
+            attrs_->for_each_value([](Object* obj) {
+                if (obj) obj->del_ref();
+            });
         }
+        if (parent_) parent_->del_ref();
+        // 缓存中可能借用了本原型持有的属性值
+        touch_proto();
     }
+
+protected:
+    explicit Object(const ObjectType type) : type_(type) {}
 };
 
+inline constexpr size_t OBJECT_TYPE_COUNT = static_cast<size_t>(Object::ObjectType::FileHandle) + 1;
+
+inline TypeSlots type_slots[OBJECT_TYPE_COUNT];
+
+inline TypeSlots& init_type_slots(const Object::ObjectType type, Object* proto) {
+    auto& slots = type_slots[static_cast<size_t>(type)];
+    slots.proto = proto;
+    return slots;
+}
+
+///| 对象可用的槽位表: 内置类型且 __parent__ 仍为其原型时返回, 否则返回 nullptr(走动态查找)
+inline const TypeSlots* slots_of(const Object* obj) {
+    if (!kiz::Vm::builtin_slots_valid) return nullptr;
+    const auto& slots = type_slots[static_cast<size_t>(obj->get_type())];
+    return slots.proto and obj->get_parent() == slots.proto ? &slots : nullptr;
+}
+
 inline auto based_based_obj = new Object();
 inline auto based_obj = new Object();
 inline auto based_list = new Object();
@@ -150,16 +508,154 @@ inline auto based_module = new Object();
 inline auto based_code_object = new Object();
 inline auto based_file_handle = new Object();
 inline auto based_range = new Object();
+inline auto based_iterator = new Object();
 inline auto stop_iter_signal = new Object();
 
+/**
+ * @brief 写时复制的存储句柄：复制句柄只共享同一份缓冲区，第一次 mut() 时才真正复制
+ *  * 缓冲区持有其中元素的引用，最后一个共享者释放时才 release 元素；
+ *  * Traits 提供 retain/release（元素引用计数）与 is_flat（是否不含 List/Dict 元素）；
+ *  * 空句柄不分配缓冲区。
+ */
+template <typename Store, typename Traits>
+class CowHandle {
+    struct Buffer {
+        Store store;
+        mutable int8_t flat = -1;   // Traits::is_flat 的缓存，-1 表示未知
+
+        explicit Buffer(Store s) : store(std::move(s)) { Traits::retain(store); }
+        ~Buffer() { Traits::release(store); }
+    };
+    std::shared_ptr<Buffer> buf_;
+
+public:
+    CowHandle() = default;
+    explicit CowHandle(Store store) {
+        if (!store.empty()) buf_ = std::make_shared<Buffer>(std::move(store));
+    }
+
+    [[nodiscard]] const Store& get() const {
+        static const Store empty_store;
+        return buf_ ? buf_->store : empty_store;
+    }
+
+    ///| 取得可修改的存储：缓冲区与其他句柄共享时先复制一份独占
+    Store& mut() {
+        if (!buf_) {
+            buf_ = std::make_shared<Buffer>(Store());
+        } else if (buf_.use_count() > 1) {
+            buf_ = std::make_shared<Buffer>(buf_->store);
+        }
+        buf_->flat = -1;
+        return buf_->store;
+    }
+
+    ///| 不含可变容器元素的存储可以在赋值时直接共享
+    [[nodiscard]] bool is_flat() const {
+        if (!buf_) return true;
+        if (buf_->flat < 0) buf_->flat = Traits::is_flat(buf_->store);
+        return buf_->flat;
+    }
+
+    [[nodiscard]] bool is_shared() const {
+        return buf_ and buf_.use_count() > 1;
+    }
+};
+
+inline bool is_container(const Object* o) {
+    return o and (o->get_type() == Object::ObjectType::List
+        or o->get_type() == Object::ObjectType::Dictionary);
+}
+
+struct ListTraits {
+    static void retain(const std::vector<Object*>& items) {
+        for (auto v : items) if (v) v->make_ref();
+    }
+    static void release(const std::vector<Object*>& items) {
+        for (auto v : items) if (v) v->del_ref();
+    }
+    static bool is_flat(const std::vector<Object*>& items) {
+        return std::ranges::none_of(items, is_container);
+    }
+};
+
+// List 的元素存储：读操作与 std::vector 一致，写操作必须经过 mut()
+class CowList : public CowHandle<std::vector<Object*>, ListTraits> {
+public:
+    using CowHandle::CowHandle;
+
+    [[nodiscard]] size_t size() const { return get().size(); }
+    [[nodiscard]] bool empty() const { return get().empty(); }
+    Object* operator[](const size_t i) const { return get()[i]; }
+    [[nodiscard]] Object* front() const { return get().front(); }
+    [[nodiscard]] Object* back() const { return get().back(); }
+    [[nodiscard]] auto begin() const { return get().begin(); }
+    [[nodiscard]] auto end() const { return get().end(); }
+};
+
 class List;
 
+///| 实参视图: 指向调用方持有的一段连续实参(操作数栈或调用方的局部数组), 不拥有实参也不做引用计数
+///| 只在一次调用期间有效, 原生函数需要保存实参时应自行 make_ref
+class Args {
+    Object* const* data_ = nullptr;
+    size_t size_ = 0;
+
+public:
+    Args() = default;
+    Args(Object* const* data, const size_t size) : data_(data), size_(size) {}
+    ///| 调用方的局部实参数组, 如 `Object* argv[] = {a, b}; call_function(f, argv, self);`
+    template <size_t N>
+    Args(Object* const (&argv)[N]) : data_(argv), size_(N) {}
+    Args(const std::vector<Object*>& v) : data_(v.data()), size_(v.size()) {}
+
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+    Object* operator[](const size_t i) const { return data_[i]; }
+    [[nodiscard]] Object* front() const { return data_[0]; }
+    [[nodiscard]] Object* back() const { return data_[size_ - 1]; }
+    [[nodiscard]] Object* const* begin() const { return data_; }
+    [[nodiscard]] Object* const* end() const { return data_ + size_; }
+
+    [[nodiscard]] Args subspan(const size_t offset) const {
+        return offset >= size_ ? Args() : Args(data_ + offset, size_ - offset);
+    }
+    [[nodiscard]] std::vector<Object*> to_vector() const {
+        return {begin(), end()};
+    }
+};
+
+///| GET_ATTR/SET_ATTR/CALL_METHOD 的多态内联缓存, 每条指令的 opn_list[1] 为其下标(CALL_METHOD 见 CALL_METHOD_ARGC_BITS)
+struct AttrCacheEntry {
+    static constexpr uint32_t NOT_OWN = UINT32_MAX;
+
+    dep::Shape* shape = nullptr;      // 接收者自有属性的 Shape, nullptr 表示空条目
+    Object* parent = nullptr;         // 接收者的 __parent__ (SET_ATTR 不使用)
+    size_t epoch = 0;                 // 填充时的原型纪元 (SET_ATTR 不使用)
+    uint32_t slot = NOT_OWN;          // 自有属性的槽位, NOT_OWN 表示在原型链上找到
+    Object* value = nullptr;          // GET: 原型链上找到的值(借用)
+    dep::Shape* next_shape = nullptr; // SET: 追加属性后的 Shape, nullptr 表示覆盖已有槽位
+};
+
+struct AttrCache {
+    static constexpr size_t WAYS = 4;
+    AttrCacheEntry entries[WAYS];
+    uint8_t next_victim = 0;
+
+    AttrCacheEntry& victim() {
+        auto& e = entries[next_victim];
+        next_victim = static_cast<uint8_t>((next_victim + 1) % WAYS);
+        return e;
+    }
+};
+
 class CodeObject : public Object {
 public:
     std::vector<kiz::Instruction> code;
+    kiz::LineTable line_table;
 
     std::vector<std::string> var_names;
-    std::vector<std::string> attr_names;
+    std::vector<dep::Symbol> attr_names;
     std::vector<std::string> free_names;
 
     std::vector<UpValue> upvalues;
@@ -167,20 +663,65 @@ public:
 
     std::vector<ExceptionTable> exception_tables;
     std::vector<kiz::Instruction> ensure_stmts;
+    kiz::LineTable ensure_line_table;
+
+    std::vector<AttrCache> attr_caches;
+
+    size_t max_iters = 0; // 栈帧需要的迭代器槽位数: 主体与ensure块的最大for循环嵌套深度之和
 
     static constexpr ObjectType TYPE = ObjectType::CodeObject;
-    [[nodiscard]] ObjectType get_type() const override { return TYPE; }
 
     explicit CodeObject(const std::vector<kiz::Instruction>& c,
+        const std::vector<err::PositionInfo>& c_p,
         const std::vector<std::string>& v_n,
-        const std::vector<std::string>& a_n,
+        const std::vector<dep::Symbol>& a_n,
         const std::vector<std::string>& f_n,
         const std::vector<UpValue>& u_v,
         const size_t l_c,
         std::vector<ExceptionTable> et,
-        std::vector<kiz::Instruction> e_s)
-            : code(c), var_names(v_n), attr_names(a_n), free_names(f_n), upvalues(u_v), locals_count(l_c),
-                 exception_tables(std::move(et)), ensure_stmts(std::move(e_s)) {}
+        std::vector<kiz::Instruction> e_s,
+        const std::vector<err::PositionInfo>& e_s_p)
+            : Object(TYPE), code(c), line_table(c_p), var_names(v_n), attr_names(a_n), free_names(f_n), upvalues(u_v), locals_count(l_c),
+                 exception_tables(std::move(et)), ensure_stmts(std::move(e_s)), ensure_line_table(e_s_p) {
+        assign_attr_caches(code);
+        assign_attr_caches(ensure_stmts);
+        max_iters = max_iter_depth(code) + max_iter_depth(ensure_stmts);
+    }
+
+    // for循环的指令按源码嵌套顺序排列, pc 之前 CACHE_ITER 与 POP_ITER 的个数之差即该处的迭代器嵌套深度
+    [[nodiscard]] size_t iter_depth_at(const size_t pc) const {
+        size_t depth = 0;
+        for (size_t i = 0; i < pc and i < code.size(); ++i) {
+            if (code[i].opc == kiz::Opcode::CACHE_ITER) ++depth;
+            else if (code[i].opc == kiz::Opcode::POP_ITER) --depth;
+        }
+        return depth;
+    }
+
+    static size_t max_iter_depth(const std::vector<kiz::Instruction>& instructions) {
+        size_t depth = 0, max_depth = 0;
+        for (const auto& instr : instructions) {
+            if (instr.opc == kiz::Opcode::CACHE_ITER) max_depth = std::max(max_depth, ++depth);
+            else if (instr.opc == kiz::Opcode::POP_ITER) --depth;
+        }
+        return max_depth;
+    }
+
+    // 给每条属性访问指令分配一个内联缓存 (CALL_METHOD 的缓存下标与实参个数共用第二个操作数)
+    void assign_attr_caches(std::vector<kiz::Instruction>& instructions) {
+        for (auto& instr : instructions) {
+            const auto cache_idx = static_cast<uint32_t>(attr_caches.size());
+            if (instr.opc == kiz::Opcode::GET_ATTR or instr.opc == kiz::Opcode::SET_ATTR) {
+                instr.opn_list[1] = cache_idx;
+            } else if (instr.opc == kiz::Opcode::CALL_METHOD) {
+                instr.opn_list[1] = cache_idx << kiz::CALL_METHOD_ARGC_BITS
+                    | (instr.opn_list[1] & kiz::CALL_METHOD_MAX_ARGC);
+            } else {
+                continue;
+            }
+            attr_caches.emplace_back();
+        }
+    }
 
     [[nodiscard]] std::string debug_string() const override {
         return "<CodeObject at " + ptr_to_string(this) + ">";
@@ -193,23 +734,24 @@ public:
     CodeObject* code = nullptr;
 
     static constexpr ObjectType TYPE = ObjectType::Module;
-    [[nodiscard]] ObjectType get_type() const override { return TYPE; }
 
-    explicit Module(std::string name, CodeObject *code) : path(std::move(name)), code(code) {
-        attrs_insert("__parent__", based_module);
+    explicit Module(std::string name, CodeObject *code) : Object(TYPE), path(std::move(name)), code(code) {
+        set_parent(based_module);
         code->make_ref();
+        kiz::Gc::track(this);
     }
 
-    explicit Module(std::string name) : path(std::move(name)) {
-        attrs_insert("__parent__", based_module);
+    explicit Module(std::string name) : Object(TYPE), path(std::move(name)) {
+        set_parent(based_module);
+        kiz::Gc::track(this);
     }
 
     [[nodiscard]] std::string debug_string() const override {
-        return "<Module: path='" + path + "', attr=" + attrs.to_string() + ", at " + ptr_to_string(this) + ">";
+        return "<Module: path='" + path + "', attr=" + attrs_to_string() + ", at " + ptr_to_string(this) + ">";
     }
 
     ~Module() override {
-        code->del_ref();
+        if (code) code->del_ref();
     }
 };
 
@@ -222,12 +764,24 @@ public:
     std::vector<Object*> free_vars;
 
     static constexpr ObjectType TYPE = ObjectType::Function;
-    [[nodiscard]] ObjectType get_type() const override { return TYPE; }
 
     explicit Function(std::string name, CodeObject *code, const size_t argc
-    ) : name(std::move(name)), code(code), argc(argc) {
+    ) : Object(TYPE), name(std::move(name)), code(code), argc(argc) {
         code->make_ref();
-        attrs_insert("__parent__", based_function);
+        set_parent(based_function);
+        kiz::Gc::track(this);
+    }
+
+    void gc_traverse(const std::function<void(Object*)>& visit) const override {
+        Object::gc_traverse(visit);
+        for (const auto fv : free_vars) visit(fv);
+    }
+
+    void gc_clear() override {
+        Object::gc_clear();
+        for (const auto fv : std::exchange(free_vars, {})) {
+            if (fv) fv->del_ref();
+        }
     }
 
     [[nodiscard]] std::string debug_string() const override {
@@ -242,17 +796,104 @@ public:
     }
 };
 
+///| 原生函数的参数类型掩码: 每个 ObjectType 占一位, ANY_TYPE 表示不限类型
+using TypeMask = uint32_t;
+inline constexpr TypeMask ANY_TYPE = 0;
+
+constexpr TypeMask type_bit(const Object::ObjectType t) {
+    return 1u << static_cast<uint32_t>(t);
+}
+
+// 如 type_of<Int, Decimal>, 须在这些类型定义之后使用
+template <typename... T>
+inline constexpr TypeMask type_of = (type_bit(T::TYPE) | ...);
+
+///| 类型在 kiz 中的名字, 与内置对象名一致
+inline std::string type_name(const Object::ObjectType t) {
+    switch (t) {
+    case Object::ObjectType::Object: return "Object";
+    case Object::ObjectType::Nil: return "Nil";
+    case Object::ObjectType::Bool: return "Bool";
+    case Object::ObjectType::Int: return "Int";
+    case Object::ObjectType::String: return "Str";
+    case Object::ObjectType::Decimal: return "Decimal";
+    case Object::ObjectType::List: return "List";
+    case Object::ObjectType::Dictionary: return "Dict";
+    case Object::ObjectType::CodeObject: return "__CodeObject";
+    case Object::ObjectType::Function: return "Func";
+    case Object::ObjectType::NativeFunction: return "NFunc";
+    case Object::ObjectType::Module: return "Module";
+    case Object::ObjectType::Error: return "Error";
+    case Object::ObjectType::Iterator: return "Iterator";
+    case Object::ObjectType::Range: return "Range";
+    case Object::ObjectType::FileHandle: return "FileHandle";
+    }
+    return "<Unknown>";
+}
+
+///| 原生函数签名: 实参个数范围, 前 MAX_TYPED_PARAMS 个实参的类型与接收者(self)的类型
+///| 由 VM 在调用时统一校验, 原生函数体内无需再检查参数个数, 声明了类型的参数可直接 static_cast
+struct NativeSig {
+    static constexpr uint8_t VARIADIC = UINT8_MAX;
+    static constexpr size_t MAX_TYPED_PARAMS = 4;
+
+    uint8_t min_argc = 0;
+    uint8_t max_argc = VARIADIC;
+    TypeMask param_types[MAX_TYPED_PARAMS] = {};
+    TypeMask self_type = ANY_TYPE;
+
+    ///| 校验失败时以 Vm::raise 报告错误并返回false
+    bool check(const Object* self, const Args args) const {
+        if (args.size() < min_argc or (max_argc != VARIADIC and args.size() > max_argc)) [[unlikely]] {
+            raise_arg_count_error(args.size());
+            return false;
+        }
+        if (self_type != ANY_TYPE and !(self and type_bit(self->get_type()) & self_type)) [[unlikely]] {
+            raise_type_error("receiver", self, self_type);
+            return false;
+        }
+        const size_t typed = std::min(args.size(), MAX_TYPED_PARAMS);
+        for (size_t i = 0; i < typed; ++i) {
+            if (param_types[i] != ANY_TYPE and !(type_bit(args[i]->get_type()) & param_types[i])) [[unlikely]] {
+                raise_type_error(std::format("argument {}", i + 1), args[i], param_types[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    void raise_arg_count_error(size_t argc) const;
+    static void raise_type_error(const std::string& which, const Object* obj, TypeMask expected);
+};
+
+using NativeFn = Object* (*)(Object* self, Args args);
+
+///| 原生函数注册表中的一项, 各库以 constexpr 数组声明自己的原生函数
+struct NativeDef {
+    const char* name;
+    NativeFn func;
+    NativeSig sig{};
+};
+
 class NativeFunction : public Object {
 public:
     std::string name;
-    std::function<Object*(Object*, List*)> func;
+    NativeFn func;
+    NativeSig sig;
 
     static constexpr ObjectType TYPE = ObjectType::NativeFunction;
-    [[nodiscard]] ObjectType get_type() const override { return TYPE; }
 
-    explicit NativeFunction(std::function<Object*(Object*, List*)> func) : func(std::move(func)) {
-        attrs_insert("__parent__", based_native_function);
+    explicit NativeFunction(const NativeFn func, const NativeSig& sig = {}) : Object(TYPE), func(func), sig(sig) {
+        set_parent(based_native_function);
     }
+
+    ///| 按签名校验实参后直接调用函数指针; 校验失败返回nullptr并留下待处理错误
+    Object* call(Object* self, const Args args) const {
+        if (!sig.check(self, args)) [[unlikely]] return nullptr;
+        return func(self, args);
+    }
+
     [[nodiscard]] std::string debug_string() const override {
     return "<NativeFunction" +
            (name.empty() 
@@ -268,13 +909,12 @@ public:
     dep::BigInt val;
 
     static constexpr ObjectType TYPE = ObjectType::Int;
-    [[nodiscard]] ObjectType get_type() const override { return TYPE; }
 
-    explicit Int(dep::BigInt val) : val(std::move(val)) {
-        attrs_insert("__parent__", based_int);
+    explicit Int(dep::BigInt val) : Object(TYPE), val(std::move(val)) {
+        set_parent(based_int);
     }
-    explicit Int() : val(dep::BigInt(0)) {
-        attrs_insert("__parent__", based_int);
+    explicit Int() : Object(TYPE), val(dep::BigInt(0)) {
+        set_parent(based_int);
     }
     [[nodiscard]] std::string debug_string() const override {
         return val.to_string();
@@ -283,19 +923,26 @@ public:
 
 class List : public Object {
 public:
-    std::vector<Object*> val;
+    CowList val;
+    size_t next_cursor = 0;   // 直接调用 __next__ 时的游标（for 循环使用独立的 ListIterator）
 
     static constexpr ObjectType TYPE = ObjectType::List;
-    [[nodiscard]] ObjectType get_type() const override { return TYPE; }
 
-    explicit List(const std::vector<Object*>& val_){
-        for (auto v: val_) {
-            v->make_ref();
-            val.push_back(v);
-        }
-        attrs_insert("__parent__", based_list);
-        auto zero = kiz::Vm::small_int_pool[0];
-        attrs_insert("__current_index__", zero);
+    explicit List(const std::vector<Object*>& val_) : Object(TYPE), val(val_) {
+        set_parent(based_list);
+        kiz::Gc::track(this);
+    }
+
+    // 与其他 List 共享的缓冲区只持有一份引用, 无法归属到某一个共享者, 保守地不计入内部引用
+    void gc_traverse(const std::function<void(Object*)>& visit) const override {
+        Object::gc_traverse(visit);
+        if (val.is_shared()) return;
+        for (const auto e : val) visit(e);
+    }
+
+    void gc_clear() override {
+        Object::gc_clear();
+        val = CowList();
     }
     [[nodiscard]] std::string debug_string() const override {
         std::string result = "[";
@@ -312,21 +959,14 @@ public:
         result += "]";
         return result;
     }
-
-    ~List() override {
-        for (auto elem : val) {
-            if (elem) elem->del_ref();
-        }
-    }
 };
 
 class Decimal : public Object {
 public:
     dep::Decimal val;
     static constexpr ObjectType TYPE = ObjectType::Decimal;
-    [[nodiscard]] ObjectType get_type() const override { return TYPE; }
-    explicit Decimal(dep::Decimal val) : val(std::move(val)) {
-        attrs_insert("__parent__", based_decimal);
+    explicit Decimal(dep::Decimal val) : Object(TYPE), val(std::move(val)) {
+        set_parent(based_decimal);
     }
     [[nodiscard]] std::string debug_string() const override {
         return val.to_string();
@@ -336,39 +976,138 @@ public:
 class String : public Object {
 public:
     std::string val;
+    size_t next_cursor = 0;   // 直接调用 __next__ 时的字节游标
 
     static constexpr ObjectType TYPE = ObjectType::String;
-    [[nodiscard]] ObjectType get_type() const override { return TYPE; }
 
-    explicit String(std::string val) : val(std::move(val)) {
-        attrs_insert("__parent__", based_str);
-        auto zero = kiz::Vm::small_int_pool[0];
-        attrs_insert("__current_index__", zero);
+    explicit String(std::string val) : Object(TYPE), val(std::move(val)) {
+        set_parent(based_str);
     }
     [[nodiscard]] std::string debug_string() const override {
         return '"'+val+'"';
     }
 };
 
+/**
+ * @brief 字典键哈希：String/Int 直接计算，其余对象调用 __hash__
+ *  * __hash__ 失败或返回值不是 Int 时以 Vm::raise 报告错误并返回 0，调用方须检查 Vm::error_pending
+ */
+inline size_t dict_key_hash(Object* key) {
+    switch (key->get_type()) {
+    case Object::ObjectType::String:
+        return dep::hash_string(static_cast<String*>(key)->val);
+    case Object::ObjectType::Int:
+        return static_cast<Int*>(key)->val.hash_word();
+    default:
+        break;
+    }
+
+    kiz::Vm::call_slot(key, &TypeSlots::hash, magic_name::hash);
+    if (kiz::Vm::error_pending) return 0;
+    const auto result = kiz::Vm::get_and_pop_stack_top();
+    const auto result_int = result.get()->as<model::Int>();
+    if (!result_int) {
+        kiz::Vm::raise("TypeError", "Object's hash method return a value which type isn't Int");
+        return 0;
+    }
+    return result_int->val.hash_word();
+}
+
+/**
+ * @brief 字典键比较：同一对象或同类型 String/Int 直接比较，类型不同视为不同键，其余调用 __eq__
+ */
+inline bool dict_key_equal(Object* a, Object* b) {
+    if (a == b) return true;
+    const auto type = a->get_type();
+    if (type != b->get_type()) return false;
+    switch (type) {
+    case Object::ObjectType::String:
+        return static_cast<String*>(a)->val == static_cast<String*>(b)->val;
+    case Object::ObjectType::Int:
+        return static_cast<Int*>(a)->val == static_cast<Int*>(b)->val;
+    default:
+        break;
+    }
+
+    kiz::Vm::call_slot(a, &TypeSlots::eq, magic_name::eq, b);
+    const auto result = kiz::Vm::get_and_pop_stack_top();
+    return kiz::Vm::is_true(result.get());
+}
+
+// 字典条目为 (键对象, 值对象)，按键对象比较
+struct DictKeyEqual {
+    bool operator()(const std::pair<Object*, Object*>& entry, Object* key) const {
+        return dict_key_equal(entry.first, key);
+    }
+    bool operator()(const std::pair<Object*, Object*>& entry, const std::pair<Object*, Object*>& other) const {
+        return dict_key_equal(entry.first, other.first);
+    }
+};
+
+using DictStore = dep::Dict<std::pair<Object*, Object*>, DictKeyEqual>;
+
+struct DictTraits {
+    static void retain(const DictStore& store) {
+        for (const auto& [_, kv_pair] : store.entries()) {
+            if (kv_pair.first) kv_pair.first->make_ref();
+            if (kv_pair.second) kv_pair.second->make_ref();
+        }
+    }
+    static void release(const DictStore& store) {
+        for (const auto& [_, kv_pair] : store.entries()) {
+            if (kv_pair.first) kv_pair.first->del_ref();
+            if (kv_pair.second) kv_pair.second->del_ref();
+        }
+    }
+    // 键必须可哈希(不可变), 只需检查值
+    static bool is_flat(const DictStore& store) {
+        return std::ranges::none_of(store.entries(), [](const auto& entry) {
+            return is_container(entry.value.second);
+        });
+    }
+};
+
+// Dictionary 的条目存储：读操作与 DictStore 一致，写操作必须经过 mut()
+class CowDict : public CowHandle<DictStore, DictTraits> {
+public:
+    using CowHandle::CowHandle;
+
+    template <typename K>
+    [[nodiscard]] const DictStore::Node* find(const size_t hash, const K& key) const { return get().find(hash, key); }
+    [[nodiscard]] const auto& entries() const { return get().entries(); }
+    [[nodiscard]] auto to_vector() const { return get().to_vector(); }
+    [[nodiscard]] size_t size() const { return get().size(); }
+    [[nodiscard]] bool empty() const { return get().empty(); }
+};
+
 class Dictionary : public Object {
 public:
-    dep::Dict<std::pair<Object*, Object*>> val;
+    CowDict val;
+    size_t next_cursor = 0;   // 直接调用 __next__ 时的条目游标
     static constexpr ObjectType TYPE = ObjectType::Dictionary;
-    [[nodiscard]] ObjectType get_type() const override { return TYPE; }
 
-    explicit Dictionary(dep::Dict<std::pair<Object*, Object*>> val_) : val(std::move(val_)) {
-        for (auto& kv_pair : val_.to_vector() | std::views::values) {
-            if (kv_pair.first) kv_pair.first->make_ref();
-            if (kv_pair.second) kv_pair.second->make_ref();
+    explicit Dictionary(DictStore val_) : Object(TYPE), val(std::move(val_)) {
+        set_parent(based_dict);
+        kiz::Gc::track(this);
+    }
+    explicit Dictionary() : Object(TYPE) {
+        set_parent(based_dict);
+        kiz::Gc::track(this);
+    }
+
+    // 共享缓冲区的处理同 List
+    void gc_traverse(const std::function<void(Object*)>& visit) const override {
+        Object::gc_traverse(visit);
+        if (val.is_shared()) return;
+        for (const auto& [_, kv_pair] : val.entries()) {
+            visit(kv_pair.first);
+            visit(kv_pair.second);
         }
-        attrs_insert("__parent__", based_dict);
-        auto zero = kiz::Vm::small_int_pool[0];
-        attrs_insert("__current_index__", zero);
     }
-    explicit Dictionary() {
-        attrs_insert("__parent__", based_dict);
-        auto zero = kiz::Vm::small_int_pool[0];
-        attrs_insert("__current_index__", zero);
+
+    void gc_clear() override {
+        Object::gc_clear();
+        val = CowDict();
     }
 
     [[nodiscard]] std::string debug_string() const override {
@@ -385,13 +1124,142 @@ public:
         result += "}";
         return result;
     }
+};
 
-    ~Dictionary() override {
-        auto kv_list = val.to_vector();
-        for (auto& kv_pair : kv_list | std::views::values) {
-            if (kv_pair.first) kv_pair.first->del_ref();
-            if (kv_pair.second) kv_pair.second->del_ref();
+// 惰性整数区间：只保存 int64 的起点/步长/终点，不预先生成元素
+class Range : public Object {
+public:
+    int64_t start;
+    int64_t step;
+    int64_t end;
+    int64_t current;   // 直接调用 __next__ 时的游标（for 循环使用独立的 RangeIterator）
+
+    static constexpr ObjectType TYPE = ObjectType::Range;
+
+    Range(const int64_t start, const int64_t step, const int64_t end)
+        : Object(TYPE), start(start), step(step), end(end), current(start) {
+        set_parent(based_range);
+    }
+
+    // 供脚本读取的 start/step/end 属性（只在创建时写入一次，迭代不再访问属性表）
+    void expose_bounds();
+
+    [[nodiscard]] std::string debug_string() const override {
+        return std::format("Range(start={}, step={}, end={})", start, step, end);
+    }
+};
+
+// 原生迭代器基类：__iter__ 返回的独立游标对象，GET_ITER 直接调用 next() 取值
+class NativeIterator : public Object {
+public:
+    enum class IterKind : uint8_t { List, String, Dict, Range };
+
+    static constexpr ObjectType TYPE = ObjectType::Iterator;
+    const IterKind kind; // 具体迭代器类型, 供 FOR_RANGE 等指令在不使用 dynamic_cast 的情况下识别
+
+    explicit NativeIterator(const IterKind kind) : Object(TYPE), kind(kind) {
+        set_parent(based_iterator);
+    }
+
+    ///| 返回下一个元素（借用引用或新对象），耗尽时返回 stop_iter_signal
+    virtual Object* next() = 0;
+};
+
+// 列表的原生迭代器：按下标遍历，每次循环只推进游标
+class ListIterator : public NativeIterator {
+public:
+    List* list;
+    size_t cursor = 0;
+
+    explicit ListIterator(List* list) : NativeIterator(IterKind::List), list(list) {
+        list->make_ref();
+    }
+
+    Object* next() override;
+
+    [[nodiscard]] std::string debug_string() const override {
+        return "<ListIterator at " + ptr_to_string(this) + ">";
+    }
+
+    ~ListIterator() override {
+        list->del_ref();
+    }
+};
+
+// 字符串的原生迭代器：按字节游标逐个切出 UTF-8 字符
+class StringIterator : public NativeIterator {
+public:
+    String* str;
+    size_t cursor = 0;
+
+    explicit StringIterator(String* str) : NativeIterator(IterKind::String), str(str) {
+        str->make_ref();
+    }
+
+    Object* next() override;
+
+    [[nodiscard]] std::string debug_string() const override {
+        return "<StringIterator at " + ptr_to_string(this) + ">";
+    }
+
+    ~StringIterator() override {
+        str->del_ref();
+    }
+};
+
+// 字典的原生迭代器：按插入顺序遍历条目下标，迭代期间字典元素数变化视为错误
+class DictIterator : public NativeIterator {
+public:
+    enum class Kind { Keys, Values, Items };
+
+    Dictionary* dict;
+    Kind view;
+    size_t cursor = 0;
+    size_t expected_size;
+
+    DictIterator(Dictionary* dict, const Kind view)
+        : NativeIterator(IterKind::Dict), dict(dict), view(view), expected_size(dict->val.size()) {
+        dict->make_ref();
+    }
+
+    Object* next() override;
+
+    [[nodiscard]] std::string debug_string() const override {
+        return "<DictIterator at " + ptr_to_string(this) + ">";
+    }
+
+    ~DictIterator() override {
+        dict->del_ref();
+    }
+};
+
+// 区间的原生迭代器：FOR_RANGE 指令直接调用 advance() 推进 int64 计数
+class RangeIterator : public NativeIterator {
+public:
+    int64_t current;
+    int64_t step;
+    int64_t end;
+
+    explicit RangeIterator(const Range* range)
+        : NativeIterator(IterKind::Range), current(range->start), step(range->step), end(range->end) {}
+
+    ///| 取出当前值并推进游标, 区间耗尽返回false
+    bool advance(int64_t& out) {
+        if (step > 0 ? current >= end : current <= end) return false;
+        out = current;
+        // 越过int64边界即视为耗尽
+        if (step > 0 ? current > INT64_MAX - step : current < INT64_MIN - step) {
+            current = end;
+        } else {
+            current += step;
         }
+        return true;
+    }
+
+    Object* next() override;
+
+    [[nodiscard]] std::string debug_string() const override {
+        return "<RangeIterator at " + ptr_to_string(this) + ">";
     }
 };
 
@@ -400,10 +1268,9 @@ public:
     bool val;
 
     static constexpr ObjectType TYPE = ObjectType::Bool;
-    [[nodiscard]] ObjectType get_type() const override { return TYPE; }
 
-    explicit Bool(const bool val) : val(val) {
-        attrs_insert("__parent__", based_bool);
+    explicit Bool(const bool val) : Object(TYPE), val(val) {
+        set_parent(based_bool);
     }
     [[nodiscard]] std::string debug_string() const override {
         return val ? "True" : "False";
@@ -414,9 +1281,8 @@ class Nil : public Object {
 public:
 
     static constexpr ObjectType TYPE = ObjectType::Nil;
-    [[nodiscard]] ObjectType get_type() const override { return TYPE; }
 
-    explicit Nil() : Object() {}
+    explicit Nil() : Object(TYPE) {}
     [[nodiscard]] std::string debug_string() const override {
         return "Nil";
     }
@@ -426,15 +1292,14 @@ class Error : public Object {
 public:
     std::vector<std::pair<std::string, err::PositionInfo>> positions;
     static constexpr ObjectType TYPE = ObjectType::Error;
-    [[nodiscard]] ObjectType get_type() const override { return TYPE; }
 
-    explicit Error(std::vector<std::pair<std::string, err::PositionInfo>> p) {
+    explicit Error(std::vector<std::pair<std::string, err::PositionInfo>> p) : Object(TYPE) {
         positions = std::move(p);
-        attrs_insert("__parent__", based_error);
+        set_parent(based_error);
     }
 
-    explicit Error() {
-        attrs_insert("__parent__", based_error);
+    explicit Error() : Object(TYPE) {
+        set_parent(based_error);
     }
 
     [[nodiscard]] std::string debug_string() const override {
@@ -446,8 +1311,11 @@ class FileHandle : public Object {
 public:
     std::fstream* file_handle = nullptr;
     bool is_closed = false;
-    explicit FileHandle() {
-        attrs_insert("__parent__", based_file_handle);
+
+    static constexpr ObjectType TYPE = ObjectType::FileHandle;
+
+    explicit FileHandle() : Object(TYPE) {
+        set_parent(based_file_handle);
     }
     ~FileHandle() override {
         is_closed = true;
@@ -486,77 +1354,151 @@ inline auto load_stop_iter_signal() {
     return stop_iter_signal;
 }
 
-inline auto create_nfunc(const std::function<Object*(Object*, List*)>& func, const std::string& name="<unnamed>") {
-    auto o = new NativeFunction(func);
+// 装箱int64: 小整数池内的值直接复用
+inline Int* load_int(const int64_t v) {
+    if (v >= 0 and v < 201) return kiz::Vm::small_int_pool[v];
+    return new Int(dep::BigInt(v));
+}
+
+inline void Range::expose_bounds() {
+    attrs_insert("start", load_int(start));
+    attrs_insert("step", load_int(step));
+    attrs_insert("end", load_int(end));
+}
+
+inline auto create_nfunc(const NativeFn func, const std::string& name="<unnamed>", const NativeSig& sig={}) {
+    auto o = new NativeFunction(func, sig);
     o->name = name;
     return o;
 }
 
+inline auto create_nfunc(const NativeDef& def) {
+    return create_nfunc(def.func, def.name, def.sig);
+}
+
+///| 把注册表中的原生函数注册为 obj 的属性, self_type 非空时作为这些方法的接收者类型
+template <size_t N>
+void def_natives(Object* obj, const NativeDef (&defs)[N], const TypeMask self_type = ANY_TYPE) {
+    for (const auto& def : defs) {
+        const auto nfunc = create_nfunc(def);
+        nfunc->sig.self_type = self_type;
+        obj->attrs_insert(def.name, nfunc);
+    }
+}
+
+inline void NativeSig::raise_arg_count_error(const size_t argc) const {
+    // uint8_t 会被 std::format 当作字符输出, 先转为无符号整数
+    const unsigned min = min_argc, max = max_argc;
+    std::string expected;
+    if (max_argc == VARIADIC) {
+        expected = std::format("at least {}", min);
+    } else if (min == max) {
+        expected = std::to_string(min);
+    } else {
+        expected = std::format("{} to {}", min, max);
+    }
+    kiz::Vm::raise("ArgCountError", std::format(
+        "expect {} arguments but got {} arguments", expected, argc
+    ));
+}
 
+inline void NativeSig::raise_type_error(const std::string& which, const Object* obj, const TypeMask expected) {
+    std::string names;
+    for (uint32_t t = 0; t < OBJECT_TYPE_COUNT; ++t) {
+        if (!(expected & 1u << t)) continue;
+        if (!names.empty()) names += " or ";
+        names += type_name(static_cast<Object::ObjectType>(t));
+    }
+    kiz::Vm::raise("TypeError", std::format(
+        "{} must be {}, not {}", which, names, obj ? type_name(obj->get_type()) : "nothing"
+    ));
+}
+
+
+///| 类型不符时以 Vm::raise 报告错误并返回nullptr, 原生函数直接 `if (!x) return nullptr;` 即可
 inline auto cast_to_int(Object* o) {
-    auto obj = dynamic_cast<Int*>(o);
+    auto obj = o->as<model::Int>();
     if (!obj)
-        throw NativeFuncError("TypeError", std::format(
+        kiz::Vm::raise("TypeError", std::format(
             "fail to cast {} to Int", kiz::Vm::obj_to_debug_str(o)));
     return obj;
 }
 
 inline auto cast_to_str(Object* o) {
-    auto obj = dynamic_cast<String*>(o);
+    auto obj = o->as<model::String>();
     if (!obj)
-        throw NativeFuncError("TypeError", std::format(
+        kiz::Vm::raise("TypeError", std::format(
             "fail to cast {} to Str", kiz::Vm::obj_to_debug_str(o)));
     return obj;
 }
 
 inline auto cast_to_bool(Object* o) {
-    auto obj = dynamic_cast<Bool*>(o);
+    auto obj = o->as<model::Bool>();
     if (!obj)
-        throw NativeFuncError("TypeError", std::format(
-            "fail to cast {} to Bool", kiz::Vm::obj_to_debug_str(o)));    return obj;
+        kiz::Vm::raise("TypeError", std::format(
+            "fail to cast {} to Bool", kiz::Vm::obj_to_debug_str(o)));
+    return obj;
 }
 
 inline auto cast_to_list(Object* o) {
-    auto obj = dynamic_cast<List*>(o);
+    auto obj = o->as<model::List>();
     if (!obj)
-        throw NativeFuncError("TypeError", std::format(
+        kiz::Vm::raise("TypeError", std::format(
             "fail to cast {} to List", kiz::Vm::obj_to_debug_str(o)));
     return obj;
 }
 
+/**
+ * @brief 赋值时的值语义拷贝：List/Dict 返回新的容器对象(引用计数为0), 其余对象原样返回
+ *  * 不含容器元素的存储直接共享缓冲区(写时复制)，O(1)；
+ *  * 含容器元素时逐个拷贝嵌套容器，保证与外部别名互不影响。
+ */
 inline auto copy_if_mutable(Object* obj) -> Object* {
     switch (obj->get_type()) {
 
     case Object::ObjectType::List: {
+        auto list_obj = static_cast<List*>(obj);
+        if (list_obj->val.is_flat()) {
+            auto new_list_obj = new List({});
+            new_list_obj->val = list_obj->val;
+            return new_list_obj;
+        }
+
         std::vector<Object*> new_val;
-        for (auto val : cast_to_list(obj)->val) {
-            new_val.push_back(copy_if_mutable(val));
+        new_val.reserve(list_obj->val.size());
+        for (auto val : list_obj->val) {
+            new_val.push_back(val ? copy_if_mutable(val) : val);
         }
         return new List(new_val);
     }
 
     case Object::ObjectType::Dictionary: {
+        auto dict_obj = obj->as<model::Dictionary>();
+        assert(dict_obj != nullptr);
+        if (dict_obj->val.is_flat()) {
+            auto new_dict_obj = new Dictionary();
+            new_dict_obj->val = dict_obj->val;
+            return new_dict_obj;
+        }
+
         std::vector<std::pair<
-            dep::BigInt, std::pair< Object*, Object* >
+            size_t, std::pair< Object*, Object* >
         >> elem_list;
-        auto dict_obj = dynamic_cast<Dictionary*>(obj);
-        assert(dict_obj != nullptr);
-        for (auto& [_, kv_pair] : dict_obj->val.to_vector()) {
+        elem_list.reserve(dict_obj->val.size());
+        for (auto& [hash, kv_pair] : dict_obj->val.entries()) {
             // key是hashable value, 也就是不可变对象, 可以引用传递, 应该没有神人为可变对象重载__hash__方法的
-            elem_list.emplace_back(_, std::pair{
+            elem_list.emplace_back(hash, std::pair{
                 kv_pair.first, copy_if_mutable(kv_pair.second)
             });
         }
-        auto new_dict_obj = new Dictionary(dep::Dict(elem_list));
+        auto new_dict_obj = new Dictionary(DictStore(elem_list));
         return new_dict_obj;
     }
 
-    default: {
-        obj->make_ref();
+    default:
         return obj;
-    }
 
     }
 }
 
-};
\ No newline at end of file
+};
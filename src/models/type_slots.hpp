@@ -0,0 +1,51 @@
+/**
+ * @file type_slots.hpp
+ * @brief 内置类型槽位表（TypeSlots）定义
+ *  * 每个内置类型有一张 C++ 槽位表，运算符等直接调用其中的函数指针，
+ *    不经过属性查找、std::function 与参数 List；
+ *  * kiz 可见的 __add__ 等属性仍然存在，它们只是包装槽位函数的 NativeFunction；
+ *  * 槽位只对 __parent__ 仍为该类型原型的对象生效，且内置原型的属性一旦被改写，
+ *    所有槽位表随即停用，此后一律走动态的魔术方法查找。
+ *
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#pragma once
+
+namespace model {
+
+class Object;
+
+struct TypeSlots {
+    using Unary = Object* (*)(Object* self);
+    using Binary = Object* (*)(Object* self, Object* other);
+    using Ternary = Object* (*)(Object* self, Object* a, Object* b);
+
+    Object* proto = nullptr; // 该类型的原型, 为空表示没有槽位表
+
+    Binary add = nullptr;
+    Binary sub = nullptr;
+    Binary mul = nullptr;
+    Binary div = nullptr;
+    Binary mod = nullptr;
+    Binary pow = nullptr;
+    Binary eq = nullptr;
+    Binary lt = nullptr;
+    Binary gt = nullptr;
+    Binary getitem = nullptr;
+    Ternary setitem = nullptr;
+
+    Unary neg = nullptr;
+    Unary hash = nullptr;
+    Unary str = nullptr;
+    Unary bool_of = nullptr;
+    Unary next = nullptr;
+    Unary len = nullptr;
+};
+
+using UnarySlot = TypeSlots::Unary TypeSlots::*;
+using BinarySlot = TypeSlots::Binary TypeSlots::*;
+using TernarySlot = TypeSlots::Ternary TypeSlots::*;
+
+} // namespace model
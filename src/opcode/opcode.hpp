@@ -5,6 +5,7 @@
  * @date 2025-10-25
  */
 #pragma once
+#include <array>
 #include <cstdint>
 #include <string>
 
@@ -30,11 +31,39 @@ enum class Opcode : uint8_t {
     IMPORT,
     LOAD_ERROR,
     CACHE_ITER, GET_ITER, POP_ITER, JUMP_IF_FINISH_ITER,
+    FOR_RANGE,
 
     IS_CHILD, CREATE_OBJECT, COPY_TOP,
     STOP, LOAD_FREE_VAR, LOAD_BUILTINS
 };
 
+// FOR_RANGE之后固定跟随的通用取值指令序列, gen_for 按此序列生成并校验
+// 计数快速路径直接跳过它们进入循环体, 非Range迭代器则顺序执行它们
+inline constexpr Opcode FOR_RANGE_GENERIC_SEQ[] = {
+    Opcode::GET_ITER, Opcode::SET_LOCAL, Opcode::LOAD_VAR, Opcode::JUMP_IF_FINISH_ITER
+};
+inline constexpr size_t FOR_RANGE_GENERIC_LEN = std::size(FOR_RANGE_GENERIC_SEQ);
+
+// CALL_METHOD 的第二个操作数: 低 CALL_METHOD_ARGC_BITS 位为实参个数, 其余位为 CodeObject 分配的内联缓存下标
+inline constexpr uint32_t CALL_METHOD_ARGC_BITS = 8;
+inline constexpr uint32_t CALL_METHOD_MAX_ARGC = (1u << CALL_METHOD_ARGC_BITS) - 1;
+
+// 指令总数, 新增指令时需同步更新
+inline constexpr size_t OPCODE_COUNT = static_cast<size_t>(Opcode::LOAD_BUILTINS) + 1;
+
+// 执行后是否由调度循环自动 pc+1 (跳转/返回/抛出类指令自行维护pc)
+inline constexpr auto opcode_advances_pc = [] {
+    std::array<bool, OPCODE_COUNT> table{};
+    table.fill(true);
+    table[static_cast<size_t>(Opcode::JUMP)] = false;
+    table[static_cast<size_t>(Opcode::JUMP_IF_FALSE)] = false;
+    table[static_cast<size_t>(Opcode::RET)] = false;
+    table[static_cast<size_t>(Opcode::THROW)] = false;
+    table[static_cast<size_t>(Opcode::JUMP_IF_FINISH_ITER)] = false;
+    table[static_cast<size_t>(Opcode::FOR_RANGE)] = false;
+    return table;
+}();
+
 inline std::string opcode_to_string(Opcode opc) {
     switch (opc) {
     // 算术运算
@@ -92,6 +121,7 @@ inline std::string opcode_to_string(Opcode opc) {
     case Opcode::GET_ITER:    return "GET_ITER";
     case Opcode::POP_ITER:     return "POP_ITER";
     case Opcode::JUMP_IF_FINISH_ITER:  return "JUMP_IF_FINISH_ITER";
+    case Opcode::FOR_RANGE:   return "FOR_RANGE";
 
     // 其他
     case Opcode::IMPORT:      return "IMPORT";
@@ -1,4 +1,5 @@
 #include <format>
+#include <type_traits>
 
 #include "vm.hpp"
 #include "../models/models.hpp"
@@ -7,186 +8,281 @@
 
 namespace kiz {
 
+namespace {
+
+// 填写槽位表, 并在原型上注册包装该槽位函数的同名方法, 实参个数由槽位种类决定
+// 槽位函数假定接收者就是该类型, 包装方法以槽位表所属类型作为接收者类型, 由调用处检查
+template <auto F, typename Member>
+void def_slot(model::TypeSlots& slots, Member member, const dep::Symbol name) {
+    slots.*member = F;
+    constexpr uint8_t argc =
+        std::is_same_v<decltype(F), model::TypeSlots::Unary> ? 0
+        : std::is_same_v<decltype(F), model::TypeSlots::Binary> ? 1 : 2;
+    const auto self_type = model::type_bit(static_cast<model::Object::ObjectType>(&slots - model::type_slots));
+    slots.proto->attrs_insert(name, model::create_nfunc(model::slot_method<F>, name.str(), {argc, argc, {}, self_type}));
+}
+
+using model::NativeDef;
+using model::type_of;
+
+constexpr auto ANY = model::ANY_TYPE;
+constexpr auto INT = type_of<model::Int>;
+constexpr auto STR = type_of<model::String>;
+constexpr auto LIST = type_of<model::List>;
+constexpr auto VARIADIC = model::NativeSig::VARIADIC;
+
+// 各内置类型上非槽位的原生方法, 接收者类型在注册时统一指定
+constexpr NativeDef object_methods[] = {
+    {"__eq__", model::object_eq, {1, 1}},
+    {"__str__", model::object_str, {0, 0}},
+    {"__getitem__", model::object_getitem, {1, 1, {STR}}},
+    {"__setitem__", model::object_setitem, {2, 2, {STR}}},
+};
+
+constexpr NativeDef decimal_methods[] = {
+    {"limit_div", model::decimal_limit_div, {2, 2, {type_of<model::Int, model::Decimal>, INT}}},
+    {"round_div", model::decimal_round_div, {2, 2, {type_of<model::Int, model::Decimal>, INT}}},
+    {"approx", model::decimal_approx, {2, 2, {type_of<model::Int, model::Decimal>, INT}}},
+};
+
+constexpr NativeDef dict_methods[] = {
+    {"__contains__", model::dict_contains, {1, 1}},
+    {"__dstr__", model::dict_dstr, {0, 0}},
+    {"__iter__", model::dict_iter, {0, 0}},
+    {"foreach", model::dict_foreach, {1, 1}},
+    {"keys", model::dict_keys, {0, 0}},
+    {"values", model::dict_values, {0, 0}},
+    {"items", model::dict_items, {0, 0}},
+};
+
+constexpr NativeDef iterator_methods[] = {
+    {"__next__", model::iterator_next, {0, 0}},
+    {"__iter__", model::iterator_iter, {0, 0}},
+};
+
+constexpr NativeDef list_methods[] = {
+    {"__iter__", model::list_iter, {0, 0}},
+    {"__dstr__", model::list_dstr, {0, 0}},
+    {"append", model::list_append, {1, 1}},
+    {"contains", model::list_contains, {1, 1}},
+    {"foreach", model::list_foreach, {1, 1}},
+    {"reverse", model::list_reverse, {0, 0}},
+    {"extend", model::list_extend, {1, 1, {LIST}}},
+    {"pop", model::list_pop, {0, 0}},
+    {"insert", model::list_insert, {2, 2, {ANY, INT}}},
+    {"find", model::list_find, {1, 1}},
+    {"map", model::list_map, {1, 1}},
+    {"count", model::list_count, {1, 1}},
+    {"filter", model::list_filter, {1, 1}},
+    {"join", model::list_join, {1, 1}},
+};
+
+constexpr NativeDef str_methods[] = {
+    {"__dstr__", model::str_dstr, {0, 0}},
+    {"__iter__", model::str_iter, {0, 0}},
+    {"contains", model::str_contains, {1, 1, {STR}}},
+    {"count", model::str_count, {1, 1}},
+    {"foreach", model::str_foreach, {1, 1}},
+    {"startswith", model::str_startswith, {1, 1, {STR}}},
+    {"endswith", model::str_endswith, {1, 1, {STR}}},
+    {"substr", model::str_substr, {1, 2, {INT, INT}}},
+    {"isalpha", model::str_is_alpha, {0, 0}},
+    {"isdigit", model::str_is_digit, {0, 0}},
+    {"tolower", model::str_to_lower, {0, 0}},
+    {"toupper", model::str_to_upper, {0, 0}},
+    {"format", model::str_format, {0, VARIADIC}},
+};
+
+constexpr NativeDef file_handle_methods[] = {
+    {"read", model::file_handle_read, {0, 0}},
+    {"flush", model::file_handle_flush, {0, 0}},
+    {"write", model::file_handle_write, {1, 1}},
+    {"readline", model::file_handle_readline, {1, 1, {INT}}},
+    {"close", model::file_handle_close, {0, 0}},
+};
+
+constexpr NativeDef range_methods[] = {
+    {"__str__", model::range_str, {0, 0}},
+    {"__next__", model::range_next, {0, 0}},
+    {"__iter__", model::range_iter, {0, 0}},
+};
+
+constexpr NativeDef error_methods[] = {
+    {"__call__", model::error_call, {2, 2}},
+    {"__str__", model::error_str, {0, 0}},
+};
+
+// 原型的 __call__ 以原型自身或其子对象为接收者, 不限定接收者类型
+constexpr NativeDef int_call = {"__call__", model::int_call, {1, 1}};
+constexpr NativeDef bool_call = {"__call__", model::bool_call, {1, 1}};
+constexpr NativeDef decimal_call = {"__call__", model::decimal_call, {1, 1}};
+constexpr NativeDef list_call = {"__call__", model::list_call, {0, 1}};
+constexpr NativeDef str_call = {"__call__", model::str_call, {0, 1}};
+constexpr NativeDef range_call = {"__call__", model::range_call, {1, 3, {INT, INT, INT}}};
+
+constexpr NativeDef builtin_functions[] = {
+    {"print", builtin::print},
+    {"input", builtin::input, {0, 1, {STR}}},
+    {"ischild", builtin::ischild, {2, 2}},
+    {"create", builtin::create, {0, 1}},
+    {"now", builtin::now, {0, 0}},
+    {"get_refc", builtin::get_refc, {1, 1}},
+    {"alloc_stats", builtin::alloc_stats, {0, 0}},
+    {"breakpoint", builtin::breakpoint, {0, 0}},
+    {"cmd", builtin::cmd, {0, 1, {STR}}},
+    {"help", builtin::help, {0, 0}},
+    {"delattr", builtin::delattr, {2, 2, {ANY, STR}}},
+    {"setattr", builtin::setattr, {3, 3, {ANY, STR}}},
+    {"getattr", builtin::getattr, {2, 4}},
+    {"hasattr", builtin::hasattr, {2, 3}},
+    {"range", builtin::range, {1, 3, {INT, INT, INT}}},
+    {"type_of", builtin::type_of_obj, {1, 1}},
+    {"debug_str", builtin::debug_str, {1, 1}},
+    {"attr", builtin::attr, {1, 1}},
+    {"sleep", builtin::sleep, {1, 1, {INT}}},
+    {"open", builtin::open, {2, 2, {STR, STR}}},
+    {"assert", builtin::assert_, {1, 2}},
+    {"panic", builtin::panic, {1, 1, {STR}}},
+};
+
+} // namespace
+
 void Vm::entry_builtins() {
-    model::based_bool->attrs_insert("__parent__", model::based_obj);
-    model::based_int->attrs_insert("__parent__", model::based_obj);
-    model::unique_nil->attrs_insert("__parent__", model::based_obj);
-    model::based_function->attrs_insert("__parent__", model::based_obj);
-    model::based_decimal->attrs_insert("__parent__", model::based_obj);
-    model::based_module->attrs_insert("__parent__", model::based_obj);
-    model::based_dict->attrs_insert("__parent__", model::based_obj);
-    model::based_list->attrs_insert("__parent__", model::based_obj);
-    model::based_native_function->attrs_insert("__parent__", model::based_obj);
-    model::based_error->attrs_insert("__parent__", model::based_obj);
-    model::based_str->attrs_insert("__parent__", model::based_obj);
-    model::stop_iter_signal->attrs_insert("__parent__", model::based_obj);
-    model::based_code_object->attrs_insert("__parent__", model::based_obj);
-    model::based_file_handle->attrs_insert("__parent__", model::based_obj);
-    model::based_range->attrs_insert("__parent__", model::based_obj);
+    model::based_bool->set_parent(model::based_obj);
+    model::based_int->set_parent(model::based_obj);
+    model::unique_nil->set_parent(model::based_obj);
+    model::based_function->set_parent(model::based_obj);
+    model::based_decimal->set_parent(model::based_obj);
+    model::based_module->set_parent(model::based_obj);
+    model::based_dict->set_parent(model::based_obj);
+    model::based_list->set_parent(model::based_obj);
+    model::based_native_function->set_parent(model::based_obj);
+    model::based_error->set_parent(model::based_obj);
+    model::based_str->set_parent(model::based_obj);
+    model::stop_iter_signal->set_parent(model::based_obj);
+    model::based_code_object->set_parent(model::based_obj);
+    model::based_file_handle->set_parent(model::based_obj);
+    model::based_range->set_parent(model::based_obj);
+    model::based_iterator->set_parent(model::based_obj);
 
     // Object 基类 方法
-    model::based_obj->attrs_insert("__parent__", model::based_based_obj);
-    model::based_based_obj->attrs_insert("__eq__", model::create_nfunc(model::object_eq));
-    model::based_based_obj->attrs_insert("__str__", model::create_nfunc(model::object_str));
-    model::based_based_obj->attrs_insert("__getitem__", model::create_nfunc(model::object_getitem));
-    model::based_based_obj->attrs_insert("__setitem__", model::create_nfunc(model::object_setitem));
+    model::based_obj->set_parent(model::based_based_obj);
+    model::def_natives(model::based_based_obj, object_methods);
 
     // Bool 类型魔法方法
-    model::based_bool->attrs_insert("__eq__", model::create_nfunc(model::bool_eq));
-    model::based_bool->attrs_insert("__call__", model::create_nfunc(model::bool_call));
-    model::based_bool->attrs_insert("__hash__", model::create_nfunc(model::bool_hash));
-    model::based_bool->attrs_insert("__str__", model::create_nfunc(model::bool_str));
+    auto& bool_slots = model::init_type_slots(model::Bool::TYPE, model::based_bool);
+    model::based_bool->attrs_insert(bool_call.name, model::create_nfunc(bool_call));
+    def_slot<model::bool_eq>(bool_slots, &model::TypeSlots::eq, model::magic_name::eq);
+    def_slot<model::bool_hash>(bool_slots, &model::TypeSlots::hash, model::magic_name::hash);
+    def_slot<model::bool_str>(bool_slots, &model::TypeSlots::str, model::magic_name::str);
 
     // Nil 类型魔法方法
-    model::unique_nil->attrs_insert("__eq__", model::create_nfunc(model::nil_eq));
-    model::unique_nil->attrs_insert("__hash__", model::create_nfunc(model::nil_hash));
-    model::unique_nil->attrs_insert("__str__", model::create_nfunc(model::nil_str));
+    auto& nil_slots = model::init_type_slots(model::Nil::TYPE, model::unique_nil);
+    def_slot<model::nil_eq>(nil_slots, &model::TypeSlots::eq, model::magic_name::eq);
+    def_slot<model::nil_hash>(nil_slots, &model::TypeSlots::hash, model::magic_name::hash);
+    def_slot<model::nil_str>(nil_slots, &model::TypeSlots::str, model::magic_name::str);
 
     // Int 类型魔法方法
-    model::based_int->attrs_insert("__add__", model::create_nfunc(model::int_add));
-    model::based_int->attrs_insert("__sub__", model::create_nfunc(model::int_sub));
-    model::based_int->attrs_insert("__mul__", model::create_nfunc(model::int_mul));
-    model::based_int->attrs_insert("__div__", model::create_nfunc(model::int_div));
-    model::based_int->attrs_insert("__mod__", model::create_nfunc(model::int_mod));
-    model::based_int->attrs_insert("__pow__", model::create_nfunc(model::int_pow));
-    model::based_int->attrs_insert("__neg__", model::create_nfunc(model::int_neg));
-    model::based_int->attrs_insert("__gt__", model::create_nfunc(model::int_gt));
-    model::based_int->attrs_insert("__lt__", model::create_nfunc(model::int_lt));
-    model::based_int->attrs_insert("__eq__", model::create_nfunc(model::int_eq));
-    model::based_int->attrs_insert("__call__", model::create_nfunc(model::int_call));
-    model::based_int->attrs_insert("__bool__", model::create_nfunc(model::int_bool));
-    model::based_int->attrs_insert("__hash__", model::create_nfunc(model::int_hash));
-    model::based_int->attrs_insert("__str__", model::create_nfunc(model::int_str));
+    auto& int_slots = model::init_type_slots(model::Int::TYPE, model::based_int);
+    model::based_int->attrs_insert(int_call.name, model::create_nfunc(int_call));
+    def_slot<model::int_add>(int_slots, &model::TypeSlots::add, model::magic_name::add);
+    def_slot<model::int_sub>(int_slots, &model::TypeSlots::sub, model::magic_name::sub);
+    def_slot<model::int_mul>(int_slots, &model::TypeSlots::mul, model::magic_name::mul);
+    def_slot<model::int_div>(int_slots, &model::TypeSlots::div, model::magic_name::div);
+    def_slot<model::int_mod>(int_slots, &model::TypeSlots::mod, model::magic_name::mod);
+    def_slot<model::int_pow>(int_slots, &model::TypeSlots::pow, model::magic_name::pow);
+    def_slot<model::int_neg>(int_slots, &model::TypeSlots::neg, model::magic_name::neg);
+    def_slot<model::int_gt>(int_slots, &model::TypeSlots::gt, model::magic_name::gt);
+    def_slot<model::int_lt>(int_slots, &model::TypeSlots::lt, model::magic_name::lt);
+    def_slot<model::int_eq>(int_slots, &model::TypeSlots::eq, model::magic_name::eq);
+    def_slot<model::int_bool>(int_slots, &model::TypeSlots::bool_of, model::magic_name::bool_of);
+    def_slot<model::int_hash>(int_slots, &model::TypeSlots::hash, model::magic_name::hash);
+    def_slot<model::int_str>(int_slots, &model::TypeSlots::str, model::magic_name::str);
 
     // Decimal类型魔术方法
-    model::based_decimal->attrs_insert("__add__", model::create_nfunc(model::decimal_add));
-    model::based_decimal->attrs_insert("__sub__", model::create_nfunc(model::decimal_sub));
-    model::based_decimal->attrs_insert("__mul__", model::create_nfunc(model::decimal_mul));
-    model::based_decimal->attrs_insert("__div__", model::create_nfunc(model::decimal_div));
-    model::based_decimal->attrs_insert("__pow__", model::create_nfunc(model::decimal_pow));
-    model::based_decimal->attrs_insert("__neg__", model::create_nfunc(model::decimal_neg));
-    model::based_decimal->attrs_insert("__gt__", model::create_nfunc(model::decimal_gt));
-    model::based_decimal->attrs_insert("__lt__", model::create_nfunc(model::decimal_lt));
-    model::based_decimal->attrs_insert("__eq__", model::create_nfunc(model::decimal_eq));
-    model::based_decimal->attrs_insert("__call__", model::create_nfunc(model::decimal_call));
-    model::based_decimal->attrs_insert("__bool__", model::create_nfunc(model::decimal_bool));
-    model::based_decimal->attrs_insert("__hash__", model::create_nfunc(model::decimal_hash));
-    model::based_decimal->attrs_insert("__str__", model::create_nfunc(model::decimal_str));
-    model::based_decimal->attrs_insert("limit_div", model::create_nfunc(model::decimal_limit_div));
-    model::based_decimal->attrs_insert("round_div", model::create_nfunc(model::decimal_round_div));
-    model::based_decimal->attrs_insert("approx", model::create_nfunc(model::decimal_approx));
+    auto& decimal_slots = model::init_type_slots(model::Decimal::TYPE, model::based_decimal);
+    model::based_decimal->attrs_insert(decimal_call.name, model::create_nfunc(decimal_call));
+    model::def_natives(model::based_decimal, decimal_methods, type_of<model::Decimal>);
+    def_slot<model::decimal_add>(decimal_slots, &model::TypeSlots::add, model::magic_name::add);
+    def_slot<model::decimal_sub>(decimal_slots, &model::TypeSlots::sub, model::magic_name::sub);
+    def_slot<model::decimal_mul>(decimal_slots, &model::TypeSlots::mul, model::magic_name::mul);
+    def_slot<model::decimal_div>(decimal_slots, &model::TypeSlots::div, model::magic_name::div);
+    def_slot<model::decimal_pow>(decimal_slots, &model::TypeSlots::pow, model::magic_name::pow);
+    def_slot<model::decimal_neg>(decimal_slots, &model::TypeSlots::neg, model::magic_name::neg);
+    def_slot<model::decimal_gt>(decimal_slots, &model::TypeSlots::gt, model::magic_name::gt);
+    def_slot<model::decimal_lt>(decimal_slots, &model::TypeSlots::lt, model::magic_name::lt);
+    def_slot<model::decimal_eq>(decimal_slots, &model::TypeSlots::eq, model::magic_name::eq);
+    def_slot<model::decimal_bool>(decimal_slots, &model::TypeSlots::bool_of, model::magic_name::bool_of);
+    def_slot<model::decimal_hash>(decimal_slots, &model::TypeSlots::hash, model::magic_name::hash);
+    def_slot<model::decimal_str>(decimal_slots, &model::TypeSlots::str, model::magic_name::str);
 
     // Dictionary 类型魔法方法
-    model::based_dict->attrs_insert("__add__", model::create_nfunc(model::dict_add));
-    model::based_dict->attrs_insert("__contains__", model::create_nfunc(model::dict_contains));
-    model::based_dict->attrs_insert("__getitem__", model::create_nfunc(model::dict_getitem));
-    model::based_dict->attrs_insert("__str__", model::create_nfunc(model::dict_str));
-    model::based_dict->attrs_insert("__dstr__", model::create_nfunc(model::dict_dstr));
-    model::based_dict->attrs_insert("__setitem__", model::create_nfunc(model::dict_setitem));
-    model::based_dict->attrs_insert("__next__", model::create_nfunc(model::dict_next));
-    model::based_dict->attrs_insert("foreach", model::create_nfunc(model::dict_foreach));
-    model::based_dict->attrs_insert("len", model::create_nfunc(model::dict_len));
+    auto& dict_slots = model::init_type_slots(model::Dictionary::TYPE, model::based_dict);
+    model::def_natives(model::based_dict, dict_methods, type_of<model::Dictionary>);
+    def_slot<model::dict_add>(dict_slots, &model::TypeSlots::add, model::magic_name::add);
+    def_slot<model::dict_getitem>(dict_slots, &model::TypeSlots::getitem, model::magic_name::getitem);
+    def_slot<model::dict_str>(dict_slots, &model::TypeSlots::str, model::magic_name::str);
+    def_slot<model::dict_setitem>(dict_slots, &model::TypeSlots::setitem, model::magic_name::setitem);
+    def_slot<model::dict_next>(dict_slots, &model::TypeSlots::next, model::magic_name::next_item);
+    def_slot<model::dict_len>(dict_slots, &model::TypeSlots::len, dep::intern("len"));
+
+    // Iterator 类型（List/Str/Dict 的原生迭代器共用）
+    model::def_natives(model::based_iterator, iterator_methods, type_of<model::NativeIterator>);
 
     // List 类型魔法方法
-    model::based_list->attrs_insert("__add__", model::create_nfunc(model::list_add));
-    model::based_list->attrs_insert("__mul__", model::create_nfunc(model::list_mul));
-    model::based_list->attrs_insert("__eq__", model::create_nfunc(model::list_eq));
-    model::based_list->attrs_insert("__call__", model::create_nfunc(model::list_call));
-    model::based_list->attrs_insert("__bool__", model::create_nfunc(model::list_bool));
-    model::based_list->attrs_insert("__next__", model::create_nfunc(model::list_next));
-    model::based_list->attrs_insert("__getitem__", model::create_nfunc(model::list_getitem));
-    model::based_list->attrs_insert("__setitem__", model::create_nfunc(model::list_setitem));
-    model::based_list->attrs_insert("__str__", model::create_nfunc(model::list_str));
-    model::based_list->attrs_insert("__dstr__", model::create_nfunc(model::list_dstr));
-
-    model::based_list->attrs_insert("append", model::create_nfunc(model::list_append));
-    model::based_list->attrs_insert("contains", model::create_nfunc(model::list_contains));
-    model::based_list->attrs_insert("foreach", model::create_nfunc(model::list_foreach));
-    model::based_list->attrs_insert("reverse", model::create_nfunc(model::list_reverse));
-    model::based_list->attrs_insert("extend", model::create_nfunc(model::list_extend));
-    model::based_list->attrs_insert("pop", model::create_nfunc(model::list_pop));
-    model::based_list->attrs_insert("insert", model::create_nfunc(model::list_insert));
-    model::based_list->attrs_insert("find", model::create_nfunc(model::list_find));
-    model::based_list->attrs_insert("map", model::create_nfunc(model::list_map));
-    model::based_list->attrs_insert("count", model::create_nfunc(model::list_count));
-    model::based_list->attrs_insert("filter", model::create_nfunc(model::list_filter));
-    model::based_list->attrs_insert("len", model::create_nfunc(model::list_len));
-    model::based_list->attrs_insert("join", model::create_nfunc(model::list_join));
+    auto& list_slots = model::init_type_slots(model::List::TYPE, model::based_list);
+    model::based_list->attrs_insert(list_call.name, model::create_nfunc(list_call));
+    model::def_natives(model::based_list, list_methods, LIST);
+    def_slot<model::list_add>(list_slots, &model::TypeSlots::add, model::magic_name::add);
+    def_slot<model::list_mul>(list_slots, &model::TypeSlots::mul, model::magic_name::mul);
+    def_slot<model::list_eq>(list_slots, &model::TypeSlots::eq, model::magic_name::eq);
+    def_slot<model::list_bool>(list_slots, &model::TypeSlots::bool_of, model::magic_name::bool_of);
+    def_slot<model::list_next>(list_slots, &model::TypeSlots::next, model::magic_name::next_item);
+    def_slot<model::list_getitem>(list_slots, &model::TypeSlots::getitem, model::magic_name::getitem);
+    def_slot<model::list_setitem>(list_slots, &model::TypeSlots::setitem, model::magic_name::setitem);
+    def_slot<model::list_str>(list_slots, &model::TypeSlots::str, model::magic_name::str);
+    def_slot<model::list_len>(list_slots, &model::TypeSlots::len, dep::intern("len"));
 
     // String 类型魔法方法
-    model::based_str->attrs_insert("__add__", model::create_nfunc(model::str_add));
-    model::based_str->attrs_insert("__mul__", model::create_nfunc(model::str_mul));
-    model::based_str->attrs_insert("__eq__", model::create_nfunc(model::str_eq));
-    model::based_str->attrs_insert("__call__", model::create_nfunc(model::str_call));
-    model::based_str->attrs_insert("__bool__", model::create_nfunc(model::str_bool));
-    model::based_str->attrs_insert("__hash__", model::create_nfunc(model::str_hash));
-    model::based_str->attrs_insert("__getitem__", model::create_nfunc(model::str_getitem));
-    model::based_str->attrs_insert("__str__", model::create_nfunc(model::str_str));
-    model::based_str->attrs_insert("__dstr__", model::create_nfunc(model::str_dstr));
-    model::based_str->attrs_insert("__next__", model::create_nfunc(model::str_next));
-
-    model::based_str->attrs_insert("contains", model::create_nfunc(model::str_contains));
-    model::based_str->attrs_insert("count", model::create_nfunc(model::str_count));
-    model::based_str->attrs_insert("foreach", model::create_nfunc(model::str_foreach));
-    model::based_str->attrs_insert("startswith", model::create_nfunc(model::str_startswith));
-    model::based_str->attrs_insert("endswith", model::create_nfunc(model::str_endswith));
-    model::based_str->attrs_insert("substr", model::create_nfunc(model::str_substr));
-    model::based_str->attrs_insert("len", model::create_nfunc(model::str_len));
-    model::based_str->attrs_insert("isalpha", model::create_nfunc(model::str_is_alpha));
-    model::based_str->attrs_insert("isdigit", model::create_nfunc(model::str_is_digit));
-    model::based_str->attrs_insert("tolower", model::create_nfunc(model::str_to_lower));
-    model::based_str->attrs_insert("toupper", model::create_nfunc(model::str_to_upper));
-    model::based_str->attrs_insert("format", model::create_nfunc(model::str_format));
+    auto& str_slots = model::init_type_slots(model::String::TYPE, model::based_str);
+    model::based_str->attrs_insert(str_call.name, model::create_nfunc(str_call));
+    model::def_natives(model::based_str, str_methods, STR);
+    def_slot<model::str_add>(str_slots, &model::TypeSlots::add, model::magic_name::add);
+    def_slot<model::str_mul>(str_slots, &model::TypeSlots::mul, model::magic_name::mul);
+    def_slot<model::str_eq>(str_slots, &model::TypeSlots::eq, model::magic_name::eq);
+    def_slot<model::str_bool>(str_slots, &model::TypeSlots::bool_of, model::magic_name::bool_of);
+    def_slot<model::str_hash>(str_slots, &model::TypeSlots::hash, model::magic_name::hash);
+    def_slot<model::str_getitem>(str_slots, &model::TypeSlots::getitem, model::magic_name::getitem);
+    def_slot<model::str_str>(str_slots, &model::TypeSlots::str, model::magic_name::str);
+    def_slot<model::str_next>(str_slots, &model::TypeSlots::next, model::magic_name::next_item);
+    def_slot<model::str_len>(str_slots, &model::TypeSlots::len, dep::intern("len"));
 
     // FileHandle类型
-    model::based_file_handle->attrs_insert("read", model::create_nfunc(model::file_handle_read));
-    model::based_file_handle->attrs_insert("flush", model::create_nfunc(model::file_handle_flush));
-    model::based_file_handle->attrs_insert("write", model::create_nfunc(model::file_handle_write));
-    model::based_file_handle->attrs_insert("readline", model::create_nfunc(model::file_handle_readline));
-    model::based_file_handle->attrs_insert("close", model::create_nfunc(model::file_handle_close));
+    model::def_natives(model::based_file_handle, file_handle_methods, type_of<model::FileHandle>);
 
     // Range类型
-    model::based_range->attrs_insert("__call__", model::create_nfunc(model::range_call));
-    model::based_range->attrs_insert("__str__", model::create_nfunc(model::range_str));
-    model::based_range->attrs_insert("__next__", model::create_nfunc(model::range_next));
+    model::based_range->attrs_insert(range_call.name, model::create_nfunc(range_call));
+    model::def_natives(model::based_range, range_methods, type_of<model::Range>);
 
     // Error类型
-    model::based_error->attrs_insert("__call__", model::create_nfunc(model::error_call));
-    model::based_error->attrs_insert("__str__", model::create_nfunc(model::error_str));
+    model::def_natives(model::based_error, error_methods);
 
     // Module类型
-    model::based_module->attrs_insert("__str__", model::create_nfunc(model::module_str));
+    model::based_module->attrs_insert(model::magic_name::str, model::create_nfunc(model::module_str, "__str__", {0, 0, {}, type_of<model::Module>}));
     // Function类型
-    model::based_function->attrs_insert("__str__", model::create_nfunc(model::function_str));
+    model::based_function->attrs_insert(model::magic_name::str, model::create_nfunc(model::function_str, "__str__", {0, 0, {}, type_of<model::Function>}));
     // NativeFunction类型
-    model::based_native_function->attrs_insert("__str__", model::create_nfunc(model::native_function_str));
+    model::based_native_function->attrs_insert(model::magic_name::str, model::create_nfunc(model::native_function_str, "__str__", {0, 0, {}, type_of<model::NativeFunction>}));
 
+    // 内置对象常驻整个进程, 标记为永生以便 LOAD_BUILTINS 借用压栈
     auto builtin_insert = [](const std::string& name,  model::Object* f) {
-        f->make_ref();
+        f->mark_as_important();
         builtins.push_back(f);
         builtin_names.push_back(name);
     };
-    builtin_insert("print", model::create_nfunc(builtin::print, "print"));
-    builtin_insert("input", model::create_nfunc(builtin::input, "input"));
-    builtin_insert("ischild", model::create_nfunc(builtin::ischild, "ischild"));
-    builtin_insert("create", model::create_nfunc(builtin::create, "create"));
-    builtin_insert("now", model::create_nfunc(builtin::now, "now"));
-    builtin_insert("get_refc", model::create_nfunc(builtin::get_refc, "get_refc"));
-    builtin_insert("breakpoint", model::create_nfunc(builtin::breakpoint, "breakpoint"));
-    builtin_insert("cmd", model::create_nfunc(builtin::cmd, "cmd"));
-    builtin_insert("help", model::create_nfunc(builtin::help, "help"));
-    builtin_insert("delattr", model::create_nfunc(builtin::delattr, "delattr"));
-    builtin_insert("setattr", model::create_nfunc(builtin::setattr, "setattr"));
-    builtin_insert("getattr", model::create_nfunc(builtin::getattr, "getattr"));
-    builtin_insert("hasattr", model::create_nfunc(builtin::hasattr, "hasattr"));
-    builtin_insert("range", model::create_nfunc(builtin::range, "range"));
-    builtin_insert("type_of", model::create_nfunc(builtin::type_of_obj, "type_of"));
-    builtin_insert("debug_str", model::create_nfunc(builtin::debug_str, "debug_str"));
-    builtin_insert("attr", model::create_nfunc(builtin::attr, "attr"));
-    builtin_insert("sleep", model::create_nfunc(builtin::sleep, "sleep"));
-    builtin_insert("open", model::create_nfunc(builtin::open, "open"));
-    builtin_insert("assert", model::create_nfunc(builtin::assert_, "assert"));
-    builtin_insert("panic", model::create_nfunc(builtin::panic, "panic"));
+    for (const auto& def : builtin_functions) {
+        builtin_insert(def.name, model::create_nfunc(def));
+    }
 
     builtin_insert("__BasedObject", model::based_based_obj);
     builtin_insert("Object", model::based_obj);
@@ -204,5 +300,8 @@ void Vm::entry_builtins() {
     builtin_insert("Range", model::based_range);
     builtin_insert("__CodeObject", model::based_code_object);
     builtin_insert("__StopIterSignal__", model::stop_iter_signal);
+
+    // 内置原型注册完毕, 此后对它们的改写会停用槽位表
+    builtin_slots_valid = true;
 }
 }
@@ -1,6 +1,7 @@
 #include "../models/models.hpp"
 #include "builtins/include/builtins_lib.hpp"
 #include "os/include/os_lib.hpp"
+#include "gc/include/gc_lib.hpp"
 
 namespace kiz {
 
@@ -9,7 +10,8 @@ void Vm::entry_std_modules() {
         o->make_ref();
         std_modules.insert(name, o);
     };
-    std_modules_insert("builtins", model::create_nfunc(builtins_lib::init_module, "__init__"));
-    std_modules_insert("os", model::create_nfunc(os_lib::init_module, "__init__"));
+    std_modules_insert("builtins", model::create_nfunc(builtins_lib::init_module, "__init__", {0, 0}));
+    std_modules_insert("os", model::create_nfunc(os_lib::init_module, "__init__", {0, 0}));
+    std_modules_insert("gc", model::create_nfunc(gc_lib::init_module, "__init__", {0, 0}));
 }
 } // namespace model
\ No newline at end of file
@@ -2,359 +2,677 @@
 #include "../../libs/builtins/include/builtin_functions.hpp"
 #include "../opcode/opcode.hpp"
 
+#include <optional>
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define KIZ_COMPUTED_GOTO
+#endif
+
+// 取指: 栈帧代码执行完毕时转到frame_end
+// 计算跳转不会析构被跳出作用域中的局部对象, 因此只能在持有StackRef/StackArgs的作用域结束之后分派
+#ifdef KIZ_COMPUTED_GOTO
+    #define VM_CASE(op) L_##op:
+    #define VM_DISPATCH() \
+        do { \
+            curr_frame = &call_stack.back(); \
+            if (curr_frame->pc >= curr_frame->code_object->code.size()) goto frame_end; \
+            instruction = curr_frame->code_object->code[curr_frame->pc]; \
+            goto *dispatch_table[static_cast<size_t>(instruction.opc)]; \
+        } while (0)
+#else
+    #define VM_CASE(op) case Opcode::op:
+    #define VM_DISPATCH() continue
+#endif
+
+// 循环回收的安全点: 只在最外层调度循环中回收, 嵌套调度时外层原生函数可能还借用着未计数的对象
+#define VM_GC_SAFEPOINT() \
+    if (Gc::pending and stop_depth == 0) Gc::collect_pending()
+
+// 调用可能以待处理错误结束(没有压入结果): 直接转发到handle_throw并从捕获处继续, 不经过C++异常
+// 与分派相同, 只能在持有StackRef/StackArgs的作用域结束之后使用; 作用域内以 error_pending 跳过后续步骤
+#define VM_CHECK_ERROR() \
+    if (error_pending) [[unlikely]] { \
+        forward_pending_error(); \
+        if (call_stack.size() <= stop_depth) return; \
+        VM_DISPATCH(); \
+    }
+
+// 指令执行结束: 按opcode_advances_pc推进执行该指令的栈帧, 然后分派下一条指令
+#define VM_NEXT(op) \
+    if constexpr (opcode_advances_pc[static_cast<size_t>(Opcode::op)]) { \
+        curr_frame->pc++; \
+    } \
+    VM_DISPATCH()
+
 ///| 核心执行单元
 namespace kiz {
-void Vm::execute_unit(const Instruction& instruction) {
+
+namespace {
+
+using ObjectType = model::Object::ObjectType;
+
+dep::Decimal to_decimal(model::Object* num) {
+    if (num->get_type() == ObjectType::Int) {
+        return dep::Decimal(static_cast<model::Int*>(num)->val);
+    }
+    return static_cast<model::Decimal*>(num)->val;
+}
+
+bool is_number(const ObjectType t) {
+    return t == ObjectType::Int or t == ObjectType::Decimal;
+}
+
+// 弹出栈顶作为要存入变量槽位的值: 不可变值直接接管栈对它的引用, 可变容器则存入持有引用的副本
+model::Object* take_stack_top_for_store() {
+    const auto value = Vm::simple_get_and_pop_stack_top();
+    const auto new_val = model::copy_if_mutable(value);
+    if (new_val != value) {
+        new_val->make_ref();
+        value->del_ref();
+    }
+    return new_val;
+}
+
+// 内置Int/Decimal/String二元运算的快速路径, 结果与对应的__add__等原生方法一致
+// 返回nullptr表示不适用(包括需要报错的情况), 由调用方回退到call_slot
+model::Object* fast_binary_op(const Opcode opc, model::Object* a, model::Object* b) {
+    // 与call_slot相同: 内置原型被改写或原型链被修改时, 交由脚本中的魔术方法处理
+    if (!model::slots_of(a)) return nullptr;
+
+    const auto ta = a->get_type();
+    const auto tb = b->get_type();
+
+    if (ta == ObjectType::Int and tb == ObjectType::Int) {
+        const auto& x = static_cast<model::Int*>(a)->val;
+        const auto& y = static_cast<model::Int*>(b)->val;
+        switch (opc) {
+        case Opcode::OP_ADD: return new model::Int(x + y);
+        case Opcode::OP_SUB: return new model::Int(x - y);
+        case Opcode::OP_MUL: return new model::Int(x * y);
+        case Opcode::OP_DIV: {
+            if (y == dep::BigInt(0)) return nullptr;
+            return new model::Decimal(dep::Decimal(x).div(dep::Decimal(y), 10));
+        }
+        case Opcode::OP_MOD: {
+            if (y == dep::BigInt(0)) return nullptr;
+            dep::BigInt remainder = x % y;
+            // 修正余数符号（确保与除数同号）
+            if (remainder != dep::BigInt(0) and (x < dep::BigInt(0)) != (y < dep::BigInt(0))) {
+                remainder += y;
+            }
+            return new model::Int(remainder);
+        }
+        case Opcode::OP_POW: {
+            if (y.is_negative()) return nullptr;
+            return new model::Int(x.pow(y));
+        }
+        default: return nullptr;
+        }
+    }
+
+    if (is_number(ta) and is_number(tb)) {
+        // 至少一方为Decimal, 结果为Decimal
+        const auto x = to_decimal(a);
+        const auto y = to_decimal(b);
+        switch (opc) {
+        case Opcode::OP_ADD: return new model::Decimal(x + y);
+        case Opcode::OP_SUB: return new model::Decimal(x - y);
+        case Opcode::OP_MUL: return new model::Decimal(x * y);
+        case Opcode::OP_DIV: {
+            if (y == dep::Decimal(dep::BigInt(0))) return nullptr;
+            return new model::Decimal(x.div(y, 10));
+        }
+        default: return nullptr;
+        }
+    }
+
+    if (ta == ObjectType::String and tb == ObjectType::String and opc == Opcode::OP_ADD) {
+        return new model::String(static_cast<model::String*>(a)->val + static_cast<model::String*>(b)->val);
+    }
+    return nullptr;
+}
+
+// 内置Int/Decimal/String比较的快速路径, OP_GE/OP_LE/OP_NE与慢路径的 eq/gt/lt 组合语义一致
+std::optional<bool> fast_compare(const Opcode opc, model::Object* a, model::Object* b) {
+    if (!model::slots_of(a)) return std::nullopt;
+
+    const auto ta = a->get_type();
+    const auto tb = b->get_type();
+
+    auto compare = [opc](const auto& x, const auto& y) -> std::optional<bool> {
+        switch (opc) {
+        case Opcode::OP_EQ: return x == y;
+        case Opcode::OP_NE: return x != y;
+        case Opcode::OP_GT: return x > y;
+        case Opcode::OP_LT: return x < y;
+        case Opcode::OP_GE: return x >= y;
+        case Opcode::OP_LE: return x <= y;
+        default: return std::nullopt;
+        }
+    };
+
+    if (ta == ObjectType::Int and tb == ObjectType::Int) {
+        return compare(static_cast<model::Int*>(a)->val, static_cast<model::Int*>(b)->val);
+    }
+    if (is_number(ta) and is_number(tb)) {
+        return compare(to_decimal(a), to_decimal(b));
+    }
+    if (ta == ObjectType::String and tb == ObjectType::String
+        and (opc == Opcode::OP_EQ or opc == Opcode::OP_NE)) {
+        return compare(static_cast<model::String*>(a)->val, static_cast<model::String*>(b)->val);
+    }
+    return std::nullopt;
+}
+
+}
+
+void Vm::execute_until(const size_t stop_depth) {
+    while (running and call_stack.size() > stop_depth) {
+        try {
+            dispatch(stop_depth);
+            return;
+        } catch (NativeFuncError& e) {
+            error_pending = false;
+            forward_to_handle_throw(e.name, e.msg);
+        }
+    }
+}
+
+void Vm::dispatch(const size_t stop_depth) {
+    CallFrame* curr_frame = nullptr;
+    Instruction instruction{Opcode::STOP, {}};
+
+#ifdef KIZ_COMPUTED_GOTO
+    // 须与Opcode枚举顺序一致
+    static void* dispatch_table[] = {
+        &&L_OP_ADD,
+        &&L_OP_SUB,
+        &&L_OP_MUL,
+        &&L_OP_DIV,
+        &&L_OP_MOD,
+        &&L_OP_POW,
+        &&L_OP_NEG,
+        &&L_OP_EQ,
+        &&L_OP_GT,
+        &&L_OP_LT,
+        &&L_OP_GE,
+        &&L_OP_LE,
+        &&L_OP_NE,
+        &&L_OP_NOT,
+        &&L_OP_IS,
+        &&L_OP_IN,
+        &&L_CALL,
+        &&L_RET,
+        &&L_CREATE_CLOSURE,
+        &&L_GET_ATTR,
+        &&L_SET_ATTR,
+        &&L_CALL_METHOD,
+        &&L_GET_ITEM,
+        &&L_SET_ITEM,
+        &&L_LOAD_VAR,
+        &&L_LOAD_CONST,
+        &&L_SET_GLOBAL,
+        &&L_SET_LOCAL,
+        &&L_SET_NONLOCAL,
+        &&L_JUMP,
+        &&L_JUMP_IF_FALSE,
+        &&L_THROW,
+        &&L_MAKE_LIST,
+        &&L_MAKE_DICT,
+        &&L_IMPORT,
+        &&L_LOAD_ERROR,
+        &&L_CACHE_ITER,
+        &&L_GET_ITER,
+        &&L_POP_ITER,
+        &&L_JUMP_IF_FINISH_ITER,
+        &&L_FOR_RANGE,
+        &&L_IS_CHILD,
+        &&L_CREATE_OBJECT,
+        &&L_COPY_TOP,
+        &&L_STOP,
+        &&L_LOAD_FREE_VAR,
+        &&L_LOAD_BUILTINS
+    };
+    static_assert(std::size(dispatch_table) == OPCODE_COUNT);
+
+    VM_DISPATCH();
+
+frame_end:
+    // 调度起点的栈帧执行完毕则返回, 其余栈帧直接出栈
+    if (call_stack.size() <= stop_depth + 1) return;
+    call_stack.pop_back();
+    VM_DISPATCH();
+#else
+    for (;;) {
+    curr_frame = &call_stack.back();
+    if (curr_frame->pc >= curr_frame->code_object->code.size()) {
+        if (call_stack.size() <= stop_depth + 1) return;
+        call_stack.pop_back();
+        continue;
+    }
+    instruction = curr_frame->code_object->code[curr_frame->pc];
+
     switch (instruction.opc) {
-    case Opcode::OP_ADD: {
+#endif
+
+    VM_CASE(OP_ADD) {
         auto b = get_and_pop_stack_top();
         auto a = get_and_pop_stack_top();
-        call_method(a.get(), "__add__", {b.get()});
-        break;
+        if (auto result = fast_binary_op(Opcode::OP_ADD, a.get(), b.get())) {
+            push_to_stack(result);
+        } else {
+            call_slot(a.get(), &model::TypeSlots::add, model::magic_name::add, b.get());
+        }
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(OP_ADD);
 
-    case Opcode::OP_SUB: {
+    VM_CASE(OP_SUB) {
         auto b = get_and_pop_stack_top();
         auto a = get_and_pop_stack_top();
-        call_method(a.get(), "__sub__", {b.get()});
-        break;
+        if (auto result = fast_binary_op(Opcode::OP_SUB, a.get(), b.get())) {
+            push_to_stack(result);
+        } else {
+            call_slot(a.get(), &model::TypeSlots::sub, model::magic_name::sub, b.get());
+        }
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(OP_SUB);
 
-    case Opcode::OP_MUL: {
+    VM_CASE(OP_MUL) {
         auto b = get_and_pop_stack_top();
         auto a = get_and_pop_stack_top();
-        call_method(a.get(), "__mul__", {b.get()});
-        break;
+        if (auto result = fast_binary_op(Opcode::OP_MUL, a.get(), b.get())) {
+            push_to_stack(result);
+        } else {
+            call_slot(a.get(), &model::TypeSlots::mul, model::magic_name::mul, b.get());
+        }
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(OP_MUL);
 
-    case Opcode::OP_DIV: {
+    VM_CASE(OP_DIV) {
         auto b = get_and_pop_stack_top();
         auto a = get_and_pop_stack_top();
-        call_method(a.get(), "__div__", {b.get()});
-        break;
+        if (auto result = fast_binary_op(Opcode::OP_DIV, a.get(), b.get())) {
+            push_to_stack(result);
+        } else {
+            call_slot(a.get(), &model::TypeSlots::div, model::magic_name::div, b.get());
+        }
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(OP_DIV);
 
-    case Opcode::OP_MOD: {
+    VM_CASE(OP_MOD) {
         auto b = get_and_pop_stack_top();
         auto a = get_and_pop_stack_top();
-        call_method(a.get(), "__mod__", {b.get()});
-        break;
+        if (auto result = fast_binary_op(Opcode::OP_MOD, a.get(), b.get())) {
+            push_to_stack(result);
+        } else {
+            call_slot(a.get(), &model::TypeSlots::mod, model::magic_name::mod, b.get());
+        }
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(OP_MOD);
 
-    case Opcode::OP_POW: {
+    VM_CASE(OP_POW) {
         auto b = get_and_pop_stack_top();
         auto a = get_and_pop_stack_top();
-        call_method(a.get(), "__pow__", {b.get()});
-        break;
+        if (auto result = fast_binary_op(Opcode::OP_POW, a.get(), b.get())) {
+            push_to_stack(result);
+        } else {
+            call_slot(a.get(), &model::TypeSlots::pow, model::magic_name::pow, b.get());
+        }
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(OP_POW);
 
-    case Opcode::OP_NEG: {
+    VM_CASE(OP_NEG) {
         auto a = get_and_pop_stack_top();
-        call_method(a.get(), "__neg__", {});
-        break;
+        call_slot(a.get(), &model::TypeSlots::neg, model::magic_name::neg);
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(OP_NEG);
 
-    case Opcode::OP_EQ: {
+    VM_CASE(OP_EQ) {
         auto b = get_and_pop_stack_top();
         auto a = get_and_pop_stack_top();
-
-        call_method(a.get(), "__eq__", {b.get()});
-        break;
+        if (auto result = fast_compare(Opcode::OP_EQ, a.get(), b.get())) {
+            push_borrowed_to_stack(model::load_bool(*result));
+        } else {
+            call_slot(a.get(), &model::TypeSlots::eq, model::magic_name::eq, b.get());
+        }
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(OP_EQ);
 
-    case Opcode::OP_GT: {
+    VM_CASE(OP_GT) {
         auto b = get_and_pop_stack_top();
         auto a = get_and_pop_stack_top();
-
-        call_method(a.get(), "__gt__", {b.get()});
-        break;
+        if (auto result = fast_compare(Opcode::OP_GT, a.get(), b.get())) {
+            push_borrowed_to_stack(model::load_bool(*result));
+        } else {
+            call_slot(a.get(), &model::TypeSlots::gt, model::magic_name::gt, b.get());
+        }
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(OP_GT);
 
-    case Opcode::OP_LT: {
+    VM_CASE(OP_LT) {
         auto b = get_and_pop_stack_top();
         auto a = get_and_pop_stack_top();
-
-        call_method(a.get(), "__lt__", {b.get()});
-        break;
+        if (auto result = fast_compare(Opcode::OP_LT, a.get(), b.get())) {
+            push_borrowed_to_stack(model::load_bool(*result));
+        } else {
+            call_slot(a.get(), &model::TypeSlots::lt, model::magic_name::lt, b.get());
+        }
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(OP_LT);
 
-    case Opcode::OP_GE: {
+    VM_CASE(OP_GE) {
         auto b = get_and_pop_stack_top();
         auto a = get_and_pop_stack_top();
-
-        call_method(a.get(), "__eq__", {b.get()});
-        call_method(a.get(), "__gt__", {b.get()});
-
-        // 统一使用封装的栈操作获取结果
-        auto gt_result = get_and_pop_stack_top();
-        auto eq_result = get_and_pop_stack_top();
-
-        // 压入最终结果
-        if (is_true(gt_result.get()) or is_true(eq_result.get())) {
-            push_to_stack(model::load_true());
+        if (auto result = fast_compare(Opcode::OP_GE, a.get(), b.get())) {
+            push_borrowed_to_stack(model::load_bool(*result));
         } else {
-            push_to_stack(model::load_false());
+            // 任一调用失败都留下待处理错误并跳过其后的步骤
+            call_slot(a.get(), &model::TypeSlots::eq, model::magic_name::eq, b.get());
+            if (!error_pending) {
+                auto eq_result = get_and_pop_stack_top();
+                call_slot(a.get(), &model::TypeSlots::gt, model::magic_name::gt, b.get());
+                if (!error_pending) {
+                    auto gt_result = get_and_pop_stack_top();
+
+                    // 压入最终结果
+                    if (is_true(gt_result.get()) or is_true(eq_result.get())) {
+                        push_borrowed_to_stack(model::load_true());
+                    } else {
+                        push_borrowed_to_stack(model::load_false());
+                    }
+                }
+            }
         }
-        break;
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(OP_GE);
 
-    case Opcode::OP_LE: {
+    VM_CASE(OP_LE) {
         auto b = get_and_pop_stack_top();
         auto a = get_and_pop_stack_top();
-
-        // 调用__eq__方法
-        call_method(a.get(), "__eq__", {b.get()});
-
-        // 调用__lt__方法
-        call_method(a.get(), "__lt__", {b.get()});
-
-        // 获取结果
-        auto lt_result = get_and_pop_stack_top();
-        auto eq_result = get_and_pop_stack_top();
-
-        // 压入最终结果
-        if (is_true(lt_result.get()) or is_true(eq_result.get())) {
-            push_to_stack(model::load_true());
+        if (auto result = fast_compare(Opcode::OP_LE, a.get(), b.get())) {
+            push_borrowed_to_stack(model::load_bool(*result));
         } else {
-            push_to_stack(model::load_false());
+            // 调用__eq__方法
+            call_slot(a.get(), &model::TypeSlots::eq, model::magic_name::eq, b.get());
+            if (!error_pending) {
+                auto eq_result = get_and_pop_stack_top();
+
+                // 调用__lt__方法
+                call_slot(a.get(), &model::TypeSlots::lt, model::magic_name::lt, b.get());
+                if (!error_pending) {
+                    auto lt_result = get_and_pop_stack_top();
+
+                    // 压入最终结果
+                    if (is_true(lt_result.get()) or is_true(eq_result.get())) {
+                        push_borrowed_to_stack(model::load_true());
+                    } else {
+                        push_borrowed_to_stack(model::load_false());
+                    }
+                }
+            }
         }
-        break;
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(OP_LE);
 
-    case Opcode::OP_NE: {
+    VM_CASE(OP_NE) {
         auto b = get_and_pop_stack_top();
         auto a = get_and_pop_stack_top();
-
-
-        // 调用__eq__方法
-        call_method(a.get(), "__eq__", {b.get()});
-
-        // 获取比较结果
-        auto eq_result = get_and_pop_stack_top();
-
-        // 压入取反结果
-        push_to_stack(model::load_bool(
-            ! is_true(eq_result.get())
-        ));
-        break;
+        if (auto result = fast_compare(Opcode::OP_NE, a.get(), b.get())) {
+            push_borrowed_to_stack(model::load_bool(*result));
+        } else {
+            // 调用__eq__方法
+            call_slot(a.get(), &model::TypeSlots::eq, model::magic_name::eq, b.get());
+            if (!error_pending) {
+                // 获取比较结果
+                auto eq_result = get_and_pop_stack_top();
+
+                // 压入取反结果
+                push_borrowed_to_stack(model::load_bool(
+                    ! is_true(eq_result.get())
+                ));
+            }
+        }
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(OP_NE);
 
-    case Opcode::OP_NOT: {
+    VM_CASE(OP_NOT) {
         auto a = get_and_pop_stack_top();
         bool result = !is_true(a.get());
-        push_to_stack(model::load_bool(result));
-        break;
+        push_borrowed_to_stack(model::load_bool(result));
     }
+    VM_NEXT(OP_NOT);
 
-    case Opcode::OP_IS: {
+    VM_CASE(OP_IS) {
         auto b = get_and_pop_stack_top();
         auto a = get_and_pop_stack_top();
-        push_to_stack(model::load_bool(a.get() == b.get()));
-        break;
+        push_borrowed_to_stack(model::load_bool(a.get() == b.get()));
     }
+    VM_NEXT(OP_IS);
 
-    case Opcode::OP_IN: {
+    VM_CASE(OP_IN) {
         auto for_check = get_and_pop_stack_top();
         auto item = get_and_pop_stack_top();
 
         // 调用contains方法，参数为item
-        call_method(for_check.get(), "contains", {item.get()});
-        break;
+        model::Object* argv[] = {item.get()};
+        call_method(for_check.get(), model::magic_name::contains, argv);
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(OP_IN);
 
-    case Opcode::MAKE_LIST: {
+    VM_CASE(MAKE_LIST) {
         make_list(instruction.opn_list[0]);
-        break;
     }
+    VM_NEXT(MAKE_LIST);
 
-    case Opcode::MAKE_DICT: {
+    VM_CASE(MAKE_DICT) {
         make_dict(instruction.opn_list[0]);
-        break;
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(MAKE_DICT);
 
-    case Opcode::CREATE_CLOSURE: {
-        auto func_obj = dynamic_cast<model::Function*>(op_stack.back());
+    VM_CASE(CREATE_CLOSURE) {
+        // 栈顶是常量池中的函数原型; 捕获自由变量时为本次求值创建独立的函数对象,
+        // 否则各次求值共享同一个常量, 上一次捕获的变量既无法释放也无法被循环回收器回收
+        auto proto_fn = op_stack.back()->as<model::Function>();
 
-        auto& upvalues = func_obj->code->upvalues;
-        std::vector<model::Object*> free_vars {};
+        auto& upvalues = proto_fn->code->upvalues;
+        if (!upvalues.empty()) {
+            auto func_obj = new model::Function(proto_fn->name, proto_fn->code, proto_fn->argc);
+            func_obj->has_rest_params = proto_fn->has_rest_params;
+            func_obj->free_vars.reserve(upvalues.size());
 
-        for (const auto& [distance_from_curr, idx] : upvalues) {
-            auto frame = call_stack[ call_stack.size() - distance_from_curr];
-            size_t loc_based = frame->bp;
+            for (const auto& [distance_from_curr, idx] : upvalues) {
+                const auto& frame = call_stack[ call_stack.size() - distance_from_curr];
+                size_t loc_based = frame.bp;
 
-            auto var = op_stack[loc_based + idx];
-            var->make_ref();
-            free_vars.push_back( var );
-        }
+                // 函数语句先把原型绑定到函数名再创建闭包, 引用自身名字的函数(如递归)捕获的是新的函数对象
+                auto var = op_stack[loc_based + idx];
+                if (var == proto_fn) var = func_obj;
+                var->make_ref();
+                func_obj->free_vars.push_back( var );
+            }
 
-        func_obj->free_vars = free_vars;
-        break;
+            func_obj->make_ref();
+            op_stack.back()->del_ref();
+            op_stack.back() = func_obj;
+        }
     }
+    VM_NEXT(CREATE_CLOSURE);
 
-
-    case Opcode::CALL: {
+    VM_CASE(CALL) {
+        VM_GC_SAFEPOINT();
         auto func_obj = get_and_pop_stack_top();
-        // 弹出栈顶-1元素 : 参数列表
-        auto args_obj = get_and_pop_stack_top();
-        handle_call(func_obj.get(), args_obj.get(), nullptr);
-        break;
+        // 其下的 opn_list[0] 个元素即实参
+        handle_call(func_obj.get(), instruction.opn_list[0], nullptr);
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(CALL);
 
-    case Opcode::RET: {
+    VM_CASE(RET) {
         // 执行ensure确保资源被释放
         handle_ensure();
 
-        auto frame = call_stack.back();
+        // 出栈只移动下标, 弹出的帧在下一次压栈前仍然有效
+        auto& frame = call_stack.back();
         call_stack.pop_back();
-        call_stack.back()->bp = frame->last_bp;
-        call_stack.back()->pc = frame->return_to_pc;
+        call_stack.back().bp = frame.last_bp;
+        call_stack.back().pc = frame.return_to_pc;
 
-        auto return_val = get_and_pop_stack_top();
-        assert(return_val.get());
+        // 返回值连同栈对它的引用一起移交给调用者
+        const auto return_val = simple_get_and_pop_stack_top();
 
-        while (frame->bp < op_stack.size()) {
-            op_stack.back()->del_ref();
+        while (frame.bp < op_stack.size()) {
+            if (op_stack.back()) op_stack.back()->del_ref();
             op_stack.pop_back();
         }
 
-        push_to_stack(return_val.get());
+        push_owned_to_stack(return_val);
 
-        frame->owner->del_ref();
-        frame->code_object->del_ref();
-        for (auto it: frame->iters) {
-            if (it) it->del_ref();
-        }
+        release_frame(frame);
 
-        delete frame;
-        break;
+        // 回到了调用者所在的调度层
+        if (call_stack.size() <= stop_depth) return;
     }
+    VM_NEXT(RET);
 
-    case Opcode::CALL_METHOD: {
+    VM_CASE(CALL_METHOD) {
         auto obj = get_and_pop_stack_top();
 
-        // 弹出栈顶-1元素 : 参数列表
-        auto args_obj = get_and_pop_stack_top();
-
-        std::string attr_name = get_attr_name_by_idx(instruction.opn_list[0]);
+        // 其下的 argc 个元素即实参
+        const size_t argc = instruction.opn_list[1] & CALL_METHOD_MAX_ARGC;
+        const size_t cache_idx = instruction.opn_list[1] >> CALL_METHOD_ARGC_BITS;
 
-        auto func_obj = get_attr(obj.get(), attr_name);
+        auto func_obj = get_attr_cached(obj.get(), instruction.opn_list[0],
+            curr_frame->code_object->attr_caches[cache_idx]);
 
-        func_obj->make_ref();
-        handle_call(func_obj, args_obj.get(), obj.get());
-        break;
+        // 查找失败时留下待处理错误, 在作用域结束后统一转发
+        if (func_obj) {
+            func_obj->make_ref();
+            handle_call(func_obj, argc, obj.get());
+        }
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(CALL_METHOD);
 
-    case Opcode::GET_ATTR: {
+    VM_CASE(GET_ATTR) {
         auto obj = get_and_pop_stack_top();
-         std::string attr_name = get_attr_name_by_idx(instruction.opn_list[0]);
 
-        model::Object* attr_val = get_attr(obj.get(), attr_name);
-        push_to_stack(attr_val);
-        break;
+        model::Object* attr_val = get_attr_cached(obj.get(), instruction.opn_list[0],
+            curr_frame->code_object->attr_caches[instruction.opn_list[1]]);
+        if (attr_val) push_to_stack(attr_val);
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(GET_ATTR);
 
-    case Opcode::SET_ATTR: {
+    VM_CASE(SET_ATTR) {
         auto attr_val = get_and_pop_stack_top();
         auto obj = get_and_pop_stack_top();
-        std::string attr_name = get_attr_name_by_idx(instruction.opn_list[0]);
 
         if (std::ranges::find(builtins, obj.get()) != std::ranges::end(builtins)) {
-            throw NativeFuncError("SetattrError", "Cannot reset or add attribute for builtin object");
+            raise("SetattrError", "Cannot reset or add attribute for builtin object");
+        } else {
+            auto new_val = model::copy_if_mutable(attr_val.get());
+            set_attr_cached(obj.get(), instruction.opn_list[0], new_val,
+                curr_frame->code_object->attr_caches[instruction.opn_list[1]]);
         }
-
-        auto new_val = model::copy_if_mutable(attr_val.get());
-        auto old_it = obj.get()->attrs.find(attr_name);   // 获取旧值（若有）
-        obj.get()->attrs_insert(attr_name, new_val);      // 插入新值，内部 make_ref
-
-        if (old_it) old_it->value->del_ref();       // 释放旧值
-        break;
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(SET_ATTR);
 
-    case Opcode::GET_ITEM: {
+    VM_CASE(GET_ITEM) {
         auto obj = get_and_pop_stack_top();
-        auto args_list = get_and_pop_stack_top();
 
-        call_method(obj.get(), "__getitem__", model::cast_to_list(
-            args_list.get()
-        ) -> val);
-        break;
+        // 其下的 opn_list[0] 个元素即下标
+        const StackArgs args(instruction.opn_list[0]);
+        if (args.size() == 1) {
+            call_slot(obj.get(), &model::TypeSlots::getitem, model::magic_name::getitem, args.data()[0]);
+        } else {
+            call_method(obj.get(), model::magic_name::getitem, model::Args(args.data(), args.size()));
+        }
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(GET_ITEM);
 
-    case Opcode::SET_ITEM: {
+    VM_CASE(SET_ITEM) {
         auto value = get_and_pop_stack_top();
         auto arg = get_and_pop_stack_top();
         auto obj = get_and_pop_stack_top();
 
         // 获取对象自身的 __setitem__
-        call_method(obj.get(), "__setitem__", {arg.get(), value.get()});
-        break;
+        call_slot(obj.get(), &model::TypeSlots::setitem, model::magic_name::setitem, arg.get(), value.get());
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(SET_ITEM);
 
-    case Opcode::LOAD_VAR: {
-        auto val = op_stack[call_stack.back()->bp + instruction.opn_list[0]];
+    VM_CASE(LOAD_VAR) {
+        auto val = op_stack[call_stack.back().bp + instruction.opn_list[0]];
         push_to_stack(val);
-        break;
     }
+    VM_NEXT(LOAD_VAR);
 
-    case Opcode::LOAD_CONST: {
+    VM_CASE(LOAD_CONST) {
         size_t const_idx = instruction.opn_list[0];
         model::Object* const_val = const_pool[const_idx];
-        push_to_stack(const_val);
-        break;
+        push_borrowed_to_stack(const_val);
     }
+    VM_NEXT(LOAD_CONST);
 
-    case Opcode::LOAD_BUILTINS: {
+    VM_CASE(LOAD_BUILTINS) {
         auto obj = builtins[ instruction.opn_list[0] ];
-        push_to_stack(obj);
-        break;
+        push_borrowed_to_stack(obj);
     }
+    VM_NEXT(LOAD_BUILTINS);
 
-    case Opcode::LOAD_FREE_VAR: {
-        auto func = dynamic_cast<model::Function*>(call_stack.back()->owner);
+    VM_CASE(LOAD_FREE_VAR) {
+        auto func = call_stack.back().owner->as<model::Function>();
         assert(func != nullptr);
         push_to_stack(func->free_vars[ instruction.opn_list[0] ]);
-        break;
     }
+    VM_NEXT(LOAD_FREE_VAR);
 
-    case Opcode::SET_LOCAL: {
-        auto value = get_and_pop_stack_top();
-
-        size_t offset = call_stack.back()->bp + instruction.opn_list[0];
-        auto new_val = model::copy_if_mutable(value.get());
-        new_val->make_ref();
+    VM_CASE(SET_LOCAL) {
+        size_t offset = call_stack.back().bp + instruction.opn_list[0];
+        auto new_val = take_stack_top_for_store();
 
         if (op_stack[offset]) {
             op_stack[offset]->del_ref();
         }
         op_stack[offset] = new_val;
-        break;
     }
+    VM_NEXT(SET_LOCAL);
 
-
-    case Opcode::SET_GLOBAL: {
+    VM_CASE(SET_GLOBAL) {
         auto offset = instruction.opn_list[0];
-        auto value = get_and_pop_stack_top();
-
-        auto new_val = model::copy_if_mutable(value.get());
-        new_val->make_ref();
+        auto new_val = take_stack_top_for_store();
         if (op_stack[offset]) {
             op_stack[offset]->del_ref();
         }
 
         op_stack[offset] = new_val;
-        break;
     }
+    VM_NEXT(SET_GLOBAL);
 
-    case Opcode::SET_NONLOCAL: {
+    VM_CASE(SET_NONLOCAL) {
         auto idx_of_upvalue = instruction.opn_list[0];
-        auto upvalue = call_stack.back()->code_object->upvalues[ idx_of_upvalue ];
-        auto frame = call_stack[ call_stack.size() - upvalue.distance_from_curr - 1]; // 区别于CREATE_CLOSURE指令, 这里在函数中要多减一
-        size_t loc_based = frame->bp;
+        auto upvalue = call_stack.back().code_object->upvalues[ idx_of_upvalue ];
+        const auto& frame = call_stack[ call_stack.size() - upvalue.distance_from_curr - 1]; // 区别于CREATE_CLOSURE指令, 这里在函数中要多减一
+        size_t loc_based = frame.bp;
 
-        auto value = get_and_pop_stack_top();
-
-        auto new_val = model::copy_if_mutable(value.get());
-        new_val->make_ref();
+        auto new_val = take_stack_top_for_store();
 
         if (op_stack[loc_based + upvalue.idx]) {
             op_stack[loc_based + upvalue.idx]->del_ref();
@@ -363,116 +681,167 @@ void Vm::execute_unit(const Instruction& instruction) {
         op_stack[loc_based + upvalue.idx] = new_val;
 
         // 更新闭包
-        if (auto f = dynamic_cast<model::Function*>(call_stack.back()->owner)) {
-            f->free_vars[idx_of_upvalue] = new_val;
+        if (auto f = call_stack.back().owner->as<model::Function>()) {
+            auto& free_var = f->free_vars[idx_of_upvalue];
+            new_val->make_ref();
+            if (free_var) free_var->del_ref();
+            free_var = new_val;
         }
-        break;
     }
+    VM_NEXT(SET_NONLOCAL);
 
-
-    case Opcode::THROW: {
+    VM_CASE(THROW) {
         auto top = get_and_pop_stack_top();
-        if (call_stack.back()->curr_error) call_stack.back()->curr_error->del_ref();
-        call_stack.back()->curr_error = top.get();
+        if (call_stack.back().curr_error) call_stack.back().curr_error->del_ref();
+        call_stack.back().curr_error = top.get();
         top.get()->make_ref();     // 使 curr_error 持有引用
         handle_throw();
-        break;
+
+        // 异常被更外层的调度循环捕获
+        if (call_stack.size() <= stop_depth) return;
     }
+    VM_NEXT(THROW);
 
-    case Opcode::LOAD_ERROR: {
-        if (!call_stack.back()->curr_error) {
+    VM_CASE(LOAD_ERROR) {
+        if (!call_stack.back().curr_error) {
             throw KizStopRunningSignal("Unable to load error");
         }
-        call_stack.back()->curr_error->make_ref();
-        push_to_stack(call_stack.back()->curr_error);
-        break;
+        call_stack.back().curr_error->make_ref();
+        push_to_stack(call_stack.back().curr_error);
     }
+    VM_NEXT(LOAD_ERROR);
 
-    case Opcode::JUMP: {
+    VM_CASE(JUMP) {
+        VM_GC_SAFEPOINT();
         size_t target_pc = instruction.opn_list[0];
-        call_stack.back()->pc = target_pc;
-        break;
+        call_stack.back().pc = target_pc;
     }
+    VM_NEXT(JUMP);
 
-    case Opcode::JUMP_IF_FALSE: {
+    VM_CASE(JUMP_IF_FALSE) {
         auto cond = get_and_pop_stack_top();
         if (! is_true(cond.get())) {
             // 跳转逻辑
-            call_stack.back()->pc = instruction.opn_list[0];
+            call_stack.back().pc = instruction.opn_list[0];
         } else {
-            call_stack.back()->pc++;
+            call_stack.back().pc++;
         }
-        break;
     }
+    VM_NEXT(JUMP_IF_FALSE);
 
-    case Opcode::IS_CHILD: {
+    VM_CASE(IS_CHILD) {
         auto b = get_and_pop_stack_top();
         auto a = get_and_pop_stack_top();
         push_to_stack(builtin::check_based_object(a.get(), b.get()));
-        break;
     }
+    VM_NEXT(IS_CHILD);
 
-    case Opcode::CREATE_OBJECT: {
+    VM_CASE(CREATE_OBJECT) {
         auto obj = new model::Object();
-        obj->attrs_insert("__parent__", model::based_obj);
+        obj->set_parent(model::based_obj);
+        Gc::track(obj);
         push_to_stack(obj);
-        break;
     }
+    VM_NEXT(CREATE_OBJECT);
 
-    case Opcode::IMPORT: {
-        std::string module_path = get_attr_name_by_idx(instruction.opn_list[0]);
+    VM_CASE(IMPORT) {
+        std::string module_path = get_attr_name_by_idx(instruction.opn_list[0]).str();
         handle_import(module_path);
-        break;
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(IMPORT);
+
+    VM_CASE(CACHE_ITER) {
+        // 可迭代对象提供 __iter__ 时缓存其返回的迭代器, 否则对象自身即迭代器(直接实现 __next__)
+        auto iterable = op_stack.back();
+        model::Object* iter = iterable;
+        if (iterable->get_type() != ObjectType::Iterator) {
+            if (const auto iter_method = try_get_attr(iterable, model::magic_name::iter)) {
+                call_function(iter_method, {}, iterable);
+                iter = simple_get_and_pop_stack_top(); // 接管返回值的引用
+            }
+        }
+        if (iter == iterable) iter->make_ref();
 
-    case Opcode::CACHE_ITER: {
-        auto iter = op_stack.back();
-        iter->make_ref();
-
-        call_stack.back()->iters.push_back(iter);
-        break;
+        assert(curr_frame->iter_top < curr_frame->iter_base + curr_frame->code_object->max_iters);
+        iter_slots[curr_frame->iter_top++] = iter;
     }
+    VM_NEXT(CACHE_ITER);
 
-    case Opcode::GET_ITER: {
-        push_to_stack(
-            call_stack.back()->iters.back()
-        );
-        break;
+    VM_CASE(GET_ITER) {
+        // 压入迭代器的下一个元素: 原生迭代器直接推进游标, 其余对象调用 __next__
+        auto iter = iter_slots[curr_frame->iter_top - 1];
+        if (iter->get_type() == ObjectType::Iterator) {
+            push_to_stack(static_cast<model::NativeIterator*>(iter)->next());
+        } else {
+            if (const auto next = get_attr(iter, model::magic_name::next_item)) handle_call(next, 0, iter);
+        }
     }
+    VM_CHECK_ERROR();
+    VM_NEXT(GET_ITER);
 
-    case Opcode::POP_ITER: {
-        auto iter_obj = call_stack.back()->iters.back();
-        iter_obj->del_ref();
-        call_stack.back()->iters.pop_back();
-        break;
-
+    VM_CASE(POP_ITER) {
+        unwind_iters(*curr_frame, curr_frame->iter_top - curr_frame->iter_base - 1);
     }
+    VM_NEXT(POP_ITER);
 
-    case Opcode::JUMP_IF_FINISH_ITER: {
+    VM_CASE(JUMP_IF_FINISH_ITER) {
         auto obj = get_and_pop_stack_top();
         size_t target_pc = instruction.opn_list[0];
         if (obj.get() == model::stop_iter_signal) {
-            call_stack.back()->pc = target_pc;
-            return;
+            call_stack.back().pc = target_pc;
+        } else {
+            call_stack.back().pc ++;
         }
-        call_stack.back()->pc ++;
-        break;
     }
+    VM_NEXT(JUMP_IF_FINISH_ITER);
+
+    VM_CASE(FOR_RANGE) {
+        // 计数循环: Range迭代器直接推进int64游标并写入循环变量, 其余迭代器执行其后的通用取值指令
+        const auto iter = iter_slots[curr_frame->iter_top - 1]->as<model::NativeIterator>();
+        if (!iter or iter->kind != model::NativeIterator::IterKind::Range) {
+            curr_frame->pc++;
+            VM_DISPATCH();
+        }
+
+        int64_t i;
+        if (!static_cast<model::RangeIterator*>(iter)->advance(i)) {
+            curr_frame->pc = instruction.opn_list[1];
+            VM_DISPATCH();
+        }
 
-    case Opcode::COPY_TOP: {
+        auto& slot = op_stack[curr_frame->bp + instruction.opn_list[0]];
+        if (slot and slot->get_type() == ObjectType::Int and slot->get_refc_() == 1 and !slot->has_own_attrs()) {
+            // 上一轮的循环变量只被本槽位持有(未被保存到别处), 原地改写即可, 无需重新装箱
+            static_cast<model::Int*>(slot)->val = dep::BigInt(i);
+        } else {
+            auto new_val = model::load_int(i);
+            new_val->make_ref();
+            if (slot) slot->del_ref();
+            slot = new_val;
+        }
+        curr_frame->pc += FOR_RANGE_GENERIC_LEN + 1;
+    }
+    VM_NEXT(FOR_RANGE);
+
+    VM_CASE(COPY_TOP) {
         auto obj = get_and_pop_stack_top();
         push_to_stack(obj.get());
         push_to_stack(obj.get());
-        break;
     }
+    VM_NEXT(COPY_TOP);
 
-    case Opcode::STOP: {
+    VM_CASE(STOP) {
         running = false;
-        break;
+        return;
     }
+    VM_NEXT(STOP);
 
+#ifndef KIZ_COMPUTED_GOTO
     default: throw NativeFuncError("FutureError", "execute_instruction meet unknown opcode");
     }
-
+    }
+#endif
 }
+
 }
@@ -3,64 +3,137 @@
 #include "vm.hpp"
 #include "../models/models.hpp"
 #include "opcode/opcode.hpp"
-#include <unordered_set>
 
 namespace kiz {
 
 bool Vm::is_true(model::Object* obj) {
-    if (const auto bool_obj = dynamic_cast<const model::Bool*>(obj)) {
+    if (const auto bool_obj = obj->as<model::Bool>()) {
         return bool_obj->val==true;
     }
-    if (dynamic_cast<const model::Nil*>(obj)) {
+    if (obj->is<model::Nil>()) {
         return false;
     }
 
-    call_method(obj, "__bool__", {});
+    call_slot(obj, &model::TypeSlots::bool_of, model::magic_name::bool_of);
     auto result = simple_get_and_pop_stack_top();
     bool ret = is_true(result);
 
     return ret;
 }
 
-model::Object* Vm::get_attr(model::Object* obj, const std::string& attr_name) {
+model::Object* Vm::try_get_attr(model::Object* obj, const dep::Symbol attr_name) {
     assert(obj != nullptr);
-    const auto attr_it = obj->attrs.find(attr_name);
-    auto parent_it = obj->attrs.find("__parent__");
-    if (attr_it) {
-        return attr_it->value;
+    while (obj) {
+        if (const auto attr = obj->find_attr(attr_name)) {
+            return attr;
+        }
+        obj = obj->get_parent();
     }
+    return nullptr;
+}
 
-    if (parent_it) {
-        return get_attr(parent_it->value, attr_name);
+model::Object* Vm::get_attr(model::Object* obj, const dep::Symbol attr_name) {
+    if (const auto attr = try_get_attr(obj, attr_name)) {
+        return attr;
     }
 
-    throw NativeFuncError("NameError",
-        "Undefined attribute '" + attr_name + "'"
+    return raise("NameError",
+        "Undefined attribute '" + attr_name.str() + "'"
     );
 }
 
-model::Object* Vm::get_attr_current(model::Object* obj, const std::string& attr) {
-    const auto attr_it = obj->attrs.find(attr);
-    if (attr_it) {
-        return attr_it->value;
+model::Object* Vm::get_attr_current(model::Object* obj, const dep::Symbol attr) {
+    if (const auto attr_val = obj->find_attr(attr)) {
+        return attr_val;
     }
-    throw NativeFuncError("NameError",
-        "Undefined attribute '" + attr + "'" + " of current attributes table"
+    return raise("NameError",
+        "Undefined attribute '" + attr.str() + "'" + " of current attributes table"
     );
 }
 
-void Vm::handle_call(model::Object* func_obj, model::Object* args_obj, model::Object* self){
-    assert(func_obj != nullptr);
-    assert(args_obj != nullptr);
-    auto args_list = dynamic_cast<model::List*>(args_obj);
+model::Object* Vm::get_attr_cached(model::Object* obj, const uint32_t name_idx, model::AttrCache& cache) {
+    dep::Shape* shape = obj->get_shape();
+    model::Object* parent = obj->get_parent();
+
+    // 命中: Shape 与原型相同且原型纪元未变, 无需任何哈希
+    if (shape) {
+        for (const auto& e : cache.entries) {
+            if (e.shape == shape and e.parent == parent and e.epoch == proto_epoch) {
+                return e.slot == model::AttrCacheEntry::NOT_OWN ? e.value : obj->attr_table()->slot_at(e.slot);
+            }
+        }
+    }
+
+    const dep::Symbol attr_name = get_frame()->code_object->attr_names[name_idx];
+    // 字典模式的对象与 __parent__ 不走缓存
+    if (!shape or attr_name == model::magic_name::parent) {
+        if (const auto attr = try_get_attr(obj, attr_name)) return attr;
+        return raise("NameError", "Undefined attribute '" + attr_name.str() + "'");
+    }
+
+    const uint32_t slot = shape->slot_of(attr_name);
+    model::Object* value = nullptr;
+    if (slot != dep::Shape::NOT_FOUND) {
+        value = obj->attr_table()->slot_at(slot);
+    } else if (parent) {
+        value = try_get_attr(parent, attr_name);
+    }
+    if (!value) {
+        return raise("NameError", "Undefined attribute '" + attr_name.str() + "'");
+    }
+
+    auto& e = cache.victim();
+    e.shape = shape;
+    e.parent = parent;
+    e.epoch = proto_epoch;
+    e.slot = slot == dep::Shape::NOT_FOUND ? model::AttrCacheEntry::NOT_OWN : slot;
+    e.value = slot == dep::Shape::NOT_FOUND ? value : nullptr;
+    e.next_shape = nullptr;
+    return value;
+}
+
+void Vm::set_attr_cached(model::Object* obj, const uint32_t name_idx, model::Object* val, model::AttrCache& cache) {
+    // 写入原型需要递增原型纪元, 走通用路径
+    dep::Shape* shape = obj->is_proto() ? nullptr : obj->get_shape();
+    if (shape) {
+        for (const auto& e : cache.entries) {
+            if (e.shape == shape) {
+                obj->store_slot(e.slot, e.next_shape, val);
+                return;
+            }
+        }
+    }
 
-    assert(args_list && "CALL: 栈顶-1元素非List类型（参数必须封装为列表）");
+    const dep::Symbol attr_name = get_frame()->code_object->attr_names[name_idx];
+    obj->set_attr(attr_name, val); // 持有新值并释放旧值
+    if (!shape or attr_name == model::magic_name::parent) return;
+
+    dep::Shape* new_shape = obj->get_shape();
+    if (!new_shape) return; // 已退化为字典模式
+
+    auto& e = cache.victim();
+    e.shape = shape;
+    e.parent = nullptr;
+    e.epoch = 0;
+    e.slot = new_shape->slot_of(attr_name);
+    e.value = nullptr;
+    e.next_shape = new_shape == shape ? nullptr : new_shape;
+}
+
+void Vm::handle_call(model::Object* func_obj, const size_t argc, model::Object* self){
+    assert(func_obj != nullptr);
+    assert(op_stack.size() >= argc);
     DEBUG_OUTPUT("start to call function");
 
     // 分类型处理函数调用（Function / NativeFunction）
-    if (const auto cpp_func = dynamic_cast<model::NativeFunction*>(func_obj)) {
+    if (const auto cpp_func = func_obj->as<model::NativeFunction>()) {
         // -------------------------- 处理 NativeFunction 调用 --------------------------
-        model::Object* return_val = cpp_func->func(self, args_list);
+        // 实参先移出操作数栈: 原生函数可能回调kiz代码, 操作数栈扩容会使指向栈内的视图失效
+        const StackArgs args(argc);
+        model::Object* return_val = cpp_func->call(self, model::Args(args.data(), args.size()));
+
+        // 原生函数以待处理错误结束: 不压入返回值, 由调用方转发错误
+        if (error_pending) return;
 
         // 管理返回值引用计数：返回值压栈前必须 make_ref
         if (!return_val){
@@ -68,194 +141,241 @@ void Vm::handle_call(model::Object* func_obj, model::Object* args_obj, model::Ob
             return_val = model::unique_nil;
         }
 
-        // 返回值压入操作数栈
+        // 返回值压入操作数栈 (须在实参释放之前, 返回值可能就是某个实参)
         push_to_stack(return_val);
-    } else if (auto func = dynamic_cast<model::Function*>(func_obj)) {
+    } else if (auto func = func_obj->as<model::Function>()) {
         // -------------------------- 处理 Function 调用 --------------------------
         DEBUG_OUTPUT("call Function: " + func->name);
 
-        // 校验参数数量
+        // 校验参数数量 (剩余参数可以为空)
+        const bool pass_self = self and self->get_type() != model::Object::ObjectType::Module;
         const size_t required_argc = func->argc;
-        size_t actual_argc;
-        if (self and self->get_type() != model::Object::ObjectType::Module) {
-            actual_argc = args_list->val.size() + 1;
-        } else {
-            actual_argc = args_list->val.size();
-        }
-        if (actual_argc != required_argc and !func->has_rest_params)
-            throw NativeFuncError("ArgCountError", std::format(
+        const size_t actual_argc = pass_self ? argc + 1 : argc;
+        if (func->has_rest_params ? actual_argc + 1 < required_argc : actual_argc != required_argc) {
+            StackArgs discarded(argc);
+            raise("ArgCountError", std::format(
                 "expect {} arguments but got {} arguments", required_argc, actual_argc
             ));
+            return;
+        }
+        // 先于 push_frame 检查深度, 使脚本函数的递归错误也走待处理错误
+        if (call_stack.full()) {
+            StackArgs discarded(argc);
+            raise("RecursionError", std::format(
+                "maximum recursion depth {} exceeded", FrameStack::MAX_DEPTH
+            ));
+            return;
+        }
 
-        // 创建新调用帧
-        func->make_ref();
-        func->code->make_ref();
-        auto new_frame = new CallFrame{
-            .name = func->name,
-
-            .owner = func,
-
-            .pc = 0,
-            .return_to_pc = call_stack.back()->pc + 1,
-            .last_bp = call_stack.back()->bp,
-            .bp = op_stack.size(),
-            .code_object = func->code,
-
-            .iters{},
-
-            .curr_error = nullptr,
-            .exec_ensure_stmt = false
-        };
-        op_stack.resize(op_stack.size() + func->code->locals_count);
-
-        // 储存self
-        if (self and self->get_type() != model::Object::ObjectType::Module) {
+        // 实参已按顺序位于栈顶, 原地成为新栈帧的前几个局部变量, self 插在实参之前
+        if (pass_self) {
             self->make_ref();
-            args_list->val.emplace(args_list->val.begin(), self);
+            op_stack.insert(op_stack.end() - static_cast<std::ptrdiff_t>(argc), self);
         }
+        const size_t bp = op_stack.size() - actual_argc;
 
         if (func->has_rest_params) {
-            for (size_t i = 0; i < required_argc; ++i) {
-                std::string param_name = new_frame->code_object->var_names[i];
-                model::Object* param_val;
-                if (i == required_argc - 1 ) {
-                    args_list->val.assign(args_list->val.begin() + i, args_list->val.end());
-                    param_val = args_list;
-                }
-                else {
-                    param_val = args_list->val[i];  // 从列表取参数
-                }
-
-                assert(param_val);
-                param_val->make_ref();
-                op_stack[new_frame->bp + i] = param_val;
+            // 剩余参数收集为列表: 去掉已绑定到前面形参的元素
+            const auto rest_begin = op_stack.begin() + static_cast<std::ptrdiff_t>(bp + required_argc - 1);
+            const auto rest_list = new model::List(std::vector<model::Object*>(rest_begin, op_stack.end()));
+            for (auto it = rest_begin; it != op_stack.end(); ++it) {
+                (*it)->del_ref();
             }
-
-            call_stack.emplace_back(new_frame);
-            return;
-        }
-
-        // 从参数列表中提取参数，存入locals
-        for (size_t i = 0; i < required_argc; ++i) {
-            std::string param_name = new_frame->code_object->var_names[i];
-            model::Object* param_val = args_list->val[i];  // 从列表取参数
-
-            // 校验参数非空
-            assert(param_val != nullptr);
-
-            // 增加参数引用计数（存入locals需持有引用）
-            param_val->make_ref();
-            op_stack[new_frame->bp + i] = param_val;
+            op_stack.erase(rest_begin, op_stack.end());
+            push_to_stack(rest_list);
         }
 
-        // 压入新调用帧，更新程序计数器
-        call_stack.emplace_back(new_frame);
+        // 压入新调用帧 (同时为局部变量预留栈空间)
+        push_frame(func, func->code, bp, call_stack.back().pc + 1);
 
     // 处理对象魔术方法__call__
     } else {
-        model::Object* callable;
-        try {
-            callable = get_attr(func_obj, "__call__");
-        } catch (NativeFuncError& e) {
-            throw NativeFuncError("TypeError", "try to call an uncallable object");
+        const auto callable = try_get_attr(func_obj, model::magic_name::call);
+        if (!callable) {
+            StackArgs discarded(argc);
+            raise("TypeError", "try to call an uncallable object");
+            return;
         }
-        assert(callable);
-        handle_call(callable, args_obj, func_obj);
+        handle_call(callable, argc, func_obj);
     }
 }
 
-void Vm::call_function(model::Object* func_obj, std::vector<model::Object*> args, model::Object* self) {
+void Vm::call_function(model::Object* func_obj, const model::Args args, model::Object* self) {
     size_t old_call_stack_size = call_stack.size();
 
-    auto temp_args = new model::List(std::move(args));
-    temp_args->make_ref();
-    handle_call(func_obj, temp_args, self);
-    temp_args->del_ref();
+    for (const auto arg : args) {
+        assert(arg != nullptr);
+        arg->make_ref();
+        op_stack.push_back(arg);
+    }
+    handle_call(func_obj, args.size(), self);
 
+    // 调用者是原生函数, 仍以异常方式传播错误
+    if (error_pending) throw_pending_error();
     if (old_call_stack_size == call_stack.size()) return;
 
-    while (running and !call_stack.empty() and call_stack.size() > old_call_stack_size) {
-        auto curr_frame = call_stack.back();
-        auto& frame_code = curr_frame->code_object;
+    // 调用者仍停留在当前指令上, RET后回到原pc, 由外层调度循环推进
+    call_stack.back().return_to_pc = call_stack[old_call_stack_size - 1].pc;
+    execute_until(old_call_stack_size);
+}
 
-        // 检查是否执行到模块代码末尾：执行完毕则出栈
-        if (curr_frame->pc >= frame_code->code.size()) {
-            call_stack.pop_back();
-            continue;
-        }
+namespace {
 
-        // 执行当前指令
-        const Instruction& curr_inst = frame_code->code[curr_frame->pc];
-        try {
-            if (curr_inst.opc == Opcode::RET and old_call_stack_size == call_stack.size() - 1) {
-                assert(!call_stack.empty());
-                call_stack.pop_back();
-                return;
+// 槽位函数返回空时与 NativeFunction 一致, 压入 Nil; 以待处理错误结束时不压栈
+void push_slot_result(model::Object* result) {
+    if (Vm::error_pending) return;
+    Vm::push_to_stack(result ? result : model::unique_nil);
+}
+
+// call_method 中魔术方法名 → 槽位
+const std::pair<dep::Symbol, model::UnarySlot> unary_slots[] = {
+    {model::magic_name::neg, &model::TypeSlots::neg},
+    {model::magic_name::hash, &model::TypeSlots::hash},
+    {model::magic_name::str, &model::TypeSlots::str},
+    {model::magic_name::bool_of, &model::TypeSlots::bool_of},
+    {model::magic_name::next_item, &model::TypeSlots::next},
+};
+
+const std::pair<dep::Symbol, model::BinarySlot> binary_slots[] = {
+    {model::magic_name::add, &model::TypeSlots::add},
+    {model::magic_name::sub, &model::TypeSlots::sub},
+    {model::magic_name::mul, &model::TypeSlots::mul},
+    {model::magic_name::div, &model::TypeSlots::div},
+    {model::magic_name::mod, &model::TypeSlots::mod},
+    {model::magic_name::pow, &model::TypeSlots::pow},
+    {model::magic_name::eq, &model::TypeSlots::eq},
+    {model::magic_name::lt, &model::TypeSlots::lt},
+    {model::magic_name::gt, &model::TypeSlots::gt},
+    {model::magic_name::getitem, &model::TypeSlots::getitem},
+};
+
+// 按参数个数在槽位表中查找并调用, 成功返回true
+bool try_call_slot(model::Object* obj, const dep::Symbol name, const model::Args args) {
+    const auto slots = model::slots_of(obj);
+    if (!slots) return false;
+
+    if (args.empty()) {
+        for (const auto& [sym, slot] : unary_slots) {
+            if (sym == name and slots->*slot) {
+                push_slot_result((slots->*slot)(obj));
+                return true;
             }
-            execute_unit(curr_inst); // 调用VM的指令执行核心方法
-        } catch (const NativeFuncError& e) {
-            // 原生函数执行错误，抛出异常
-            forward_to_handle_throw(e.name, e.msg);
-            continue;
         }
+    } else if (args.size() == 1) {
+        for (const auto& [sym, slot] : binary_slots) {
+            if (sym == name and slots->*slot) {
+                push_slot_result((slots->*slot)(obj, args[0]));
+                return true;
+            }
+        }
+    } else if (args.size() == 2 and name == model::magic_name::setitem and slots->setitem) {
+        push_slot_result(slots->setitem(obj, args[0], args[1]));
+        return true;
+    }
+    return false;
+}
+
+// 魔术方法按 call_method 的规则查找: 先查类型槽位表, 再沿原型链查找
+bool has_magic_method(model::Object* obj, const model::UnarySlot slot, const dep::Symbol name) {
+    if (const auto slots = model::slots_of(obj); slot and slots and slots->*slot) return true;
+    const auto parent = obj->get_parent();
+    return parent and Vm::try_get_attr(parent, name);
+}
 
-        ADVANCE_PC
+} // namespace
 
+void Vm::call_slot(model::Object* obj, const model::UnarySlot slot, const dep::Symbol name) {
+    if (const auto slots = model::slots_of(obj); slots and slots->*slot) {
+        push_slot_result((slots->*slot)(obj));
+        return;
     }
+    call_method(obj, name, {});
 }
 
-void Vm::call_method(model::Object* obj, const std::string& attr_name, std::vector<model::Object*> args) {
+void Vm::call_slot(model::Object* obj, const model::BinarySlot slot, const dep::Symbol name, model::Object* arg) {
+    if (const auto slots = model::slots_of(obj); slots and slots->*slot) {
+        push_slot_result((slots->*slot)(obj, arg));
+        return;
+    }
+    model::Object* argv[] = {arg};
+    call_method(obj, name, argv);
+}
+
+void Vm::call_slot(model::Object* obj, const model::TernarySlot slot, const dep::Symbol name,
+    model::Object* a, model::Object* b) {
+    if (const auto slots = model::slots_of(obj); slots and slots->*slot) {
+        push_slot_result((slots->*slot)(obj, a, b));
+        return;
+    }
+    model::Object* argv[] = {a, b};
+    call_method(obj, name, argv);
+}
+
+void Vm::call_method(model::Object* obj, const dep::Symbol attr_name, const model::Args args) {
     assert(obj != nullptr);
-    auto parent_it = obj->attrs.find("__parent__");
-    static const std::unordered_set<std::string_view> magic_methods = {
-    std::string_view("__add__"), std::string_view("__sub__"),
-    std::string_view("__mul__"), std::string_view("__div__"),
-    std::string_view("__pow__"), std::string_view("__mod__"),
-    std::string_view("__neg__"), std::string_view("__eq__"),
-    std::string_view("__gt__"), std::string_view("__lt__"),
-    std::string_view("__str__"), std::string_view("__dstr__"),
-    std::string_view("__bool__"), std::string_view("__getitem__"),
-    std::string_view("__setitem__"), std::string_view("contains"),
-    std::string_view("__next__"), std::string_view("__hash__")
+    const auto parent = obj->get_parent();
+    static const dep::Symbol magic_methods[] = {
+        model::magic_name::add, model::magic_name::sub,
+        model::magic_name::mul, model::magic_name::div,
+        model::magic_name::pow, model::magic_name::mod,
+        model::magic_name::neg, model::magic_name::eq,
+        model::magic_name::gt, model::magic_name::lt,
+        model::magic_name::str, model::magic_name::debug_str,
+        model::magic_name::bool_of, model::magic_name::getitem,
+        model::magic_name::setitem, model::magic_name::contains,
+        model::magic_name::next_item, model::magic_name::hash
     };
 
-    const bool is_magic = magic_methods.contains(std::string_view(attr_name));
+    const bool is_magic = std::ranges::find(magic_methods, attr_name) != std::end(magic_methods);
     if (!is_magic) {
-        call_function(get_attr(obj, attr_name), args, obj);
+        if (const auto method = try_get_attr(obj, attr_name)) {
+            call_function(method, args, obj);
+        } else {
+            raise("NameError", "Undefined attribute '" + attr_name.str() + "'");
+        }
         return;
     }
 
-    if (parent_it) {
-        call_function(get_attr(parent_it->value, attr_name), args, obj);
+    if (try_call_slot(obj, attr_name, args)) return;
+
+    if (parent) {
+        if (const auto method = try_get_attr(parent, attr_name)) {
+            call_function(method, args, obj);
+        } else {
+            raise("NameError", "Undefined attribute '" + attr_name.str() + "'");
+        }
         return;
     }
-    throw NativeFuncError("NameError",
-        "Undefined method '" + attr_name + "'"
-    );
+    raise("NameError", "Undefined method '" + attr_name.str() + "'");
 }
 
+// 取出 __str__/__dstr__ 的返回值; 调用方需要的是 std::string, 与 call_function 一样以异常方式把错误交给外层原生函数
+std::string Vm::take_str_result() {
+    const auto res = get_and_pop_stack_top();
+    const auto str = model::cast_to_str(res.get());
+    if (!str) throw_pending_error();
+    return str->val;
+}
+
+// 先按 call_method 的查找规则确认方法存在, 缺少 __str__/__dstr__ 时直接改用另一个, 不经过异常
 std::string Vm::obj_to_str(model::Object* for_cast_obj) {
     DEBUG_OUTPUT("obj to str");
-    try {
-        call_method(for_cast_obj, "__str__", {});
-    } catch (NativeFuncError& e) {
-        call_method(for_cast_obj, "__dstr__", {});
+    if (has_magic_method(for_cast_obj, &model::TypeSlots::str, model::magic_name::str)) {
+        call_slot(for_cast_obj, &model::TypeSlots::str, model::magic_name::str);
+    } else {
+        call_method(for_cast_obj, model::magic_name::debug_str, {});
     }
-    auto res = simple_get_and_pop_stack_top();
-    std::string val = model::cast_to_str(res)->val;
-    return val;
+    return take_str_result();
 }
 
 
 std::string Vm::obj_to_debug_str(model::Object* for_cast_obj) {
     DEBUG_OUTPUT("obj to debug str");
-    try {
-        call_method(for_cast_obj, "__dstr__", {});
-    } catch (NativeFuncError& e) {
-        call_method(for_cast_obj, "__str__", {});
+    if (has_magic_method(for_cast_obj, nullptr, model::magic_name::debug_str)) {
+        call_method(for_cast_obj, model::magic_name::debug_str, {});
+    } else {
+        call_slot(for_cast_obj, &model::TypeSlots::str, model::magic_name::str);
     }
-    auto res = simple_get_and_pop_stack_top();
-    std::string val = model::cast_to_str(res) ->val;
-    return val;
+    return take_str_result();
 }
 }
@@ -13,33 +13,53 @@ void Vm::forward_to_handle_throw(const std::string& name, const std::string& con
     const auto err_msg = new model::String(content);
     const auto err_obj = new model::Error(make_pos_info());
 
-    err_obj->attrs_insert("__name__", err_name);
-    err_obj->attrs_insert("__msg__", err_msg);
+    err_obj->attrs_insert(model::magic_name::name, err_name);
+    err_obj->attrs_insert(model::magic_name::msg, err_msg);
 
     // 替换全局curr_error前，释放旧错误对象
-    if (call_stack.back()->curr_error) {
-        call_stack.back()->curr_error->del_ref();
+    if (call_stack.back().curr_error) {
+        call_stack.back().curr_error->del_ref();
     }
     err_obj->make_ref();
-    call_stack.back()->curr_error = err_obj;
+    call_stack.back().curr_error = err_obj;
     handle_throw();
 }
 
+model::Object* Vm::raise(std::string name, std::string msg) {
+    pending_error_name = std::move(name);
+    pending_error_msg = std::move(msg);
+    error_pending = true;
+    return nullptr;
+}
+
+void Vm::forward_pending_error() {
+    assert(error_pending);
+    error_pending = false;
+    forward_to_handle_throw(pending_error_name, pending_error_msg);
+}
+
+void Vm::throw_pending_error() {
+    assert(error_pending);
+    error_pending = false;
+    throw NativeFuncError(std::move(pending_error_name), std::move(pending_error_msg));
+}
+
 void Vm::handle_throw() {
-    assert(call_stack.back()->curr_error);
+    assert(call_stack.back().curr_error);
 
     // 提取错误对象的 __name__ 和 __msg__
-    auto err = call_stack.back()->curr_error;
+    auto err = call_stack.back().curr_error;
     err->make_ref();
-    auto err_name_it = err->attrs.find("__name__");
-    auto err_msg_it = err->attrs.find("__msg__");
+    // 先取出值再转换：转换可能执行用户代码并修改属性表
+    auto err_name_obj = err->find_attr(model::magic_name::name);
+    auto err_msg_obj = err->find_attr(model::magic_name::msg);
 
-    if (!err_name_it or !err_msg_it) {
+    if (!err_name_obj or !err_msg_obj) {
         throw KizStopRunningSignal(
             "Undefined attribute '__name__' '__msg__' of " + obj_to_debug_str(err) + " (when try to throw it)");
     }
-    auto error_name = obj_to_str(err_name_it->value);
-    auto error_msg = obj_to_str(err_msg_it->value);
+    auto error_name = obj_to_str(err_name_obj);
+    auto error_msg = obj_to_str(err_msg_obj);
 
     size_t frames_to_pop = 0; // 需要从栈顶弹出的帧数
 
@@ -47,24 +67,27 @@ void Vm::handle_throw() {
     handle_ensure();
 
     // 逆序遍历调用栈
-    for (auto frame : std::ranges::reverse_view(call_stack)) {
-        for (const auto& table : frame->code_object->exception_tables) {
+    for (auto& frame : std::ranges::reverse_view(call_stack)) {
+        for (const auto& table : frame.code_object->exception_tables) {
             // 检查当前 pc 是否在此 try 块的范围内
-            size_t current_pc = frame->pc;
+            size_t current_pc = frame.pc;
             if (table.try_part_start_pc <= current_pc and current_pc < table.try_part_end_pc) {
                 // 寻找匹配的 catch 块
                 if (auto catch_start_pc_it = table.handle_pc.find(error_name)) {
-                    frame->pc = catch_start_pc_it->value;
+                    frame.pc = catch_start_pc_it->value;
                 } else {
-                    frame->pc = table.mismatch_pc;
+                    frame.pc = table.mismatch_pc;
                 }
 
                 // 弹出多余的栈帧
                 for (size_t i = 0; i < frames_to_pop; ++i) {
+                    release_frame(call_stack.back());
                     call_stack.pop_back();
                 }
+                // 跳出的for循环不会执行POP_ITER, 在此释放它们的迭代器
+                unwind_iters(frame, frame.code_object->iter_depth_at(frame.pc));
                 err->make_ref();
-                frame->curr_error = err;
+                frame.curr_error = err;
                 return;
             }
         }
@@ -72,7 +95,7 @@ void Vm::handle_throw() {
     }
 
     // 没有找到任何能处理该异常的 try 块：打印错误信息并终止执行
-    if (const auto err_obj = dynamic_cast<model::Error*>(err)) {
+    if (const auto err_obj = err->as<model::Error>()) {
         std::cout << Color::BRIGHT_RED << "\nTrace Back: " << Color::RESET << std::endl;
         for (auto& [_path, _pos] : err_obj->positions) {
             err::context_printer(_path, _pos);
@@ -86,45 +109,33 @@ void Vm::handle_throw() {
     std::cout << std::endl;
 
     err->del_ref();
-    call_stack.back()->curr_error = nullptr;
+    call_stack.back().curr_error = nullptr;
     throw KizStopRunningSignal();
 }
 
 void Vm::handle_ensure() {
-    auto frame = call_stack.back();
-    if (frame->exec_ensure_stmt) return;
+    auto& frame = call_stack.back();
+    if (frame.exec_ensure_stmt) return;
 
-    auto ensures = frame->code_object->ensure_stmts;
-    if (ensures.empty()) {
+    auto code_obj = frame.code_object;
+    if (code_obj->ensure_stmts.empty()) {
         return;
     }
 
-    auto old_code = frame->code_object->code;
-    size_t old_pc = call_stack.back()->pc;
-    frame->code_object->code = ensures;
-    frame->pc = 0;
+    // 标记先于执行, 防止ensure块内的异常再次触发ensure
+    frame.exec_ensure_stmt = true;
 
-    while (!call_stack.empty() && running) {
-        auto curr_frame = call_stack.back();
-        // 检查当前帧是否执行完毕
-        if (curr_frame->pc >= curr_frame->code_object->code.size()) {
-            break;
-        }
+    // 临时将ensure块与其行号表换入, 执行完毕后换回
+    size_t old_pc = frame.pc;
+    std::swap(code_obj->code, code_obj->ensure_stmts);
+    std::swap(code_obj->line_table, code_obj->ensure_line_table);
+    frame.pc = 0;
 
-        // 执行当前指令
-        const Instruction& curr_inst = curr_frame->code_object->code[curr_frame->pc];
-        try {
-            execute_unit(curr_inst);
-        } catch (NativeFuncError& e) {
-            forward_to_handle_throw(e.name, e.msg);
-            continue;
-        }
+    execute_until(call_stack.size() - 1);
 
-        ADVANCE_PC
-    }
-    frame->code_object->code = old_code;
-    frame->pc = old_pc;
-    frame->exec_ensure_stmt = true;
+    std::swap(code_obj->code, code_obj->ensure_stmts);
+    std::swap(code_obj->line_table, code_obj->ensure_line_table);
+    frame.pc = old_pc;
 }
 
 }
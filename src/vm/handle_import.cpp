@@ -170,18 +170,14 @@ void Vm::handle_import(const std::string& module_path) {
         content = err::SrcManager::get_file_by_path(actually_found_path.string());
 #endif
     } else if (auto std_init_it = std_modules.find(module_path)) {
-        auto std_init_func = dynamic_cast<model::NativeFunction*>(std_init_it->value);
+        auto std_init_func = std_init_it->value->as<model::NativeFunction>();
         assert(std_init_func != nullptr);
 
-        model::List* args_list = new model::List({});
-        args_list->make_ref();
-        model::Object* return_val = std_init_func->func(std_init_func, args_list);
-        // 使用后释放临时参数列表
-        args_list->del_ref();
+        model::Object* return_val = std_init_func->call(std_init_func, {});
 
         assert(return_val != nullptr);
 
-        auto module_obj = dynamic_cast<model::Module*>(return_val);
+        auto module_obj = return_val->as<model::Module>();
         assert(module_obj != nullptr);
 
         push_to_stack(module_obj);
@@ -190,11 +186,12 @@ void Vm::handle_import(const std::string& module_path) {
         modules_cache.insert(module_path, module_obj);
         return;
     } else {
-        throw NativeFuncError("PathError", std::format(
+        raise("PathError", std::format(
             "Failed to find module in path '{}', tried '{}', '{}', '{}', '{}'", module_path,
             for_search_paths[0].string(), for_search_paths[1].string(),
             for_search_paths[2].string(), for_search_paths[3].string()
         ));
+        return;
     }
 
     Lexer lexer(module_path);
@@ -210,82 +207,32 @@ void Vm::handle_import(const std::string& module_path) {
 
     module_obj->make_ref();  // 先被handle_import这个函数持有
 
-    module_obj->make_ref();
-    module_obj->code->make_ref();
-    auto new_frame = new CallFrame{
-        .name = module_path,
-
-        .owner = module_obj,
-
-        .pc = 0,
-        .return_to_pc = module_obj->code->code.size() + 1,
-        .last_bp = call_stack.back()->bp,
-        .bp = op_stack.size(),
-        .code_object = module_obj->code,
-
-        .iters{},
-
-        .curr_error = nullptr,
-        .exec_ensure_stmt = false
-    };
-
     size_t old_call_stack_size = call_stack.size();
 
-    call_stack.emplace_back(new_frame);
-
+    push_frame(module_obj, module_obj->code, op_stack.size(), module_obj->code->code.size() + 1);
 
     /// 执行新代码
-    while (running and !call_stack.empty()) {
-        auto curr_frame = call_stack.back();
-        auto frame_code = curr_frame->code_object;
+    execute_until(old_call_stack_size);
 
-        // 检查是否执行到模块代码末尾：执行完毕则出栈
-        if (curr_frame->pc >= frame_code->code.size()) {
-            if (old_call_stack_size == call_stack.size() - 1) {
-                break;
-            }
-            call_stack.pop_back();
-            continue;
-        }
-
-        // 执行当前指令
-        const Instruction& curr_inst = frame_code->code[curr_frame->pc];
-        try {
-            execute_unit(curr_inst); // 调用VM的指令执行核心方法
-        } catch (const NativeFuncError& e) {
-            // 原生函数执行错误，抛出异常
-            forward_to_handle_throw(e.name, e.msg);
-            continue;
-        }
-
-        ADVANCE_PC
-
-    }
-
-    for (size_t i = call_stack.back()->bp; i < call_stack.back()->bp + call_stack.back()->code_object->locals_count; ++i) {
+    auto& frame = call_stack.back();
+    for (size_t i = frame.bp; i < frame.bp + frame.code_object->locals_count; ++i) {
         const auto local_object = op_stack[i];
-        const auto name = call_stack.back()->code_object->var_names[i - call_stack.back()->bp];
-        if (name.starts_with("__private__")) continue;
+        const auto name = frame.code_object->var_names[i - frame.bp];
+        if (!local_object or name.starts_with("__private__")) continue;
 
         module_obj->attrs_insert(name, local_object);
     }
 
 
     /// 处理delete frame
-    auto frame = call_stack.back();
     call_stack.pop_back();
-    call_stack.back()->bp = frame->last_bp;
+    call_stack.back().bp = frame.last_bp;
 
-    while (frame->bp < op_stack.size()) {
-        op_stack.back()->del_ref();
+    while (frame.bp < op_stack.size()) {
+        if (op_stack.back()) op_stack.back()->del_ref();
         op_stack.pop_back();
     }
-    frame->owner->del_ref();
-    frame->code_object->del_ref();
-    for (auto it: frame->iters) {
-        if (it) it->del_ref();
-    }
-    delete frame;
+    release_frame(frame);
 
     /// 储存module
     push_to_stack(module_obj);
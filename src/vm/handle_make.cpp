@@ -10,16 +10,13 @@ auto Vm::make_pos_info() -> std::vector<std::pair<std::string, err::PositionInfo
     std::vector<std::pair<std::string, err::PositionInfo>> positions;
     std::string path;
     for (const auto& frame: call_stack) {
-        if (const auto m = dynamic_cast<model::Module*>(frame->owner)) {
+        if (const auto m = frame.owner->as<model::Module>()) {
             path = m->path;
         }
-        err::PositionInfo pos{};
         bool is_last_frame = frame_index == call_stack.size() - 1;
-        if (is_last_frame) {
-            pos = frame->code_object->code.at(frame->pc).pos;
-        } else {
-            pos = frame->code_object->code.at(frame->pc - 1).pos;
-        }
+        size_t pc = is_last_frame ? frame.pc : frame.pc - 1;
+        assert(pc < frame.code_object->code.size());
+        err::PositionInfo pos = frame.code_object->line_table.lookup(pc);
         positions.emplace_back(path, pos);
         ++frame_index;
     }
@@ -33,6 +30,7 @@ void Vm::make_list(size_t len) {
     std::vector<model::Object*> elem_list;
     elem_list.reserve(elem_count);
 
+    // 弹出的元素持有栈上的引用，列表建成（内部 make_ref）后再释放
     for (size_t i = 0; i < elem_count; ++i) {
         auto elem = simple_get_and_pop_stack_top(); // 弹出
         elem_list.push_back(elem);
@@ -40,6 +38,7 @@ void Vm::make_list(size_t len) {
     std::ranges::reverse(elem_list); // 恢复原序
 
     auto list_obj = new model::List(elem_list);      // 内部为每个元素 make_ref
+    for (auto elem : elem_list) elem->del_ref();
     push_to_stack(list_obj);
 }
 
@@ -48,32 +47,40 @@ void Vm::make_dict(size_t len) {
     const size_t total_elems = elem_count * 2;
     assert(op_stack.size() >= total_elems);
 
-    std::vector<std::pair<dep::BigInt, std::pair<model::Object*, model::Object*>>> elem_list;
+    std::vector<std::pair<size_t, std::pair<model::Object*, model::Object*>>> elem_list;
     elem_list.reserve(elem_count);
+    // 弹出的 key/value 持有栈上的引用，字典建成（内部 make_ref）后再释放
+    std::vector<model::Object*> popped;
+    popped.reserve(total_elems);
+    auto release_popped = [&popped] {
+        for (auto obj : popped) obj->del_ref();
+    };
 
     for (size_t i = 0; i < elem_count; ++i) {
         auto value = simple_get_and_pop_stack_top(); // 弹出 value
         auto key = simple_get_and_pop_stack_top();   // 弹出 key
-        value = copy_if_mutable(value);
+        popped.push_back(value);
+        popped.push_back(key);
 
-        // 计算哈希
-        call_method(key, "__hash__", {});
-        auto hash_obj = simple_get_and_pop_stack_top();
-        auto hashed_int = dynamic_cast<model::Int*>(hash_obj);
-        if (!hashed_int) {
-            hash_obj->del_ref();
-            key->del_ref();
-            value->del_ref();
-            throw NativeFuncError("TypeError", "__hash__ must return an integer");
+        // 计算哈希: 失败时留下待处理错误, 由调度循环转发
+        const size_t hash = model::dict_key_hash(key);
+        if (error_pending) {
+            // 与调用出错时丢弃实参一样, 把尚未弹出的 key/value 一并弹出释放
+            StackArgs discarded(total_elems - popped.size());
+            release_popped();
+            return;
         }
-        elem_list.emplace_back(hashed_int->val, std::pair{key, value});
+        elem_list.emplace_back(hash, std::pair{key, value});
+    }
+    std::ranges::reverse(elem_list); // 恢复原序
 
-        hash_obj->del_ref();
-        key->del_ref();
-        value->del_ref();
+    // 所有键的哈希都算完后再复制可变的值, 出错返回时没有需要清理的副本
+    for (auto& [hash, kv] : elem_list) {
+        kv.second = copy_if_mutable(kv.second);
     }
 
-    auto dict_obj = new model::Dictionary(dep::Dict(elem_list)); // 内部为 key/value make_ref
+    auto dict_obj = new model::Dictionary(model::DictStore(elem_list)); // 内部为 key/value make_ref
+    release_popped();
     push_to_stack(dict_obj);
 }
 }
\ No newline at end of file
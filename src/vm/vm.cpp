@@ -27,15 +27,27 @@ std::vector<std::string> Vm::builtin_names {};
 dep::HashMap<model::Module*> Vm::modules_cache {};
 model::Module* Vm::main_module;
 std::vector<model::Object*> Vm::op_stack {};
-std::vector<CallFrame*> Vm::call_stack {};
+FrameStack Vm::call_stack {};
+std::vector<model::Object*> Vm::iter_slots {};
 model::Int* Vm::small_int_pool[201] {};
+size_t Vm::proto_epoch = 0;
+bool Vm::builtin_slots_valid = false;
 bool Vm::running = false;
 std::string Vm::main_file_path;
+bool Vm::error_pending = false;
+std::string Vm::pending_error_name;
+std::string Vm::pending_error_msg;
 std::vector<model::Object*> Vm::const_pool {};
 dep::HashMap<model::Object*> Vm::std_modules {};
 
 StackRef::~StackRef() { if (obj) obj->del_ref(); }
 
+StackArgs::~StackArgs() {
+    for (size_t i = 0; i < size_; ++i) {
+        if (data_[i]) data_[i]->del_ref();
+    }
+}
+
 Vm::Vm(const std::string& file_path_) {
     main_file_path = file_path_;
     DEBUG_OUTPUT("entry builtin functions...");
@@ -59,6 +71,7 @@ Vm::Vm(const std::string& file_path_) {
     model::based_file_handle->mark_as_important();
     model::based_code_object->mark_as_important();
     model::based_range->mark_as_important();
+    model::based_iterator->mark_as_important();
 
     for (dep::BigInt i = 0; i < 201; i+= 1) {
         auto int_obj = new model::Int{i};
@@ -79,28 +92,7 @@ void Vm::set_main_module(model::Module* src_module) {
     src_module->make_ref();
 
     // 创建模块级调用帧（CallFrame）：模块是顶层执行单元，对应一个顶层调用帧
-    op_stack.resize(src_module->code->locals_count);
-    src_module->make_ref(); // owner
-    src_module->code->make_ref();
-    auto module_call_frame = new CallFrame{
-        .name = src_module->path,
-
-        .owner = src_module,
-
-        .pc = 0,
-        .return_to_pc = src_module->code->code.size(),
-        .last_bp = 0,
-        .bp = 0,
-        .code_object = src_module->code,
-
-        .iters{},
-
-        .curr_error = nullptr,
-        .exec_ensure_stmt = false
-    };
-
-    // 将调用帧压入VM的调用栈
-    call_stack.emplace_back(module_call_frame);
+    push_frame(src_module, src_module->code, 0, src_module->code->code.size());
 
     // 初始化VM执行状态：标记为"就绪"
     running = true; // 标记VM为运行状态（等待exec触发执行）
@@ -110,61 +102,69 @@ void Vm::set_main_module(model::Module* src_module) {
 }
 
 void Vm::exec_curr_code() {
-    // 循环执行当前调用帧下的所有指令
-    while (!call_stack.empty() && running) {
-        auto curr_frame = call_stack.back();
-        // 检查当前帧是否执行完毕
-        if (curr_frame->pc >= curr_frame->code_object->code.size()) {
-            // 非模块帧则弹出，模块帧则退出循环
-            if (call_stack.size() == 1) {
-                break;
-            }
-            call_stack.pop_back();;
-            continue;
-        }
-
-        // 执行当前指令
-        const Instruction& curr_inst = curr_frame->code_object->code[curr_frame->pc];
-        try {
-            // std::cout << "current instr: " << opcode_to_string(curr_inst.opc) << std::endl;
-            // std::cout << "Stack:" << std::endl;
-            // size_t j = 0;
-            // for (auto st_mem: op_stack) {
-            //     if (st_mem)
-            //         std::cout << j << ": " << st_mem->debug_string() << std::endl;
-            //     else
-            //         std::cout << j << ": " << "<nullptr>" << std::endl;
-            //     ++j;
-            // }
-            // std::cout << "==End==" << std::endl;
-            execute_unit(curr_inst);
-            // std::cout << "finish handle instr: " << opcode_to_string(curr_inst.opc) << std::endl;
-            // std::cout << "Stack:" << std::endl;
-            // j = 0;
-            // for (auto st_mem: op_stack) {
-            //     if (st_mem)
-            //         std::cout << j << ": " << st_mem->debug_string() << std::endl;
-            //     else
-            //         std::cout << j << ": " << "<nullptr>" << std::endl;
-            //     ++j;
-            // }
-            // std::cout << "==End==" << std::endl;
-        } catch (NativeFuncError& e) {
-            forward_to_handle_throw(e.name, e.msg);
-            continue;
-        }
-        ADVANCE_PC
-    }
+    // 循环执行当前调用帧下的所有指令, 模块帧执行完毕后保留
+    execute_until(0);
 }
 
 CallFrame* Vm::get_frame() {
     if ( !call_stack.empty() ) {
-        return call_stack.back();
+        return &call_stack.back();
     }
     throw KizStopRunningSignal("Unable to fetch current frame");
 }
 
+std::string CallFrame::name() const {
+    if (const auto func = owner->as<model::Function>()) return func->name;
+    if (const auto mod = owner->as<model::Module>()) return mod->path;
+    return "<unknown>";
+}
+
+CallFrame& Vm::push_frame(model::Object* owner, model::CodeObject* code_object, const size_t bp, const size_t return_to_pc) {
+    // 函数调用已在 handle_call 中检查过深度, 这里只会由导入模块触发, 仍以异常报告
+    if (call_stack.full()) {
+        throw NativeFuncError("RecursionError", std::format(
+            "maximum recursion depth {} exceeded", FrameStack::MAX_DEPTH
+        ));
+    }
+    const size_t iter_base = call_stack.empty()
+        ? 0 : call_stack.back().iter_base + call_stack.back().code_object->max_iters;
+    if (iter_slots.size() < iter_base + code_object->max_iters) {
+        iter_slots.resize(iter_base + code_object->max_iters);
+    }
+    if (op_stack.size() < bp + code_object->locals_count) {
+        op_stack.resize(bp + code_object->locals_count);
+    }
+
+    owner->make_ref();
+    code_object->make_ref();
+    auto& frame = call_stack.push();
+    frame.owner = owner;
+    frame.code_object = code_object;
+    frame.bp = bp;
+    frame.last_bp = call_stack.size() > 1 ? call_stack[call_stack.size() - 2].bp : 0;
+    frame.return_to_pc = return_to_pc;
+    frame.iter_base = iter_base;
+    frame.iter_top = iter_base;
+    return frame;
+}
+
+void Vm::unwind_iters(CallFrame& frame, const size_t depth) {
+    while (frame.iter_top > frame.iter_base + depth) {
+        auto& slot = iter_slots[--frame.iter_top];
+        if (slot) slot->del_ref();
+        slot = nullptr;
+    }
+}
+
+void Vm::release_frame(CallFrame& frame) {
+    unwind_iters(frame, 0);
+    frame.owner->del_ref();
+    frame.code_object->del_ref();
+}
+
 StackRef Vm::get_and_pop_stack_top() {
+    // 调用以待处理错误结束时没有压入结果, 取结果的原生函数改为以异常方式传播该错误
+    if (error_pending) [[unlikely]] throw_pending_error();
     if(op_stack.empty()) throw KizStopRunningSignal("Unable to fetch top of stack");
     auto stack_top = op_stack.back();
     if (!stack_top) throw KizStopRunningSignal("Top of stack is free");
@@ -173,6 +173,7 @@ StackRef Vm::get_and_pop_stack_top() {
 }
 
 model::Object* Vm::simple_get_and_pop_stack_top() {
+    if (error_pending) [[unlikely]] throw_pending_error();
     if(op_stack.empty()) throw KizStopRunningSignal("Unable to fetch top of stack");
     auto stack_top = op_stack.back();
     if (!stack_top) throw KizStopRunningSignal("Top of stack is free");
@@ -187,44 +188,60 @@ void Vm::push_to_stack(model::Object* obj) {
     op_stack.push_back(obj);
 }
 
+// 永生对象的计数从哨兵值起步, 借用压栈后出栈时的 del_ref 只会让它略微下降, 不会归零
+void Vm::push_borrowed_to_stack(model::Object* obj) {
+    assert(obj != nullptr and obj->is_important());
+    op_stack.push_back(obj);
+}
+
+void Vm::push_owned_to_stack(model::Object* obj) {
+    assert(obj != nullptr);
+    op_stack.push_back(obj);
+}
+
 void Vm::reset_global_code(model::CodeObject* code_object) {
     assert(code_object != nullptr);
     assert(!call_stack.empty());
     assert(call_stack.size() == 1);
 
     // 获取全局模块级调用帧（REPL 共享同一个帧）
-    auto frame = call_stack.back();
+    auto& frame = call_stack.back();
     // 对原有CodeObject调用del_ref(), 释放CallFrame的持有权
-    if (frame->code_object) {
-        frame->code_object->del_ref();
+    if (frame.code_object) {
+        frame.code_object->del_ref();
     }
 
     code_object->make_ref();
-    frame->code_object = code_object;
-    frame->pc = 0;
+    frame.code_object = code_object;
+    frame.pc = 0;
+    // 模块帧是唯一的帧, 其迭代器槽位从0开始
+    if (iter_slots.size() < code_object->max_iters) {
+        iter_slots.resize(code_object->max_iters);
+    }
     exec_curr_code();
 }
 
-std::string Vm::get_attr_name_by_idx(const size_t idx) {
+dep::Symbol Vm::get_attr_name_by_idx(const size_t idx) {
     auto frame = get_frame();
     return frame->code_object->attr_names[idx];
 }
 
 
-void Vm::assert_argc(size_t argc, const model::List* args) {
-    if (argc == args->val.size()) {
-        return;
+bool Vm::assert_argc(size_t argc, model::Args args) {
+    if (argc == args.size()) {
+        return true;
     }
-    throw NativeFuncError("ArgCountError", std::format(
-        "expect {} arguments but got {} arguments", args->val.size(), argc
+    raise("ArgCountError", std::format(
+        "expect {} arguments but got {} arguments", args.size(), argc
     ));
+    return false;
 }
 
-void Vm::assert_argc(const std::vector<size_t>& argcs, const model::List* args) {
-    auto actually_count = args->val.size();
+bool Vm::assert_argc(const std::vector<size_t>& argcs, model::Args args) {
+    auto actually_count = args.size();
     for (size_t i : argcs) {
         if (i == actually_count) {
-            return;
+            return true;
         }
     }
 
@@ -238,17 +255,18 @@ void Vm::assert_argc(const std::vector<size_t>& argcs, const model::List* args)
         ++ i;
     }
 
-    throw NativeFuncError("ArgCountError", std::format(
+    raise("ArgCountError", std::format(
         "expect {} arguments but got {} arguments", argc_str, actually_count
     ));
+    return false;
 }
 
 std::filesystem::path Vm::get_current_file_path() {
     std::filesystem::path current_file_path = "";
     if (main_file_path == "<shell#>") return current_file_path;
     for (const auto& frame: std::ranges::reverse_view(call_stack)) {
-        if (frame->owner->get_type() == model::Object::ObjectType::Module) {
-            const auto m = dynamic_cast<model::Module*>(frame->owner);
+        if (frame.owner->get_type() == model::Object::ObjectType::Module) {
+            const auto m = frame.owner->as<model::Module>();
             current_file_path = m->path;
         }
     }
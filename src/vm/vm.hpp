@@ -7,10 +7,14 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <filesystem>
+#include <initializer_list>
 
 #include "../../depends/hashmap.hpp"
+#include "../../depends/symbol.hpp"
 
 #include <stack>
 #include <tuple>
@@ -18,53 +22,123 @@
 
 #include "../kiz.hpp"
 #include "../error/error_reporter.hpp"
-
-#define ADVANCE_PC \
-    if (curr_inst.opc != Opcode::JUMP \
-        && curr_inst.opc != Opcode::JUMP_IF_FALSE \
-        && curr_inst.opc != Opcode::RET \
-        && curr_inst.opc != Opcode::THROW \
-        && curr_inst.opc != Opcode::JUMP_IF_FINISH_ITER\
-    ) { \
-                curr_frame->pc++; \
-    }
-
+#include "../models/type_slots.hpp"
 
 namespace model {
 class Module;
 class CodeObject;
 class Object;
 class List;
+class Args;
 class Int;
 class Error;
+struct AttrCache;
 }
 
 namespace kiz {
 
 enum class Opcode : uint8_t;
 
+///| 定宽指令: 1字节操作码 + 两个内联32位操作数, 源码位置不内联而是存入CodeObject的LineTable
 struct Instruction {
     Opcode opc;
-    std::vector<size_t> opn_list;
-    err::PositionInfo pos{};
-    Instruction(Opcode o, std::vector<size_t> ol, err::PositionInfo& p) : opc(o), opn_list(std::move(ol)), pos(p) {}
+    uint32_t opn_list[2] = {0, 0};
+
+    Instruction(Opcode o, std::initializer_list<size_t> ol) : opc(o) {
+        assert(ol.size() <= 2);
+        size_t i = 0;
+        for (auto opn : ol) {
+            assert(opn <= UINT32_MAX);
+            opn_list[i++] = static_cast<uint32_t>(opn);
+        }
+    }
 };
+static_assert(sizeof(Instruction) == 12);
+
+///| pc -> 源码位置的行号表, 只记录位置发生变化的起始pc (游程编码)
+class LineTable {
+    struct Entry {
+        size_t start_pc;
+        err::PositionInfo pos;
+    };
+    std::vector<Entry> entries;
+public:
+    LineTable() = default;
+    explicit LineTable(const std::vector<err::PositionInfo>& positions) {
+        for (size_t pc = 0; pc < positions.size(); ++pc) {
+            const auto& p = positions[pc];
+            if (!entries.empty()) {
+                const auto& last = entries.back().pos;
+                if (last.lno_start == p.lno_start and last.lno_end == p.lno_end
+                    and last.col_start == p.col_start and last.col_end == p.col_end) {
+                    continue;
+                }
+            }
+            entries.push_back({pc, p});
+        }
+    }
 
-struct CallFrame {
-    std::string name;
+    [[nodiscard]] err::PositionInfo lookup(size_t pc) const {
+        // 找到最后一个 start_pc <= pc 的条目
+        auto it = std::upper_bound(entries.begin(), entries.end(), pc,
+            [](size_t target, const Entry& e) { return target < e.start_pc; });
+        if (it == entries.begin()) return err::PositionInfo{};
+        return std::prev(it)->pos;
+    }
+};
 
-    model::Object* owner;
+///| 调用帧只引用所属的函数/模块与CodeObject(各持有一个引用), 名字按需从 owner 取得
+struct CallFrame {
+    model::Object* owner = nullptr;
 
     size_t pc = 0;
-    size_t return_to_pc;
-    size_t last_bp;
-    size_t bp;
-    model::CodeObject* code_object;
-    
-    std::vector<model::Object*> iters;
-
-    model::Object* curr_error;
+    size_t return_to_pc = 0;
+    size_t last_bp = 0;
+    size_t bp = 0;
+    model::CodeObject* code_object = nullptr;
+
+    // 本帧的迭代器槽位为 Vm::iter_slots[iter_base, iter_base + code_object->max_iters), 已用到 iter_top
+    size_t iter_base = 0;
+    size_t iter_top = 0;
+
+    model::Object* curr_error = nullptr;
     bool exec_ensure_stmt = false;
+
+    [[nodiscard]] std::string name() const; // 在vm.cpp中实现
+};
+
+///| 预分配的连续调用栈: 压栈/出栈只移动下标, 帧在复用时被整体重置, 不会为调用分配内存
+class FrameStack {
+public:
+    static constexpr size_t MAX_DEPTH = 1024; // 超过时抛出 RecursionError
+
+    FrameStack() : frames_(new CallFrame[MAX_DEPTH]) {}
+    ~FrameStack() { delete[] frames_; }
+    FrameStack(const FrameStack&) = delete;
+    FrameStack& operator=(const FrameStack&) = delete;
+
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+    [[nodiscard]] bool full() const { return size_ == MAX_DEPTH; }
+
+    CallFrame& push() {
+        assert(!full());
+        auto& frame = frames_[size_++];
+        frame = CallFrame{};
+        return frame;
+    }
+    // 出栈后帧的内容保留到下一次压栈, 调用者仍可读取刚弹出的帧
+    void pop_back() { assert(size_ > 0); --size_; }
+    void clear() { size_ = 0; }
+
+    CallFrame& back() { assert(size_ > 0); return frames_[size_ - 1]; }
+    CallFrame& operator[](const size_t i) { assert(i < size_); return frames_[i]; }
+    CallFrame* begin() { return frames_; }
+    CallFrame* end() { return frames_ + size_; }
+
+private:
+    CallFrame* frames_;
+    size_t size_ = 0;
 };
 
 class StackRef {
@@ -78,13 +152,30 @@ public:
     model::Object* release() { auto p = obj; obj = nullptr; return p; }
 };
 
+///| 从操作数栈顶取走 argc 个实参并接管栈对它们的引用, 析构时释放; 实参不多时不分配堆内存
+class StackArgs {
+    static constexpr size_t INLINE_CAPACITY = 8;
+    model::Object* inline_buf_[INLINE_CAPACITY];
+    std::vector<model::Object*> heap_buf_;
+    model::Object** data_;
+    size_t size_;
+public:
+    explicit StackArgs(size_t argc); // 在Vm之后实现
+    ~StackArgs(); // 在vm.cpp中实现
+    StackArgs(const StackArgs&) = delete;
+    StackArgs& operator=(const StackArgs&) = delete;
+    [[nodiscard]] model::Object* const* data() const { return data_; }
+    [[nodiscard]] size_t size() const { return size_; }
+};
+
 class Vm {
 public:
     static dep::HashMap<model::Module*> modules_cache;
     static model::Module* main_module;
 
     static std::vector<model::Object*> op_stack;
-    static std::vector<CallFrame*> call_stack;
+    static FrameStack call_stack;
+    static std::vector<model::Object*> iter_slots; // 各栈帧的for循环迭代器槽位, 随调用栈连续分段使用
 
     static model::Int* small_int_pool[201];
     static std::vector<model::Object*> const_pool;
@@ -93,32 +184,66 @@ public:
     static std::vector<std::string> builtin_names;
     static dep::HashMap<model::Object*> std_modules;
 
+    static size_t proto_epoch; // 原型纪元: 原型的属性或原型链变化时递增, 用于使内联缓存失效
+    static bool builtin_slots_valid; // 内置原型未被改写时为true, 运算符可直接调用类型槽位表
+
     static bool running;
     static std::string main_file_path;
 
+    ///| 待处理错误: 原生函数以 raise 报告、尚未转发到handle_throw的错误
+    static bool error_pending;
+    static std::string pending_error_name;
+    static std::string pending_error_msg;
+
     explicit Vm(const std::string& file_path_);
 
     ///| 核心执行循环
     static void set_main_module(model::Module* src_module);
     static void exec_curr_code();
     static void reset_global_code(model::CodeObject* code_object);
-    static void execute_unit(const Instruction& instruction);
+
+    ///| 唯一的取指-执行核心, 所有执行入口共用
+    ///| 调用栈深度回落到stop_depth, 或第stop_depth+1层栈帧的代码执行完毕时返回(该栈帧不出栈)
+    static void execute_until(size_t stop_depth);
+    static void dispatch(size_t stop_depth); // 由execute_until调用, NativeFuncError在execute_until中转发
+
+    ///| 不抛出异常的错误协议: 原生函数 `return Vm::raise(name, msg);` 记录待处理错误并返回nullptr
+    ///| 调度循环在调用之后检查并直接转发; 原生函数从栈上取调用结果时, 待处理错误才转为NativeFuncError抛出
+    static model::Object* raise(std::string name, std::string msg);
+    static void forward_pending_error();
+    [[noreturn]] static void throw_pending_error();
 
     ///| 栈操作
     static CallFrame* get_frame();
+    ///| 压入新调用帧并持有 owner 与 code_object, 为其局部变量与迭代器槽位预留空间; 调用栈已满时抛出 RecursionError
+    static CallFrame& push_frame(model::Object* owner, model::CodeObject* code_object, size_t bp, size_t return_to_pc);
+    ///| 释放已出栈调用帧持有的 owner、code_object 与迭代器
+    static void release_frame(CallFrame& frame);
+    ///| 把当前帧的迭代器弹到只剩 depth 个 (异常跳转到外层循环的 catch 时使用)
+    static void unwind_iters(CallFrame& frame, size_t depth);
     static StackRef get_and_pop_stack_top(); // 返回StackRef对象，参与RAII
     static model::Object* simple_get_and_pop_stack_top(); // 直接返回栈顶值, 需手动del_refc
     static void push_to_stack(model::Object* obj);
-    static std::string get_attr_name_by_idx(size_t idx);
+    ///| 压入永生对象(常量、内置对象、True/False/Nil)的借用引用: 其生命周期不依赖操作数栈, 不必计数
+    static void push_borrowed_to_stack(model::Object* obj);
+    ///| 栈接管调用者已持有的一份引用(如刚从栈上弹出的值), 不再 make_ref
+    static void push_owned_to_stack(model::Object* obj);
+    static dep::Symbol get_attr_name_by_idx(size_t idx);
 
     ///| 如果新增了调用栈，执行循环仅处理新增的模块栈帧（call_stack.size() > old_stack_size），不影响原有调用栈
-    static void call_function(model::Object* func_obj, std::vector<model::Object*> args, model::Object* self);
+    static void call_function(model::Object* func_obj, model::Args args, model::Object* self);
 
     ///| 运算符与普通方法分规则查找
-    static void call_method(model::Object* obj, const std::string& attr_name, std::vector<model::Object*> args);
+    static void call_method(model::Object* obj, dep::Symbol attr_name, model::Args args);
+
+    ///| 内置类型直接调用槽位表中的函数并压上返回值, 其余对象退回 call_method 动态查找魔术方法
+    static void call_slot(model::Object* obj, model::UnarySlot slot, dep::Symbol name);
+    static void call_slot(model::Object* obj, model::BinarySlot slot, dep::Symbol name, model::Object* arg);
+    static void call_slot(model::Object* obj, model::TernarySlot slot, dep::Symbol name, model::Object* a, model::Object* b);
 
     ///| 如果用户函数则创建调用栈，如果内置函数则执行并压上返回值
-    static void handle_call(model::Object* func_obj, model::Object* args_obj, model::Object* self=nullptr);
+    ///| 实参为操作数栈顶的 argc 个元素(由栈持有引用), 调用后它们被消耗: 用户函数中原地成为新栈帧的局部变量, 内置函数返回后出栈
+    static void handle_call(model::Object* func_obj, size_t argc, model::Object* self=nullptr);
 
     ///| 处理import
     static void handle_import(const std::string& module_path);
@@ -133,24 +258,43 @@ public:
     static void entry_std_modules();
 
     ///| @utils
-    static model::Object* get_attr(model::Object* obj, const std::string& attr);
-    static model::Object* get_attr_current(model::Object* obj, const std::string& attr);
+    static model::Object* get_attr(model::Object* obj, dep::Symbol attr); // 未找到时以 raise 报告NameError并返回nullptr
+    static model::Object* try_get_attr(model::Object* obj, dep::Symbol attr); // 沿__parent__链查找, 未找到返回nullptr
+    static model::Object* get_attr_current(model::Object* obj, dep::Symbol attr); // 同 get_attr, 只查找对象自身
+    ///| 带内联缓存的属性读写, 供 GET_ATTR/SET_ATTR/CALL_METHOD 使用
+    static model::Object* get_attr_cached(model::Object* obj, uint32_t name_idx, model::AttrCache& cache);
+    static void set_attr_cached(model::Object* obj, uint32_t name_idx, model::Object* val, model::AttrCache& cache);
     static bool is_true(model::Object* obj);
     static std::string obj_to_str(model::Object* for_cast_obj);
     static std::string obj_to_debug_str(model::Object* for_cast_obj);
+    static std::string take_str_result();
     static void forward_to_handle_throw(const std::string& name, const std::string& content);  // 转发到handle_throw函数
 
     static auto make_pos_info() -> std::vector<std::pair<std::string, err::PositionInfo>>;
     static void make_list(size_t len);
     static void make_dict(size_t len);
 
-    ///| @utils: 供builtins检查参数
-    static void assert_argc(size_t argc, const model::List* args);
-    static void assert_argc(const std::vector<size_t>& argcs, const model::List* args);
+    ///| @utils: 供builtins检查参数, 不符时以 raise 报告错误并返回false
+    static bool assert_argc(size_t argc, model::Args args);
+    static bool assert_argc(const std::vector<size_t>& argcs, model::Args args);
 
     ///| @utils: 路径处理
     static std::filesystem::path get_exe_abs_dir();
     static std::filesystem::path get_current_file_path();
 };
 
+inline StackArgs::StackArgs(const size_t argc) : size_(argc) {
+    auto& stack = Vm::op_stack;
+    assert(stack.size() >= argc);
+    if (argc <= INLINE_CAPACITY) {
+        data_ = inline_buf_;
+    } else {
+        heap_buf_.resize(argc);
+        data_ = heap_buf_.data();
+    }
+    const auto first = stack.end() - static_cast<std::ptrdiff_t>(argc);
+    std::copy(first, stack.end(), data_);
+    stack.erase(first, stack.end());
+}
+
 } // namespace kiz
\ No newline at end of file
@@ -2,6 +2,22 @@ set_project("kiz")
 set_version("0.7.11")
 set_languages("c++20")
 
+-- 对象池退回全局 operator new/delete, 供 ASan/Valgrind 等工具检查对象的内存错误
+option("kiz_pool_use_malloc")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Allocate VM objects with malloc instead of the slab pool")
+    add_defines("KIZ_POOL_USE_MALLOC")
+option_end()
+
+-- 引用计数改用原子操作, 供多线程运行时使用; 默认的单线程解释器使用普通整数计数
+option("kiz_atomic_refcount")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Use atomic reference counting for multi-threaded runtimes")
+    add_defines("KIZ_ATOMIC_REFCOUNT")
+option_end()
+
 target("version")
     on_build(function(target)
         -- 读取文件内容
@@ -19,6 +35,7 @@ target("version")
 
 target("kiz")
     set_kind("binary")
+    add_options("kiz_pool_use_malloc", "kiz_atomic_refcount")
 
     -- 入口文件
     add_files("src/main.cpp")
@@ -47,6 +64,9 @@ target("kiz")
     add_files("src/vm/handle_call.cpp")
     add_files("src/vm/handle_make.cpp")
 
+    -- 循环垃圾回收
+    add_files("src/gc/gc.cpp")
+
     -- 工具模块
     add_files("src/error/error_reporter.cpp")
     add_files("src/util/src_manager.cpp")
@@ -63,6 +83,7 @@ target("kiz")
     add_files("libs/builtins/dict_methods.cpp")
     add_files("libs/builtins/builtin_functions.cpp")
     add_files("libs/os/os_lib.cpp")
+    add_files("libs/gc/gc_lib.cpp")
     add_files("libs/builtins/builtins_lib.cpp")
     add_files("libs/builtins/file_handle_methods.cpp")
     add_files("libs/builtins/object_methods.cpp")